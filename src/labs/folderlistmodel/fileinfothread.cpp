@@ -3,8 +3,15 @@
 
 #include "fileinfothread_p.h"
 #include <qdiriterator.h>
+#include <qhash.h>
 #include <qpointer.h>
 #include <qtimer.h>
+#if QT_CONFIG(thread)
+#include <qsemaphore.h>
+#include <qthreadpool.h>
+#endif
+
+#include <vector>
 
 #include <QDebug>
 #include <QtCore/qloggingcategory.h>
@@ -23,6 +30,7 @@ FileInfoThread::FileInfoThread(QObject *parent)
       sortFlags(QDir::Name),
       needUpdate(true),
       updateTypes(UpdateType::None),
+      generation(0),
       showFiles(true),
       showDirs(true),
       showDirsFirst(false),
@@ -68,9 +76,9 @@ void FileInfoThread::removePath(const QString &path)
     currentPath.clear();
 }
 
-void FileInfoThread::setPath(const QString &path)
+void FileInfoThread::setPath(const QString &path, int generation)
 {
-    qCDebug(lcFileInfoThread) << "setPath called with path" << path;
+    qCDebug(lcFileInfoThread) << "setPath called with path" << path << "- generation" << generation;
     Q_ASSERT(!path.isEmpty());
 
     QMutexLocker locker(&mutex);
@@ -79,6 +87,7 @@ void FileInfoThread::setPath(const QString &path)
         watcher->addPath(path);
 #endif
     currentPath = path;
+    this->generation = generation;
     needUpdate = true;
     initiateScan();
 }
@@ -201,28 +210,19 @@ void FileInfoThread::updateFile(const QString &path)
 
 void FileInfoThread::run()
 {
+    QMutexLocker locker(&mutex);
     forever {
-        bool updateFiles = false;
-        QMutexLocker locker(&mutex);
         if (abort) {
             return;
         }
-        if (currentPath.isEmpty() || !needUpdate) {
+        if (currentPath.isEmpty() || !scanRequested()) {
             emit statusChanged(currentPath.isEmpty() ? QQuickFolderListModel::Null : QQuickFolderListModel::Ready);
             condition.wait(&mutex);
+            continue;
         }
 
-        if (abort) {
-            return;
-        }
-
-        if (!currentPath.isEmpty()) {
-            updateFiles = true;
-            emit statusChanged(QQuickFolderListModel::Loading);
-        }
-        if (updateFiles)
-            getFileInfos(currentPath);
-        locker.unlock();
+        emit statusChanged(QQuickFolderListModel::Loading);
+        getFileInfos(currentPath, locker);
     }
 }
 
@@ -242,7 +242,8 @@ void FileInfoThread::runOnce()
             return;
         }
         emit guardedThis->statusChanged(QQuickFolderListModel::Loading);
-        guardedThis->getFileInfos(guardedThis->currentPath);
+        QMutexLocker locker(&guardedThis->mutex);
+        guardedThis->getFileInfos(guardedThis->currentPath, locker);
         emit guardedThis->statusChanged(QQuickFolderListModel::Ready);
     };
 
@@ -267,7 +268,83 @@ QString fileInfoListToString(const QFileInfoList &fileInfoList)
         : QString::fromLatin1("%1 files").arg(fileInfoList.size());
 }
 
-void FileInfoThread::getFileInfos(const QString &path)
+// Rows delivered before the rest of a freshly listed folder, so that the
+// first screenful shows up before every file has been stat'ed.
+static constexpr qsizetype InitialBatchSize = 256;
+// Below this many entries per thread, stat'ing in parallel does not pay off.
+static constexpr qsizetype MinimumParallelChunkSize = 2048;
+// Beyond this many ranges, a reset is cheaper than applying the diff.
+static constexpr qsizetype MaximumDiffRanges = 128;
+
+static QList<FileProperty> toFileProperties(QFileInfoList::const_iterator begin,
+                                            QFileInfoList::const_iterator end)
+{
+    QList<FileProperty> properties;
+    properties.reserve(end - begin);
+    for (auto it = begin; it != end; ++it)
+        properties << FileProperty(*it);
+    return properties;
+}
+
+// Creating a FileProperty stats the file, which dominates for big folders.
+// Split the work across the global thread pool when there is enough of it.
+static QList<FileProperty> toFileProperties(const QFileInfoList &infos, qsizetype from = 0,
+                                            qsizetype to = -1)
+{
+    if (to < 0)
+        to = infos.size();
+    const qsizetype count = to - from;
+#if QT_CONFIG(thread)
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const qsizetype chunkCount = qMin<qsizetype>(pool->maxThreadCount() + 1,
+                                                 count / MinimumParallelChunkSize);
+    if (chunkCount > 1) {
+        const qsizetype chunkSize = (count + chunkCount - 1) / chunkCount;
+        const auto chunkBegin = [&](qsizetype chunk) {
+            return infos.cbegin() + from + qMin(count, chunk * chunkSize);
+        };
+
+        std::vector<QList<FileProperty>> chunks(chunkCount);
+        QSemaphore done;
+        for (qsizetype chunk = 1; chunk < chunkCount; ++chunk) {
+            pool->start([&, chunk]() {
+                chunks[chunk] = toFileProperties(chunkBegin(chunk), chunkBegin(chunk + 1));
+                done.release();
+            });
+        }
+        chunks[0] = toFileProperties(chunkBegin(0), chunkBegin(1));
+        done.acquire(int(chunkCount - 1));
+
+        QList<FileProperty> properties;
+        properties.reserve(count);
+        for (const QList<FileProperty> &chunk : chunks)
+            properties.append(chunk);
+        return properties;
+    }
+#endif
+    return toFileProperties(infos.cbegin() + from, infos.cbegin() + to);
+}
+
+// Whether a setter asked for the current folder to be listed again. Setters
+// only wake the thread, so this has to be checked before going back to sleep.
+bool FileInfoThread::scanRequested() const
+{
+    return needUpdate || updateTypes.testFlag(UpdateType::Sort)
+            || updateTypes.testFlag(UpdateType::Contents);
+}
+
+// Whether the rest of a listing is no longer wanted, because the thread is
+// being destroyed, or the folder or the listing options changed meanwhile.
+bool FileInfoThread::scanSuperseded(int scannedGeneration)
+{
+    QMutexLocker locker(&mutex);
+    return abort || needUpdate || generation != scannedGeneration;
+}
+
+// Called with the mutex locked. The mutex is released while the folder is
+// listed and its files are stat'ed, so that the setters called from the GUI
+// thread do not block on a big folder.
+void FileInfoThread::getFileInfos(const QString &path, QMutexLocker<QMutex> &locker)
 {
     qCDebug(lcFileInfoThread) << "getFileInfos called with path" << path << "- updateType" << updateTypes;
 
@@ -289,81 +366,137 @@ void FileInfoThread::getFileInfos(const QString &path)
     if (showDirsFirst)
         sortFlags = sortFlags | QDir::DirsFirst;
 
-    QDir currentDir(path, QString(), sortFlags);
-    QList<FileProperty> filePropertyList;
-
-    const QFileInfoList fileInfoList = currentDir.entryInfoList(nameFilters, filter, sortFlags);
-
-    if (!fileInfoList.isEmpty()) {
-        filePropertyList.reserve(fileInfoList.size());
-        for (const QFileInfo &info : fileInfoList)
-            filePropertyList << FileProperty(info);
-
-        if (updateTypes & UpdateType::Contents) {
-            int fromIndex = 0;
-            int toIndex = currentFileList.size()-1;
-            findChangeRange(filePropertyList, fromIndex, toIndex);
-            currentFileList = filePropertyList;
-            qCDebug(lcFileInfoThread) << "- about to emit directoryUpdated with fromIndex" << fromIndex
-                << "toIndex" << toIndex << "fileInfoList" << fileInfoListToString(fileInfoList);
-            emit directoryUpdated(path, filePropertyList, fromIndex, toIndex);
-        } else {
-            currentFileList = filePropertyList;
-            if (updateTypes & UpdateType::Sort) {
-                qCDebug(lcFileInfoThread) << "- about to emit sortFinished - fileInfoList:"
-                    << fileInfoListToString(fileInfoList);
-                emit sortFinished(filePropertyList);
-            } else {
-                qCDebug(lcFileInfoThread) << "- about to emit directoryChanged - fileInfoList:"
-                    << fileInfoListToString(fileInfoList);
-                emit directoryChanged(path, filePropertyList);
-            }
-        }
+    const QDir::SortFlags sort = sortFlags;
+    const QStringList filters = nameFilters;
+    const UpdateTypes types = updateTypes;
+    const int scannedGeneration = generation;
+    updateTypes = UpdateType::None;
+    needUpdate = false;
+    locker.unlock();
+
+    QDir currentDir(path, QString(), sort);
+
+    const QFileInfoList fileInfoList = currentDir.entryInfoList(filters, filter, sort);
+
+    if (types & UpdateType::Contents) {
+        QList<FileProperty> filePropertyList = toFileProperties(fileInfoList);
+        const FileListDiff diff = diffFileList(filePropertyList);
+        currentFileList = filePropertyList;
+        qCDebug(lcFileInfoThread) << "- about to emit directoryUpdated with" << diff.removed.size()
+            << "removed," << diff.inserted.size() << "inserted and" << diff.changed.size()
+            << "changed ranges, reset" << diff.reset << "- fileInfoList" << fileInfoListToString(fileInfoList);
+        emit directoryUpdated(path, filePropertyList, diff, scannedGeneration);
+    } else if (types & UpdateType::Sort) {
+        QList<FileProperty> filePropertyList = toFileProperties(fileInfoList);
+        currentFileList = filePropertyList;
+        qCDebug(lcFileInfoThread) << "- about to emit sortFinished - fileInfoList:"
+            << fileInfoListToString(fileInfoList);
+        emit sortFinished(filePropertyList, scannedGeneration);
     } else {
-        // The directory is empty
-        if (updateTypes & UpdateType::Contents) {
-            int fromIndex = 0;
-            int toIndex = currentFileList.size()-1;
-            currentFileList.clear();
-            qCDebug(lcFileInfoThread) << "- directory is empty, about to emit directoryUpdated with fromIndex"
-                << fromIndex << "toIndex" << toIndex;
-            emit directoryUpdated(path, filePropertyList, fromIndex, toIndex);
-        } else {
-            currentFileList.clear();
-            qCDebug(lcFileInfoThread) << "- directory is empty, about to emit directoryChanged";
-            emit directoryChanged(path, filePropertyList);
+        // Deliver the first screenful right away, and the rest of the folder
+        // in batches of doubling size as they have been stat'ed.
+        qsizetype batchSize = qMin(fileInfoList.size(), InitialBatchSize);
+        QList<FileProperty> filePropertyList =
+                toFileProperties(fileInfoList.cbegin(), fileInfoList.cbegin() + batchSize);
+        qCDebug(lcFileInfoThread) << "- about to emit directoryChanged - fileInfoList:"
+            << fileInfoListToString(fileInfoList);
+        emit directoryChanged(path, filePropertyList, scannedGeneration);
+        for (qsizetype from = filePropertyList.size(); from < fileInfoList.size(); from += batchSize) {
+            // Stop early if a new listing has been asked for. If it is of the
+            // same folder, it is diffed against the rows delivered so far.
+            if (scanSuperseded(scannedGeneration))
+                break;
+            batchSize *= 2;
+            const qsizetype to = qMin(fileInfoList.size(), from + batchSize);
+            const QList<FileProperty> batch = toFileProperties(fileInfoList, from, to);
+            filePropertyList.append(batch);
+            qCDebug(lcFileInfoThread) << "- about to emit directoryAppended with" << batch.size() << "files";
+            emit directoryAppended(path, batch, scannedGeneration);
         }
+        currentFileList = filePropertyList;
     }
-    updateTypes = UpdateType::None;
-    needUpdate = false;
+    locker.relock();
 }
 
-void FileInfoThread::findChangeRange(const QList<FileProperty> &list, int &fromIndex, int &toIndex)
+static void appendToRanges(QList<std::pair<int, int>> *ranges, qsizetype index)
 {
-    if (currentFileList.size() == 0) {
-        fromIndex = 0;
-        toIndex = list.size();
-        return;
+    if (!ranges->isEmpty() && ranges->last().second == index - 1)
+        ranges->last().second = int(index);
+    else
+        ranges->append({ int(index), int(index) });
+}
+
+FileListDiff FileInfoThread::diffFileList(const QList<FileProperty> &list) const
+{
+    const QList<FileProperty> &old = currentFileList;
+    FileListDiff diff;
+
+    // Watcher notifications usually touch a handful of entries, so skip the
+    // common head and tail before matching up the rest.
+    const qsizetype common = qMin(old.size(), list.size());
+    qsizetype head = 0;
+    while (head < common && old.at(head) == list.at(head))
+        ++head;
+    qsizetype tail = 0;
+    while (tail < common - head
+           && old.at(old.size() - 1 - tail) == list.at(list.size() - 1 - tail)) {
+        ++tail;
     }
 
-    int i;
-    int listSize = list.size() < currentFileList.size() ? list.size() : currentFileList.size();
-    bool changeFound = false;
+    for (qsizetype i = 0; i < head; ++i) {
+        if (!old.at(i).hasSameDetails(list.at(i)))
+            appendToRanges(&diff.changed, i);
+    }
+
+    const qsizetype oldEnd = old.size() - tail;
+    const qsizetype newEnd = list.size() - tail;
+    const auto key = [](const FileProperty &property) {
+        // File names cannot contain a slash, so this tells files and folders apart
+        return property.isDir() ? property.fileName() + QLatin1Char('/') : property.fileName();
+    };
 
-    for (i=0; i < listSize; i++) {
-        if (list.at(i) != currentFileList.at(i)) {
-            changeFound = true;
-            break;
+    QHash<QString, qsizetype> newIndexes;
+    newIndexes.reserve(newEnd - head);
+    for (qsizetype j = head; j < newEnd; ++j)
+        newIndexes.insert(key(list.at(j)), j);
+
+    QList<bool> matched(newEnd - head, false);
+    qsizetype lastMatch = head - 1;
+    for (qsizetype i = head; i < oldEnd; ++i) {
+        const auto it = newIndexes.constFind(key(old.at(i)));
+        if (it == newIndexes.cend()) {
+            appendToRanges(&diff.removed, i);
+            continue;
         }
+        // Entries that changed their relative order, for example because
+        // their size changed while sorting by size, cannot be expressed by
+        // removals and insertions alone.
+        if (*it < lastMatch) {
+            diff = FileListDiff();
+            diff.reset = true;
+            return diff;
+        }
+        lastMatch = *it;
+        matched[*it - head] = true;
+        if (!old.at(i).hasSameDetails(list.at(*it)))
+            appendToRanges(&diff.changed, *it);
     }
 
-    if (changeFound)
-        fromIndex = i;
-    else
-        fromIndex = i-1;
+    for (qsizetype j = head; j < newEnd; ++j) {
+        if (!matched.at(j - head))
+            appendToRanges(&diff.inserted, j);
+    }
 
-    // For now I let the rest of the list be updated..
-    toIndex = list.size() > currentFileList.size() ? list.size() - 1 : currentFileList.size() - 1;
+    for (qsizetype k = 0; k < tail; ++k) {
+        if (!old.at(oldEnd + k).hasSameDetails(list.at(newEnd + k)))
+            appendToRanges(&diff.changed, newEnd + k);
+    }
+
+    if (diff.removed.size() + diff.inserted.size() > MaximumDiffRanges) {
+        diff = FileListDiff();
+        diff.reset = true;
+    }
+    return diff;
 }
 
 constexpr FileInfoThread::UpdateTypes operator|(FileInfoThread::UpdateType f1, FileInfoThread::UpdateTypes f2) noexcept
@@ -29,14 +29,27 @@
 
 QT_BEGIN_NAMESPACE
 
+// The minimal set of changes turning the previous file list into a new one.
+// Ranges are inclusive. Removed ranges refer to the old list, inserted and
+// changed ranges to the new one. If reset is set, the ranges are empty and the
+// whole list has to be replaced.
+struct FileListDiff
+{
+    QList<std::pair<int, int>> removed;
+    QList<std::pair<int, int>> inserted;
+    QList<std::pair<int, int>> changed;
+    bool reset = false;
+};
+
 class FileInfoThread : public QThread
 {
     Q_OBJECT
 
 Q_SIGNALS:
-    void directoryChanged(const QString &directory, const QList<FileProperty> &list) const;
-    void directoryUpdated(const QString &directory, const QList<FileProperty> &list, int fromIndex, int toIndex) const;
-    void sortFinished(const QList<FileProperty> &list) const;
+    void directoryChanged(const QString &directory, const QList<FileProperty> &list, int generation) const;
+    void directoryUpdated(const QString &directory, const QList<FileProperty> &list, const FileListDiff &diff, int generation) const;
+    void directoryAppended(const QString &directory, const QList<FileProperty> &list, int generation) const;
+    void sortFinished(const QList<FileProperty> &list, int generation) const;
     void statusChanged(QQuickFolderListModel::Status status) const;
 
 public:
@@ -45,7 +58,7 @@ public:
 
     void clear();
     void removePath(const QString &path);
-    void setPath(const QString &path);
+    void setPath(const QString &path, int generation);
     void setRootPath(const QString &path);
     void setSortFlags(QDir::SortFlags flags);
     void setNameFilters(const QStringList & nameFilters);
@@ -67,8 +80,10 @@ protected:
     void run() override;
     void runOnce();
     void initiateScan();
-    void getFileInfos(const QString &path);
-    void findChangeRange(const QList<FileProperty> &list, int &fromIndex, int &toIndex);
+    bool scanRequested() const;
+    bool scanSuperseded(int scannedGeneration);
+    void getFileInfos(const QString &path, QMutexLocker<QMutex> &locker);
+    FileListDiff diffFileList(const QList<FileProperty> &list) const;
 
 private:
     enum class UpdateType {
@@ -99,6 +114,9 @@ private:
     QStringList nameFilters;
     bool needUpdate;
     UpdateTypes updateTypes;
+    // Set by the model along with the path. It is passed on with every
+    // listing, so that the model can drop the ones of a previous folder.
+    int generation;
     bool showFiles;
     bool showDirs;
     bool showDirsFirst;
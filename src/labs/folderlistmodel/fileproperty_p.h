@@ -55,6 +55,11 @@ public:
     bool operator ==(const FileProperty &property) const {
         return ((mFileName == property.mFileName) && (isDir() == property.isDir()));
     }
+    // Whether the same entry needs its role data refreshed
+    bool hasSameDetails(const FileProperty &property) const {
+        return mSize == property.mSize && mIsFile == property.mIsFile
+                && mLastModified == property.mLastModified && mLastRead == property.mLastRead;
+    }
 
 private:
     QString mFileName;
@@ -9,6 +9,8 @@
 #include <qqmlcontext.h>
 #include <qqmlfile.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 Q_LOGGING_CATEGORY(lcFolderListModel, "qt.labs.folderlistmodel")
@@ -38,15 +40,20 @@ public:
     bool showHidden = false;
     bool caseSensitive = true;
     bool sortCaseSensitive = true;
+    // Listings of any other generation belong to a previous folder.
+    int folderGeneration = 0;
+    // Between setFolder() and the first listing of the new folder.
+    bool resetPending = false;
 
     ~QQuickFolderListModelPrivate() {}
     void init();
     void updateSorting();
 
     // private slots
-    void _q_directoryChanged(const QString &directory, const QList<FileProperty> &list);
-    void _q_directoryUpdated(const QString &directory, const QList<FileProperty> &list, int fromIndex, int toIndex);
-    void _q_sortFinished(const QList<FileProperty> &list);
+    void _q_directoryChanged(const QString &directory, const QList<FileProperty> &list, int generation);
+    void _q_directoryUpdated(const QString &directory, const QList<FileProperty> &list, const FileListDiff &diff, int generation);
+    void _q_directoryAppended(const QString &directory, const QList<FileProperty> &list, int generation);
+    void _q_sortFinished(const QList<FileProperty> &list, int generation);
     void _q_statusChanged(QQuickFolderListModel::Status s);
 
     static QString resolvePath(const QUrl &path);
@@ -57,13 +64,16 @@ void QQuickFolderListModelPrivate::init()
 {
     Q_Q(QQuickFolderListModel);
     qRegisterMetaType<QList<FileProperty> >("QList<FileProperty>");
+    qRegisterMetaType<FileListDiff>("FileListDiff");
     qRegisterMetaType<QQuickFolderListModel::Status>("QQuickFolderListModel::Status");
-    q->connect(&fileInfoThread, SIGNAL(directoryChanged(QString,QList<FileProperty>)),
-               q, SLOT(_q_directoryChanged(QString,QList<FileProperty>)));
-    q->connect(&fileInfoThread, SIGNAL(directoryUpdated(QString,QList<FileProperty>,int,int)),
-               q, SLOT(_q_directoryUpdated(QString,QList<FileProperty>,int,int)));
-    q->connect(&fileInfoThread, SIGNAL(sortFinished(QList<FileProperty>)),
-               q, SLOT(_q_sortFinished(QList<FileProperty>)));
+    q->connect(&fileInfoThread, SIGNAL(directoryChanged(QString,QList<FileProperty>,int)),
+               q, SLOT(_q_directoryChanged(QString,QList<FileProperty>,int)));
+    q->connect(&fileInfoThread, SIGNAL(directoryUpdated(QString,QList<FileProperty>,FileListDiff,int)),
+               q, SLOT(_q_directoryUpdated(QString,QList<FileProperty>,FileListDiff,int)));
+    q->connect(&fileInfoThread, SIGNAL(directoryAppended(QString,QList<FileProperty>,int)),
+               q, SLOT(_q_directoryAppended(QString,QList<FileProperty>,int)));
+    q->connect(&fileInfoThread, SIGNAL(sortFinished(QList<FileProperty>,int)),
+               q, SLOT(_q_sortFinished(QList<FileProperty>,int)));
     q->connect(&fileInfoThread, SIGNAL(statusChanged(QQuickFolderListModel::Status)),
                q, SLOT(_q_statusChanged(QQuickFolderListModel::Status)));
     q->connect(q, SIGNAL(rowCountChanged()), q, SIGNAL(countChanged()));
@@ -104,12 +114,19 @@ void QQuickFolderListModelPrivate::updateSorting()
     fileInfoThread.setSortFlags(flags);
 }
 
-void QQuickFolderListModelPrivate::_q_directoryChanged(const QString &directory, const QList<FileProperty> &list)
+void QQuickFolderListModelPrivate::_q_directoryChanged(const QString &directory, const QList<FileProperty> &list, int generation)
 {
     qCDebug(lcFolderListModel) << "_q_directoryChanged called with directory" << directory;
     Q_Q(QQuickFolderListModel);
-    Q_UNUSED(directory);
 
+    if (generation != folderGeneration) {
+        qCDebug(lcFolderListModel) << "- dropping the listing of a previous folder";
+        return;
+    }
+
+    if (!resetPending)
+        q->beginResetModel();
+    resetPending = false;
     data = list;
     q->endResetModel();
     qCDebug(lcFolderListModel) << "- endResetModel called";
@@ -118,42 +135,88 @@ void QQuickFolderListModelPrivate::_q_directoryChanged(const QString &directory,
 }
 
 
-void QQuickFolderListModelPrivate::_q_directoryUpdated(const QString &directory, const QList<FileProperty> &list, int fromIndex, int toIndex)
+void QQuickFolderListModelPrivate::_q_directoryUpdated(const QString &directory, const QList<FileProperty> &list, const FileListDiff &diff, int generation)
 {
     Q_Q(QQuickFolderListModel);
-    Q_UNUSED(directory);
+
+    if (generation != folderGeneration)
+        return;
+    // The options changed before the new folder was first listed, so
+    // the diff refers to the previous folder.
+    if (resetPending) {
+        _q_directoryChanged(directory, list, generation);
+        return;
+    }
 
     QModelIndex parent;
-    if (data.size() == list.size()) {
-        QModelIndex modelIndexFrom = q->createIndex(fromIndex, 0);
-        QModelIndex modelIndexTo = q->createIndex(toIndex, 0);
-        data = list;
-        emit q->dataChanged(modelIndexFrom, modelIndexTo);
-    } else {
-        // File(s) inserted or removed. Since I do not know how many
-        // or where, I need to update the whole list from the first item.
-        // This is a little pessimistic, but optimizing it would require
-        // more information in the signal from FileInfoThread.
+    const qsizetype oldSize = data.size();
+    if (diff.reset) {
+        // The order of the files changed, so the whole list has to be replaced.
         if (data.size() > 0) {
             q->beginRemoveRows(parent, 0, data.size() - 1);
+            data.clear();
             q->endRemoveRows();
         }
-        data = list;
         if (list.size() > 0) {
-            if (toIndex > list.size() - 1)
-                toIndex = list.size() - 1;
-            q->beginInsertRows(parent, 0, data.size() - 1);
+            q->beginInsertRows(parent, 0, list.size() - 1);
+            data = list;
             q->endInsertRows();
         }
-        emit q->rowCountChanged();
+    } else {
+        // Removed ranges refer to the old list, so apply them back to front.
+        for (auto it = diff.removed.crbegin(); it != diff.removed.crend(); ++it) {
+            q->beginRemoveRows(parent, it->first, it->second);
+            data.remove(it->first, it->second - it->first + 1);
+            q->endRemoveRows();
+        }
+        // Everything in front of an inserted range is up to date by now.
+        for (const auto &range : diff.inserted) {
+            q->beginInsertRows(parent, range.first, range.second);
+            // Make room in place, then fill in the new rows.
+            data.insert(range.first, range.second - range.first + 1, list.at(range.first));
+            std::copy(list.cbegin() + range.first + 1, list.cbegin() + range.second + 1,
+                      data.begin() + range.first + 1);
+            q->endInsertRows();
+        }
+        Q_ASSERT(data.size() == list.size());
+        data = list;
+        for (const auto &range : diff.changed)
+            emit q->dataChanged(q->createIndex(range.first, 0), q->createIndex(range.second, 0));
     }
+
+    if (data.size() != oldSize)
+        emit q->rowCountChanged();
+}
+
+void QQuickFolderListModelPrivate::_q_directoryAppended(const QString &directory, const QList<FileProperty> &list, int generation)
+{
+    Q_Q(QQuickFolderListModel);
+    Q_UNUSED(directory);
+    qCDebug(lcFolderListModel) << "_q_directoryAppended called with" << list.size() << "files";
+
+    // Batches only ever follow the first listing of their folder, so one
+    // arriving during a reset belongs to the folder that was left.
+    if (list.isEmpty() || generation != folderGeneration || resetPending)
+        return;
+
+    q->beginInsertRows(QModelIndex(), data.size(), data.size() + list.size() - 1);
+    data.append(list);
+    q->endInsertRows();
+    emit q->rowCountChanged();
 }
 
-void QQuickFolderListModelPrivate::_q_sortFinished(const QList<FileProperty> &list)
+void QQuickFolderListModelPrivate::_q_sortFinished(const QList<FileProperty> &list, int generation)
 {
     Q_Q(QQuickFolderListModel);
     qCDebug(lcFolderListModel) << "_q_sortFinished called with" << list.size() << "files";
 
+    if (generation != folderGeneration)
+        return;
+    if (resetPending) {
+        _q_directoryChanged(QString(), list, generation);
+        return;
+    }
+
     QModelIndex parent;
     if (data.size() > 0) {
         qCDebug(lcFolderListModel) << "- removing all existing rows...";
@@ -421,6 +484,8 @@ void QQuickFolderListModel::setFolder(const QUrl &folder)
 
     qCDebug(lcFolderListModel) << "about to emit beginResetModel since our folder was set to" << folder;
     beginResetModel();
+    d->resetPending = true;
+    ++d->folderGeneration;
 
     //Remove the old path for the file system watcher
     if (!d->currentDir.isEmpty())
@@ -431,6 +496,7 @@ void QQuickFolderListModel::setFolder(const QUrl &folder)
     QFileInfo info(resolvedPath);
     if (!info.exists() || !info.isDir()) {
         d->data.clear();
+        d->resetPending = false;
         endResetModel();
         emit rowCountChanged();
         if (d->status != QQuickFolderListModel::Null) {
@@ -440,7 +506,7 @@ void QQuickFolderListModel::setFolder(const QUrl &folder)
         return;
     }
 
-    d->fileInfoThread.setPath(resolvedPath);
+    d->fileInfoThread.setPath(resolvedPath, d->folderGeneration);
 }
 
 
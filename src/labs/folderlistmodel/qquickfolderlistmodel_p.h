@@ -154,9 +154,10 @@ private:
     Q_DECLARE_PRIVATE(QQuickFolderListModel)
     QScopedPointer<QQuickFolderListModelPrivate> d_ptr;
 
-    Q_PRIVATE_SLOT(d_func(), void _q_directoryChanged(const QString &directory, const QList<FileProperty> &list))
-    Q_PRIVATE_SLOT(d_func(), void _q_directoryUpdated(const QString &directory, const QList<FileProperty> &list, int fromIndex, int toIndex))
-    Q_PRIVATE_SLOT(d_func(), void _q_sortFinished(const QList<FileProperty> &list))
+    Q_PRIVATE_SLOT(d_func(), void _q_directoryChanged(const QString &directory, const QList<FileProperty> &list, int generation))
+    Q_PRIVATE_SLOT(d_func(), void _q_directoryUpdated(const QString &directory, const QList<FileProperty> &list, const FileListDiff &diff, int generation))
+    Q_PRIVATE_SLOT(d_func(), void _q_directoryAppended(const QString &directory, const QList<FileProperty> &list, int generation))
+    Q_PRIVATE_SLOT(d_func(), void _q_sortFinished(const QList<FileProperty> &list, int generation))
     Q_PRIVATE_SLOT(d_func(), void _q_statusChanged(QQuickFolderListModel::Status s))
 };
 //![class end]
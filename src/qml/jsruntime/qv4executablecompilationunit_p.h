@@ -57,6 +57,23 @@ namespace QV4 {
 // index is per-object binding index
 typedef QVector<const QQmlPropertyData *> BindingPropertyData;
 
+// Per-object cache of the function property lookups and the value type
+// binding skip list that QQmlObjectCreator resolves when it first instantiates
+// an object, reused for all further instances of the same object.
+struct ObjectLookupCache
+{
+    enum Resolved : quint8 {
+        Functions = 0x1,
+        ValueTypeBindingSkipList = 0x2
+    };
+
+    // index is per-object function index, nullptr for non-VME functions
+    QVector<const QQmlPropertyData *> functionProperties;
+    // properties assigned in a value type group object, see setupBindings()
+    quint32 valueTypeBindingSkipList = 0;
+    quint8 resolved = 0;
+};
+
 class CompilationUnitMapper;
 class ResolvedTypeReference;
 // map from name index
@@ -125,6 +142,9 @@ public:
     // lookups by string (property name).
     QVector<BindingPropertyData> bindingPropertyDataPerObject;
 
+    // index is object index. Filled in lazily, see ObjectLookupCache.
+    QVector<ObjectLookupCache> objectLookupCaches;
+
     // mapping from component object index (CompiledData::Unit object index that points to component) to identifier hash of named objects
     // this is initialized on-demand by QQmlContextData
     QHash<int, IdentifierHash> namedObjectsPerComponentCache;
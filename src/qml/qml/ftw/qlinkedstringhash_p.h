@@ -31,15 +31,30 @@ public:
     using ConstIteratorData = QStringHashData::IteratorData<const QLinkedStringHash>;
     using ConstIterator = typename QStringHash<T>::template Iterator<ConstIteratorData, const T>;
 
+    /*
+        Links this hash to \a other, so that lookups which are not satisfied
+        by the nodes inserted here are answered from \a other.
+
+        If the bucket table of \a other is large enough to also take the
+        additional nodes, the buckets are shared and the new nodes are simply
+        chained in front of the existing ones. Otherwise this hash gets its
+        own, small bucket table that only holds the nodes inserted here and
+        falls back to \a other on a miss. That way a long chain of derived
+        hashes does not duplicate the nodes of all its ancestors. To keep
+        lookups cheap, the number of such fallback layers is limited. Once
+        the limit is reached, the contents of \a other are flattened into
+        this hash instead.
+    */
     void linkAndReserve(const QLinkedStringHash<T> &other, int additionalReserve)
     {
         clear();
 
         if (other.count()) {
-            data.size = other.data.size;
-            data.rehashToSize(other.count() + additionalReserve);
+            const short sharedBits = data.numBitsForSize(other.data.size + additionalReserve);
+            if (qPrimeForNumBits(sharedBits) == other.data.numBuckets) {
+                data.size = other.data.size;
+                data.rehashToBits(sharedBits);
 
-            if (data.numBuckets == other.data.numBuckets) {
                 nodePool = new ReservedNodePool;
                 nodePool->count = additionalReserve;
                 nodePool->used = 0;
@@ -49,15 +64,29 @@ public:
                     data.buckets[ii] = (Node *)other.data.buckets[ii];
 
                 link = &other;
+                fallback = other.fallback;
+                fallbackDepth = other.fallbackDepth;
                 return;
             }
 
-            data.size = 0;
+            if (other.fallbackDepth < MaxFallbackDepth) {
+                nodePool = new ReservedNodePool;
+                nodePool->count = additionalReserve;
+                nodePool->used = 0;
+                nodePool->nodes = new Node[additionalReserve];
+                data.rehashToSize(additionalReserve);
+
+                link = &other;
+                fallback = &other;
+                fallbackDepth = other.fallbackDepth + 1;
+                return;
+            }
         }
 
         data.numBits = other.data.numBits;
         reserve(other.count() + additionalReserve);
-        copy(other);
+        data.rehashToBits(data.numBits);
+        copyLayers(other);
     }
 
     inline bool isLinked() const
@@ -69,6 +98,13 @@ public:
     {
         QStringHash<T>::clear();
         link = nullptr;
+        fallback = nullptr;
+        fallbackDepth = 0;
+    }
+
+    int count() const
+    {
+        return fallback ? data.size + fallback->count() : data.size;
     }
 
     template<typename K>
@@ -86,7 +122,21 @@ public:
     template<typename K>
     inline ConstIterator find(const K &key) const
     {
-        return iterator(QStringHash<T>::findNode(key));
+        for (const QLinkedStringHash<T> *layer = this; layer; layer = layer->fallback) {
+            if (Node *n = layer->QStringHash<T>::findNode(key))
+                return layer->iterator(n);
+        }
+        return ConstIterator();
+    }
+
+    template<typename K>
+    inline T *value(const K &key) const
+    {
+        for (const QLinkedStringHash<T> *layer = this; layer; layer = layer->fallback) {
+            if (Node *n = layer->QStringHash<T>::findNode(key))
+                return &n->value;
+        }
+        return nullptr;
     }
 
     ConstIterator begin() const
@@ -100,7 +150,6 @@ public:
 
     inline T *value(const ConstIterator &iter) { return value(iter.node()->key()); }
 
-    using QStringHash<T>::value;
     using QStringHash<T>::reserve;
     using QStringHash<T>::copy;
 
@@ -111,6 +160,52 @@ protected:
 
     using QStringHash<T>::createNode;
 
+    enum { MaxFallbackDepth = 4 };
+
+    void copyLayers(const QLinkedStringHash<T> &other)
+    {
+        // Copy the outermost layer first so that the nodes of inner layers
+        // keep shadowing the ones they override.
+        if (other.fallback)
+            copyLayers(*other.fallback);
+
+        for (int i = 0; i < other.data.numBuckets; ++i) {
+            QStringHashNode *bucket = other.data.buckets[i];
+            if (bucket)
+                QStringHash<T>::copyNode(bucket);
+        }
+
+        data.size += other.data.size;
+    }
+
+    inline ConstIterator findNextNode(const ConstIterator &iter) const
+    {
+        auto *node = iter.node();
+        if (!node)
+            return ConstIterator();
+
+        // A node never shows up in more than one layer. Search for it first,
+        // and then return the next node with the same key.
+        const QHashedString key(node->key());
+        bool found = false;
+        for (const QLinkedStringHash<T> *layer = this; layer; layer = layer->fallback) {
+            if (!layer->data.numBuckets)
+                continue;
+
+            QStringHashNode *n = layer->data.buckets[key.hash() % layer->data.numBuckets];
+            for (; n; n = n->next.data()) {
+                if (found) {
+                    if (n->equals(key))
+                        return layer->iterator(static_cast<Node *>(n));
+                } else if (n == node) {
+                    found = true;
+                }
+            }
+        }
+
+        return ConstIterator();
+    }
+
     inline ConstIteratorData iterateFirst() const
     {
         const ConstIteratorData rv
@@ -135,9 +230,9 @@ protected:
 
         if (link) {
             // This node could be in the linked hash
-            if ((n >= nodePool->nodes) && (n < (nodePool->nodes + nodePool->used))) {
+            if (nodePool && (n >= nodePool->nodes) && (n < (nodePool->nodes + nodePool->used))) {
                 // The node is in this hash
-            } else if ((n >= link->nodePool->nodes)
+            } else if (link->nodePool && (n >= link->nodePool->nodes)
                        && (n < (link->nodePool->nodes + link->nodePool->used))) {
                 // The node is in the linked hash
                 container = link;
@@ -162,6 +257,11 @@ protected:
     }
 
     const QLinkedStringHash<T> *link = nullptr;
+
+    // The hash to consult if a key is not found in our own buckets. This is
+    // either link itself or, if we share the buckets of link, link's fallback.
+    const QLinkedStringHash<T> *fallback = nullptr;
+    int fallbackDepth = 0;
 };
 
 template<class T>
@@ -185,15 +285,7 @@ public:
 
     inline ConstIterator findNext(const ConstIterator &iter) const
     {
-        if (auto *node = iter.node()) {
-            QHashedString key(node->key());
-            while ((node = static_cast<typename QLinkedStringHash<T>::Node *>(node->next.data()))) {
-                if (node->equals(key))
-                    return QLinkedStringHash<T>::iterator(node);
-            }
-        }
-
-        return ConstIterator();
+        return QLinkedStringHash<T>::findNextNode(iter);
     }
 };
 
@@ -194,12 +194,17 @@ public:
         numBuckets = nb;
     }
 
-    void rehashToSize(int size)
+    short numBitsForSize(int size) const
     {
         short bits = qMax(short(MinNumBits), numBits);
         while (qPrimeForNumBits(bits) < size)
             bits++;
+        return bits;
+    }
 
+    void rehashToSize(int size)
+    {
+        const short bits = numBitsForSize(size);
         if (bits > numBits)
             rehashToBits(bits);
     }
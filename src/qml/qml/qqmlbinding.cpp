@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qqmlbinding_p.h"
+#include "qqmlbindingbatch_p.h"
+#include "qqmlbindingstatistics_p.h"
 
 #include "qqmlcontext.h"
 #include "qqmldata_p.h"
@@ -23,6 +25,7 @@
 
 #include <qtqml_tracepoints_p.h>
 
+#include <QElapsedTimer>
 #include <QVariant>
 #include <QtCore/qdebug.h>
 #include <QVector>
@@ -140,12 +143,7 @@ void QQmlBinding::update(QQmlPropertyData::WriteFlags flags)
 
     // Check for a binding update loop
     if (Q_UNLIKELY(updatingFlag())) {
-        const QQmlPropertyData *d = nullptr;
-        QQmlPropertyData vtd;
-        getPropertyData(&d, &vtd);
-        Q_ASSERT(d);
-        QQmlProperty p = QQmlPropertyPrivate::restore(targetObject(), *d, &vtd, nullptr);
-        QQmlAbstractBinding::printBindingLoopError(p);
+        reportBindingLoop();
         return;
     }
     setUpdatingFlag(true);
@@ -161,7 +159,15 @@ void QQmlBinding::update(QQmlPropertyData::WriteFlags flags)
     Q_TRACE_SCOPE(QQmlBinding, qmlEngine, function() ? function()->name()->toQString() : QString(),
                   sourceLocation().sourceFile, sourceLocation().line, sourceLocation().column);
     QQmlBindingProfiler prof(QQmlEnginePrivate::get(qmlEngine)->profiler, function());
-    doUpdate(watcher, flags, scope);
+    if (Q_UNLIKELY(QQmlBindingStatistics::isEnabled())) {
+        QElapsedTimer timer;
+        timer.start();
+        doUpdate(watcher, flags, scope);
+        if (!watcher.wasDeleted())
+            QQmlBindingStatistics::record(this, timer.nsecsElapsed());
+    } else {
+        doUpdate(watcher, flags, scope);
+    }
 
     if (!watcher.wasDeleted())
         setUpdatingFlag(false);
@@ -598,8 +604,21 @@ QVariant QQmlBinding::evaluate()
     return QV4::ExecutionEngine::toVariant(result, QMetaType::fromType<QList<QObject*> >());
 }
 
+void QQmlBinding::reportBindingLoop()
+{
+    const QQmlPropertyData *d = nullptr;
+    QQmlPropertyData vtd;
+    getPropertyData(&d, &vtd);
+    Q_ASSERT(d);
+    QQmlProperty p = QQmlPropertyPrivate::restore(targetObject(), *d, &vtd, nullptr);
+    QQmlAbstractBinding::printBindingLoopError(p);
+}
+
 void QQmlBinding::expressionChanged()
 {
+    if (QQmlBindingBatch::enqueue(this))
+        return;
+
     update();
 }
 
@@ -33,6 +33,8 @@ class Q_QML_PRIVATE_EXPORT QQmlBinding : public QQmlJavaScriptExpression,
                                          public QQmlAbstractBinding
 {
     friend class QQmlAbstractBinding;
+    friend class QQmlBindingBatch;
+    friend class QQmlBindingStatistics;
 public:
     typedef QExplicitlySharedDataPointer<QQmlBinding> Ptr;
 
@@ -121,6 +123,8 @@ protected:
 
     QV4::ReturnedValue evaluate(bool *isUndefined);
 
+    void reportBindingLoop();
+
 private:
     static QQmlBinding *newBinding(const QQmlPropertyData *property);
     static QQmlBinding *newBinding(QMetaType propertyType);
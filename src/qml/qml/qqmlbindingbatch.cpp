@@ -0,0 +1,212 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qqmlbindingbatch_p.h"
+
+#include <private/qqmlengine_p.h>
+#include <private/qqmldata_p.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qscopeguard.h>
+#include <QtCore/qvarlengtharray.h>
+
+QT_BEGIN_NAMESPACE
+
+QQmlBindingBatch::QQmlBindingBatch(QQmlEngine *engine)
+{
+    QQmlEnginePrivate *ep = QQmlEnginePrivate::get(engine);
+    if (ep && !ep->bindingBatch) {
+        m_engine = ep;
+        ep->bindingBatch = this;
+    }
+}
+
+QQmlBindingBatch::~QQmlBindingBatch()
+{
+    if (!m_engine)
+        return;
+
+    flush();
+    m_engine->bindingBatch = nullptr;
+}
+
+/*!
+    \internal
+
+    Queues \a binding for evaluation by the active batch of its engine.
+    Returns \c false if there is no active batch, in which case the caller
+    has to evaluate the binding right away.
+*/
+bool QQmlBindingBatch::enqueue(QQmlBinding *binding)
+{
+    QQmlEngine *engine = binding->engine();
+    if (!engine)
+        return false;
+
+    QQmlBindingBatch *batch = QQmlEnginePrivate::get(engine)->bindingBatch;
+    if (!batch)
+        return false;
+
+    if (batch->m_queued.contains(binding))
+        return true;
+
+    // A binding queued again by its own evaluation, directly or through the
+    // bindings that evaluation queued, is part of a dependency cycle. This
+    // is where immediate evaluation finds the binding still updating.
+    if (batch->m_evaluating && batch->m_evaluated.contains(binding)) {
+        for (QQmlBinding *cause = batch->m_evaluating; cause; cause = batch->m_causes.value(cause)) {
+            if (cause == binding) {
+                if (!QQmlData::wasDeleted(binding->targetObject()))
+                    binding->reportBindingLoop();
+                return true;
+            }
+        }
+    }
+
+    batch->m_queued.insert(binding);
+    batch->m_pending.append(QQmlBinding::Ptr(binding));
+    batch->m_causes.insert(binding, batch->m_evaluating);
+    return true;
+}
+
+/*!
+    \internal
+
+    Evaluates all pending bindings. Bindings notified while flushing are
+    collected again, and evaluated in a further round. A signal handler
+    changing a property can legitimately trigger a binding that was already
+    evaluated, as often as needed. Only a binding queued again as a result
+    of its own evaluation is part of a dependency cycle. It is reported as
+    a binding loop and not evaluated again, like immediate evaluation does.
+*/
+void QQmlBindingBatch::flush()
+{
+    if (!m_engine)
+        return;
+
+    const auto reset = qScopeGuard([this] {
+        m_evaluating = nullptr;
+        m_evaluated.clear();
+        m_causes.clear();
+    });
+
+    while (!m_pending.isEmpty()) {
+        const QVector<QQmlBinding *> order = dependencyOrder();
+
+        // Keep the bindings alive while evaluating, as evaluating one binding may
+        // remove another one from its object.
+        const QVector<QQmlBinding::Ptr> round = std::exchange(m_pending, {});
+
+        for (QQmlBinding *binding : order) {
+            // Notifications received before this point are covered by the
+            // evaluation below. Later ones queue the binding for the next round.
+            m_queued.remove(binding);
+            m_evaluated.insert(binding);
+            m_evaluating = binding;
+            binding->update();
+            m_evaluating = nullptr;
+        }
+    }
+}
+
+QVector<QQmlBinding *> QQmlBindingBatch::dependencyOrder() const
+{
+    // Map the notify signals of the pending bindings' target properties back
+    // to the bindings, so that we can find the pending bindings another
+    // pending binding depends on by looking at its guards.
+    // Properties read through their bindable are tracked by change triggers
+    // on the property index instead, so map those as well.
+    QMultiHash<QPair<QObject *, int>, QQmlBinding *> producers;
+    QMultiHash<QPair<QObject *, int>, QQmlBinding *> bindableProducers;
+    producers.reserve(m_pending.size());
+    for (const QQmlBinding::Ptr &binding : m_pending) {
+        QObject *target = binding->targetObject();
+        if (!target || QQmlData::wasDeleted(target))
+            continue;
+
+        const QQmlPropertyData *core = nullptr;
+        binding->getPropertyData(&core, nullptr);
+        if (!core)
+            continue;
+        if (core->notifyIndex() != -1)
+            producers.insert(qMakePair(target, core->notifyIndex()), binding.data());
+        if (core->isBindable())
+            bindableProducers.insert(qMakePair(target, core->coreIndex()), binding.data());
+    }
+
+    enum State { Unvisited, Visiting, Done };
+    QHash<QQmlBinding *, State> states;
+    states.reserve(m_pending.size());
+
+    QVector<QQmlBinding *> order;
+    order.reserve(m_pending.size());
+
+    using Dependencies = QVarLengthArray<QQmlBinding *, 8>;
+    const auto dependencies = [&](QQmlBinding *binding) {
+        Dependencies result;
+        for (QQmlJavaScriptExpressionGuard *guard = binding->activeGuards.first(); guard;
+             guard = binding->activeGuards.next(guard)) {
+            if (guard->signalIndex() == -1) // guard's sender is a QQmlNotifier, not a QObject*.
+                continue;
+
+            const auto range = producers.equal_range(
+                        qMakePair(guard->senderAsObject(), guard->signalIndex()));
+            for (auto it = range.first; it != range.second; ++it) {
+                if (*it != binding)
+                    result.append(*it);
+            }
+        }
+
+        if (!bindableProducers.isEmpty()) {
+            for (TriggerList *trigger = binding->qpropertyChangeTriggers; trigger;
+                 trigger = trigger->next) {
+                const auto range = bindableProducers.equal_range(
+                            qMakePair(trigger->target.data(), trigger->propertyIndex));
+                for (auto it = range.first; it != range.second; ++it) {
+                    if (*it != binding)
+                        result.append(*it);
+                }
+            }
+        }
+        return result;
+    };
+
+    // Depth-first post-order traversal, with an explicit stack as binding
+    // chains can be long. Dependency cycles are broken at the first binding
+    // found to be in progress; the cycle detection in enqueue() reports them.
+    struct Frame
+    {
+        QQmlBinding *binding;
+        Dependencies dependencies;
+        qsizetype next = 0;
+    };
+    QVector<Frame> stack;
+
+    for (const QQmlBinding::Ptr &root : m_pending) {
+        State &rootState = states[root.data()];
+        if (rootState != Unvisited)
+            continue;
+        rootState = Visiting;
+        stack.append({ root.data(), dependencies(root.data()) });
+
+        while (!stack.isEmpty()) {
+            Frame &top = stack.last();
+            if (top.next < top.dependencies.size()) {
+                QQmlBinding *dependency = top.dependencies.at(top.next++);
+                State &state = states[dependency];
+                if (state == Unvisited) {
+                    state = Visiting;
+                    stack.append({ dependency, dependencies(dependency) });
+                }
+            } else {
+                states[top.binding] = Done;
+                order.append(top.binding);
+                stack.removeLast();
+            }
+        }
+    }
+
+    return order;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,70 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQMLBINDINGBATCH_P_H
+#define QQMLBINDINGBATCH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qqmlbinding_p.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
+#include <QtCore/qvector.h>
+
+QT_BEGIN_NAMESPACE
+
+class QQmlEngine;
+class QQmlEnginePrivate;
+
+/*!
+    \internal
+
+    While a QQmlBindingBatch is alive, QML bindings of its engine are not
+    re-evaluated as soon as one of their dependencies changes. Instead, they
+    are collected and evaluated once each when the outermost batch goes out
+    of scope, or when flush() is called. The collected bindings are evaluated
+    in dependency order, so that a binding depending on other pending bindings
+    only sees their final values and, in diamond-shaped dependency graphs,
+    does not get evaluated once per path.
+
+    Batches nest. Only the outermost batch collects and flushes bindings.
+*/
+class Q_QML_PRIVATE_EXPORT QQmlBindingBatch
+{
+    Q_DISABLE_COPY_MOVE(QQmlBindingBatch)
+public:
+    explicit QQmlBindingBatch(QQmlEngine *engine);
+    ~QQmlBindingBatch();
+
+    void flush();
+
+    static bool enqueue(QQmlBinding *binding);
+
+private:
+    QVector<QQmlBinding *> dependencyOrder() const;
+
+    QQmlEnginePrivate *m_engine = nullptr;
+    QVector<QQmlBinding::Ptr> m_pending;
+    QSet<QQmlBinding *> m_queued;
+
+    // State of the running flush, for detecting dependency cycles: the
+    // binding being evaluated, the ones evaluated so far, and for each
+    // queued binding the binding whose evaluation queued it.
+    QQmlBinding *m_evaluating = nullptr;
+    QSet<QQmlBinding *> m_evaluated;
+    QHash<QQmlBinding *, QQmlBinding *> m_causes;
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLBINDINGBATCH_P_H
@@ -0,0 +1,187 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qqmlbindingstatistics_p.h"
+
+#include <private/qqmlbinding_p.h>
+#include <private/qqmldata_p.h>
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qmutex.h>
+
+#include <algorithm>
+#include <cstdio>
+
+QT_BEGIN_NAMESPACE
+
+Q_LOGGING_CATEGORY(lcBindingStatistics, "qt.qml.binding.statistics")
+
+namespace {
+
+struct LocationKey
+{
+    QString sourceFile;
+    quint16 line;
+    quint16 column;
+
+    friend bool operator==(const LocationKey &a, const LocationKey &b)
+    {
+        return a.line == b.line && a.column == b.column && a.sourceFile == b.sourceFile;
+    }
+
+    friend size_t qHash(const LocationKey &key, size_t seed = 0)
+    {
+        return qHashMulti(seed, key.sourceFile, key.line, key.column);
+    }
+};
+
+struct BindingStatistics
+{
+    QMutex mutex;
+    QHash<LocationKey, QQmlBindingStatistics::Entry> entries;
+    bool dumpRegistered = false;
+};
+
+Q_GLOBAL_STATIC(BindingStatistics, bindingStatistics)
+
+void dumpBindingStatistics()
+{
+    QQmlBindingStatistics::dump();
+}
+
+}
+
+void QQmlBindingStatistics::record(const QQmlBinding *binding, qint64 elapsed)
+{
+    const QQmlSourceLocation location = binding->sourceLocation();
+
+    int fanIn = 0;
+    for (QQmlJavaScriptExpressionGuard *guard = binding->activeGuards.first(); guard;
+         guard = binding->activeGuards.next(guard)) {
+        ++fanIn;
+    }
+    for (TriggerList *trigger = binding->qpropertyChangeTriggers; trigger; trigger = trigger->next)
+        ++fanIn;
+
+    int fanOut = 0;
+    if (QObject *target = binding->targetObject()) {
+        QQmlData *ddata = QQmlData::get(target);
+        const QQmlPropertyData *core = nullptr;
+        binding->getPropertyData(&core, nullptr);
+        if (ddata && core && core->notifyIndex() != -1)
+            fanOut = ddata->endpointCount(core->notifyIndex());
+    }
+
+    BindingStatistics *statistics = bindingStatistics();
+    QMutexLocker locker(&statistics->mutex);
+
+    if (!statistics->dumpRegistered) {
+        statistics->dumpRegistered = true;
+        qAddPostRoutine(dumpBindingStatistics);
+    }
+
+    Entry &entry = statistics->entries[{location.sourceFile, location.line, location.column}];
+    if (entry.evaluations == 0) {
+        entry.sourceFile = location.sourceFile;
+        entry.line = location.line;
+        entry.column = location.column;
+    }
+
+    ++entry.evaluations;
+    entry.totalTime += elapsed;
+    entry.maximumTime = std::max(entry.maximumTime, elapsed);
+    entry.fanIn = std::max(entry.fanIn, fanIn);
+    entry.fanOut = std::max(entry.fanOut, fanOut);
+}
+
+/*!
+    \internal
+
+    Returns the recorded bindings, sorted by cumulative evaluation time.
+*/
+QList<QQmlBindingStatistics::Entry> QQmlBindingStatistics::entries()
+{
+    BindingStatistics *statistics = bindingStatistics();
+    QList<Entry> result;
+    {
+        QMutexLocker locker(&statistics->mutex);
+        result = statistics->entries.values();
+    }
+
+    std::sort(result.begin(), result.end(), [](const Entry &a, const Entry &b) {
+        return a.totalTime > b.totalTime;
+    });
+    return result;
+}
+
+QByteArray QQmlBindingStatistics::toJson(const QList<Entry> &entries)
+{
+    QJsonArray bindings;
+    for (const Entry &entry : entries) {
+        bindings.append(QJsonObject {
+            { QStringLiteral("file"), entry.sourceFile },
+            { QStringLiteral("line"), entry.line },
+            { QStringLiteral("column"), entry.column },
+            { QStringLiteral("evaluations"), qint64(entry.evaluations) },
+            { QStringLiteral("totalTimeNs"), entry.totalTime },
+            { QStringLiteral("maximumTimeNs"), entry.maximumTime },
+            { QStringLiteral("fanIn"), entry.fanIn },
+            { QStringLiteral("fanOut"), entry.fanOut }
+        });
+    }
+
+    return QJsonDocument(QJsonObject { { QStringLiteral("bindings"), bindings } }).toJson();
+}
+
+void QQmlBindingStatistics::reset()
+{
+    BindingStatistics *statistics = bindingStatistics();
+    QMutexLocker locker(&statistics->mutex);
+    statistics->entries.clear();
+}
+
+void QQmlBindingStatistics::dump()
+{
+    const QList<Entry> all = entries();
+    if (all.isEmpty())
+        return;
+
+    bool ok = false;
+    int top = qEnvironmentVariableIntValue("QML_BINDING_STATISTICS_TOP", &ok);
+    if (!ok)
+        top = 20;
+
+    if (lcBindingStatistics().isInfoEnabled()) {
+        for (int i = 0, end = std::min(top, int(all.size())); i < end; ++i) {
+            const Entry &entry = all.at(i);
+            qCInfo(lcBindingStatistics).nospace()
+                    << entry.sourceFile << ':' << entry.line << ':' << entry.column
+                    << ": " << entry.evaluations << " evaluations, "
+                    << entry.totalTime / 1000 << " us total, "
+                    << entry.maximumTime / 1000 << " us max, fan-in "
+                    << entry.fanIn << ", fan-out " << entry.fanOut;
+        }
+    }
+
+    const QByteArray json = toJson(all);
+    const QString fileName = qEnvironmentVariable("QML_BINDING_STATISTICS");
+    if (fileName != QLatin1String("-") && fileName != QLatin1String("1")
+            && fileName != QLatin1String("true")) {
+        QFile file(fileName);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write(json);
+            return;
+        }
+        qCWarning(lcBindingStatistics) << "Cannot write binding statistics to" << fileName;
+    }
+
+    fprintf(stdout, "%s", json.constData());
+}
+
+QT_END_NAMESPACE
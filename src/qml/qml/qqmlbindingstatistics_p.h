@@ -0,0 +1,78 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QQMLBINDINGSTATISTICS_P_H
+#define QQMLBINDINGSTATISTICS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <private/qtqmlglobal_p.h>
+
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+class QQmlBinding;
+
+/*!
+    \internal
+
+    Collects per-binding evaluation counts and times if the
+    QML_BINDING_STATISTICS environment variable is set. Bindings are
+    identified by their source location, so that all instances of a binding
+    in a delegate are accounted together.
+
+    When the application exits, the collected data is written as JSON to the
+    file named by QML_BINDING_STATISTICS, or to stdout if the value is any
+    of "-", "1" or "true", or if the file cannot be opened.
+    The bindings with the highest cumulative evaluation time are additionally
+    logged to the qt.qml.binding.statistics category.
+    QML_BINDING_STATISTICS_TOP sets the number of those, 20 by default.
+*/
+class Q_QML_PRIVATE_EXPORT QQmlBindingStatistics
+{
+public:
+    struct Entry
+    {
+        QString sourceFile;
+        quint16 line = 0;
+        quint16 column = 0;
+        quint64 evaluations = 0;
+        qint64 totalTime = 0;   // nanoseconds
+        qint64 maximumTime = 0; // nanoseconds
+        int fanIn = 0;          // maximum number of dependencies
+        int fanOut = 0;         // maximum number of dependents
+    };
+
+    static bool isEnabled() { return enabledFlag(); }
+    // For autotests, which cannot set the environment early enough
+    static void setEnabled(bool enabled) { enabledFlag() = enabled; }
+
+    static void record(const QQmlBinding *binding, qint64 elapsed);
+
+    static QList<Entry> entries();
+    static QByteArray toJson(const QList<Entry> &entries);
+    static void reset();
+    static void dump();
+
+private:
+    static bool &enabledFlag()
+    {
+        static bool enabled = !qEnvironmentVariableIsEmpty("QML_BINDING_STATISTICS");
+        return enabled;
+    }
+};
+
+QT_END_NAMESPACE
+
+#endif // QQMLBINDINGSTATISTICS_P_H
@@ -49,6 +49,7 @@
 QT_BEGIN_NAMESPACE
 
 class QNetworkAccessManager;
+class QQmlBindingBatch;
 class QQmlDelayedError;
 class QQmlIncubator;
 class QQmlMetaObject;
@@ -136,6 +137,9 @@ public:
     QQmlDelayedError *erroredBindings = nullptr;
     int inProgressCreations = 0;
 
+    // The outermost active QQmlBindingBatch, if any
+    QQmlBindingBatch *bindingBatch = nullptr;
+
     QV4::ExecutionEngine *v4engine() const { return q_func()->handle(); }
 
 #if QT_CONFIG(qml_worker_script)
@@ -139,6 +139,8 @@ QQmlObjectCreator::~QQmlObjectCreator()
 QObject *QQmlObjectCreator::create(int subComponentIndex, QObject *parent, QQmlInstantiationInterrupt *interrupt, int flags)
 {
     if (phase == CreatingObjectsPhase2) {
+        if (!createPendingChildren(interrupt))
+            return nullptr;
         phase = ObjectsCreated;
         return context->contextObject();
     }
@@ -196,19 +198,27 @@ QObject *QQmlObjectCreator::create(int subComponentIndex, QObject *parent, QQmlI
         context->setImportedScripts(sharedState->creationContext->importedScripts());
     }
 
+    // An incubator can interrupt the creation of the root object's children
+    rootObjectIndex = objectToCreate;
+    if (interrupt && topLevelCreator && canInterruptCreation())
+        creationInterrupt = interrupt;
+
     QObject *instance = createInstance(objectToCreate, parent, /*isContextObject*/true);
     if (instance) {
         QQmlData *ddata = QQmlData::get(instance);
         Q_ASSERT(ddata);
         ddata->compilationUnit = compilationUnit;
+    } else {
+        pendingChildren.clear();
     }
+    creationInterrupt = nullptr;
 
     if (topLevelCreator)
         sharedState->allJavaScriptObjects = nullptr;
 
     phase = CreatingObjectsPhase2;
 
-    if (interrupt && interrupt->shouldInterrupt())
+    if (!pendingChildren.isEmpty() || (interrupt && interrupt->shouldInterrupt()))
         return nullptr;
 
     phase = ObjectsCreated;
@@ -227,6 +237,68 @@ QObject *QQmlObjectCreator::create(int subComponentIndex, QObject *parent, QQmlI
     return instance;
 }
 
+/*!
+    \internal
+
+    Returns whether create() may leave the children of the root object to
+    later incubation steps. Bindings to aliases are resolved once the root
+    object is complete, and their targets may be among the children, so
+    documents with aliases are always created in one go.
+*/
+bool QQmlObjectCreator::canInterruptCreation() const
+{
+    for (int i = 0, count = compilationUnit->objectCount(); i < count; ++i) {
+        if (compilationUnit->objectAt(i)->aliasCount() > 0)
+            return false;
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Creates the children of the root object that create() left for later,
+    until \a interrupt triggers. Returns \c true once all of them have been
+    created, or an error occurred.
+*/
+bool QQmlObjectCreator::createPendingChildren(QQmlInstantiationInterrupt *interrupt)
+{
+    QObject *root = context->contextObject();
+    if (!root || QQmlData::wasDeleted(root)) {
+        pendingChildren.clear();
+        nextPendingChild = 0;
+        return true;
+    }
+
+    phase = CreatingObjects;
+    doPopulateDeferred(root, rootObjectIndex, [&]() {
+        QQmlListProperty<void> savedList;
+        qSwap(_currentList, savedList);
+
+        while (nextPendingChild < pendingChildren.size()) {
+            const PendingChild &child = pendingChildren.at(nextPendingChild++);
+            void *argv[1] = { (void*)&_currentList };
+            QMetaObject::metacall(_qobject, QMetaObject::ReadProperty, child.property->coreIndex(), argv);
+            if (!setPropertyBinding(child.property, child.binding)) {
+                nextPendingChild = pendingChildren.size();
+                break;
+            }
+            if (interrupt && interrupt->shouldInterrupt())
+                break;
+        }
+
+        qSwap(_currentList, savedList);
+    });
+    phase = CreatingObjectsPhase2;
+
+    if (nextPendingChild < pendingChildren.size())
+        return false;
+
+    pendingChildren.clear();
+    nextPendingChild = 0;
+    return errors.isEmpty();
+}
+
 void QQmlObjectCreator::beginPopulateDeferred(const QQmlRefPointer<QQmlContextData> &newContext)
 {
     context = newContext;
@@ -682,21 +754,27 @@ void QQmlObjectCreator::setupBindings(BindingSetupFlags mode)
             QQmlValueTypeProxyBinding *proxy = static_cast<QQmlValueTypeProxyBinding *>(binding);
 
             if (qmlTypeForObject(_bindingTarget).isValid()) {
-                quint32 bindingSkipList = 0;
-
-                const QQmlPropertyData *defaultProperty = _compiledObject->indexOfDefaultPropertyOrAlias != -1 ? _propertyCache->parent()->defaultProperty() : _propertyCache->defaultProperty();
-
-                const QV4::CompiledData::Binding *binding = _compiledObject->bindingTable();
-                for (quint32 i = 0; i < _compiledObject->nBindings; ++i, ++binding) {
-                    const QQmlPropertyData *property = binding->propertyNameIndex != 0
-                            ? _propertyCache->property(stringAt(binding->propertyNameIndex),
-                                                       _qobject, context)
-                            : defaultProperty;
-                    if (property)
-                        bindingSkipList |= (1 << property->coreIndex());
+                QV4::ObjectLookupCache &cache = objectLookupCache();
+                if (!(cache.resolved & QV4::ObjectLookupCache::ValueTypeBindingSkipList)) {
+                    quint32 bindingSkipList = 0;
+
+                    const QQmlPropertyData *defaultProperty = _compiledObject->indexOfDefaultPropertyOrAlias != -1 ? _propertyCache->parent()->defaultProperty() : _propertyCache->defaultProperty();
+
+                    const QV4::CompiledData::Binding *binding = _compiledObject->bindingTable();
+                    for (quint32 i = 0; i < _compiledObject->nBindings; ++i, ++binding) {
+                        const QQmlPropertyData *property = binding->propertyNameIndex != 0
+                                ? _propertyCache->property(stringAt(binding->propertyNameIndex),
+                                                           _qobject, context)
+                                : defaultProperty;
+                        if (property)
+                            bindingSkipList |= (1 << property->coreIndex());
+                    }
+
+                    cache.valueTypeBindingSkipList = bindingSkipList;
+                    cache.resolved |= QV4::ObjectLookupCache::ValueTypeBindingSkipList;
                 }
 
-                proxy->removeBindings(bindingSkipList);
+                proxy->removeBindings(cache.valueTypeBindingSkipList);
             }
         }
     }
@@ -771,6 +849,17 @@ void QQmlObjectCreator::setupBindings(BindingSetupFlags mode)
             currentListPropertyIndex = -1;
         }
 
+        // Once the incubator's time is up, the remaining child objects of the
+        // root object are created in later steps. All of them, so that list
+        // properties keep the order of the document.
+        if (creationInterrupt && _currentList.object && _compiledObjectIndex == rootObjectIndex
+                && _qobject == _bindingTarget && !_valueTypeProperty
+                && binding->type() == QV4::CompiledData::Binding::Type_Object
+                && (!pendingChildren.isEmpty() || creationInterrupt->shouldInterrupt())) {
+            pendingChildren.append({ property, binding });
+            continue;
+        }
+
         if (!setPropertyBinding(property, binding))
             return;
     }
@@ -1177,15 +1266,29 @@ void QQmlObjectCreator::setupFunctions()
     QV4::ScopedValue function(scope);
     QV4::ScopedContext qmlContext(scope, currentQmlContext());
 
+    // Resolve the property data by name only for the first instance, the
+    // result only depends on the object's property cache.
+    QV4::ObjectLookupCache &cache = objectLookupCache();
+    if (!(cache.resolved & QV4::ObjectLookupCache::Functions)) {
+        cache.functionProperties.reserve(_compiledObject->nFunctions);
+        const quint32_le *functionIdx = _compiledObject->functionOffsetTable();
+        for (quint32 i = 0; i < _compiledObject->nFunctions; ++i, ++functionIdx) {
+            QV4::Function *runtimeFunction = compilationUnit->runtimeFunctions[*functionIdx];
+            const QString name = runtimeFunction->name()->toQString();
+            const QQmlPropertyData *property = _propertyCache->property(name, _qobject, context);
+            cache.functionProperties.append(property->isVMEFunction() ? property : nullptr);
+        }
+        cache.resolved |= QV4::ObjectLookupCache::Functions;
+    }
+
     const quint32_le *functionIdx = _compiledObject->functionOffsetTable();
     for (quint32 i = 0; i < _compiledObject->nFunctions; ++i, ++functionIdx) {
-        QV4::Function *runtimeFunction = compilationUnit->runtimeFunctions[*functionIdx];
-        const QString name = runtimeFunction->name()->toQString();
-
-        const QQmlPropertyData *property = _propertyCache->property(name, _qobject, context);
-        if (!property->isVMEFunction())
+        const QQmlPropertyData *property = cache.functionProperties.at(i);
+        if (!property)
             continue;
 
+        QV4::Function *runtimeFunction = compilationUnit->runtimeFunctions[*functionIdx];
+
         if (runtimeFunction->isGenerator())
             function = QV4::GeneratorFunction::create(qmlContext, runtimeFunction);
         else
@@ -1194,6 +1297,22 @@ void QQmlObjectCreator::setupFunctions()
     }
 }
 
+QV4::ObjectLookupCache &QQmlObjectCreator::objectLookupCache()
+{
+    if (compilationUnit->objectLookupCaches.isEmpty())
+        compilationUnit->objectLookupCaches.resize(compilationUnit->objectCount());
+    QV4::ObjectLookupCache &cache = compilationUnit->objectLookupCaches[_compiledObjectIndex];
+    if (Q_UNLIKELY(!lookupCacheEnabledFlag()))
+        cache = QV4::ObjectLookupCache();
+    return cache;
+}
+
+bool &QQmlObjectCreator::lookupCacheEnabledFlag()
+{
+    static bool enabled = true;
+    return enabled;
+}
+
 void QQmlObjectCreator::recordError(const QV4::CompiledData::Location &location, const QString &description)
 {
     QQmlError error;
@@ -1510,12 +1629,14 @@ bool QQmlObjectCreator::finalize(QQmlInstantiationInterrupt &interrupt)
         }
     }
 
-    for (QQmlFinalizerHook *hook: sharedState->finalizeHooks) {
+    while (sharedState->nextFinalizeHook < sharedState->finalizeHooks.size()) {
+        QQmlFinalizerHook *hook = sharedState->finalizeHooks.at(sharedState->nextFinalizeHook++);
         hook->componentFinalized();
-        if (watcher.hasRecursed())
+        if (watcher.hasRecursed() || interrupt.shouldInterrupt())
             return false;
     }
     sharedState->finalizeHooks.clear();
+    sharedState->nextFinalizeHook = 0;
 
     while (sharedState->componentAttached) {
         QQmlComponentAttached *a = sharedState->componentAttached;
@@ -1554,6 +1675,9 @@ void QQmlObjectCreator::clear()
         a->removeFromList();
     }
 
+    pendingChildren.clear();
+    nextPendingChild = 0;
+
     phase = Done;
 }
 
@@ -94,6 +94,7 @@ struct QQmlObjectCreatorSharedState final : QQmlRefCounted<QQmlObjectCreatorShar
     QV4::Value *allJavaScriptObjects; // pointer to vector on JS stack to reference JS wrappers during creation phase.
     QQmlComponentAttached *componentAttached;
     QList<QQmlFinalizerHook *> finalizeHooks;
+    qsizetype nextFinalizeHook = 0; // finalize() resumes from here after an interruption
     QQmlVmeProfiler profiler;
     QRecursionNode recursionNode;
     RequiredProperties requiredProperties;
@@ -158,7 +159,13 @@ public:
         pendingBindings.erase(it, pendingBindings.end());
     }
 
+    static bool isLookupCacheEnabled() { return lookupCacheEnabledFlag(); }
+    // For benchmarks, to compare with resolving the lookups for every instance
+    static void setLookupCacheEnabled(bool enabled) { lookupCacheEnabledFlag() = enabled; }
+
 private:
+    static bool &lookupCacheEnabledFlag();
+
     QQmlObjectCreator(QQmlRefPointer<QQmlContextData> contextData,
                       const QQmlRefPointer<QV4::ExecutableCompilationUnit> &compilationUnit,
                       QQmlObjectCreatorSharedState *inheritedSharedState,
@@ -190,12 +197,16 @@ private:
     bool setPropertyBinding(const QQmlPropertyData *property, const QV4::CompiledData::Binding *binding);
     void setPropertyValue(const QQmlPropertyData *property, const QV4::CompiledData::Binding *binding);
     void setupFunctions();
+    QV4::ObjectLookupCache &objectLookupCache();
 
     QString stringAt(int idx) const { return compilationUnit->stringAt(idx); }
     void recordError(const QV4::CompiledData::Location &location, const QString &description);
 
     void registerObjectWithContextById(const QV4::CompiledData::Object *object, QObject *instance) const;
 
+    bool canInterruptCreation() const;
+    bool createPendingChildren(QQmlInstantiationInterrupt *interrupt);
+
     inline QV4::QmlContext *currentQmlContext();
     QV4::ResolvedTypeReference *resolvedType(int id) const
     {
@@ -241,6 +252,18 @@ private:
     typedef std::function<bool(QQmlObjectCreatorSharedState *sharedState)> PendingAliasBinding;
     std::vector<PendingAliasBinding> pendingAliasBindings;
 
+    // When incubating, the child objects of the root object that are
+    // assigned to list properties after the interrupt triggered are created
+    // in later incubation steps, see create().
+    struct PendingChild {
+        const QQmlPropertyData *property;
+        const QV4::CompiledData::Binding *binding;
+    };
+    QQmlInstantiationInterrupt *creationInterrupt = nullptr;
+    int rootObjectIndex = -1;
+    QVector<PendingChild> pendingChildren;
+    qsizetype nextPendingChild = 0;
+
     template<typename Functor>
     void doPopulateDeferred(QObject *instance, int deferredIndex, Functor f)
     {
@@ -10,7 +10,9 @@
 #include <QtQml/private/qv4sqlerrors_p.h>
 #include <QtQml/private/qv4jscall_p.h>
 #include <QtQml/private/qv4objectiterator_p.h>
+#include <QtQml/private/qv4qobjectwrapper_p.h>
 
+#include <QtCore/qcache.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qdir.h>
 
@@ -19,6 +21,8 @@
 #include <QtSql/qsqlrecord.h>
 #include <QtSql/qsqlerror.h>
 
+#include <memory>
+
 #if QT_CONFIG(settings)
 #include <QtCore/qsettings.h>
 #endif
@@ -48,15 +52,36 @@ QT_BEGIN_NAMESPACE
 }
 
 
+// A prepared statement that does not produce a result set, kept for reuse
+// with the same SQL text.
+struct QQmlSqlStatement
+{
+    QSqlQuery query;
+    int boundValueCount = 0;
+};
+
+// Least recently used statements of a database connection, by SQL text
+class QQmlSqlStatementCache : public QCache<QString, QQmlSqlStatement>
+{
+public:
+    QQmlSqlStatementCache() : QCache(32) {}
+};
+
 class QQmlSqlDatabaseData : public QV4::ExecutionEngine::Deletable
 {
 public:
     QQmlSqlDatabaseData(QV4::ExecutionEngine *engine);
     ~QQmlSqlDatabaseData() override;
 
+    std::shared_ptr<QQmlSqlStatementCache> statementCache(const QString &connectionName);
+
     QV4::PersistentValue databaseProto;
     QV4::PersistentValue queryProto;
     QV4::PersistentValue rowsProto;
+
+    // By connection name, shared by all handles of a database opened with
+    // openDatabaseSync() and released with the last of them.
+    QHash<QString, std::weak_ptr<QQmlSqlStatementCache>> statementCaches;
 };
 
 V4_DEFINE_EXTENSION(QQmlSqlDatabaseData, databaseData)
@@ -73,12 +98,14 @@ namespace Heap {
             database = new QSqlDatabase;
             version = new QString;
             sqlQuery = new QSqlQuery;
+            statements = new std::shared_ptr<QQmlSqlStatementCache>;
         }
 
         void destroy() {
             delete database;
             delete version;
             delete sqlQuery;
+            delete statements;
             Object::destroy();
         }
 
@@ -92,6 +119,8 @@ namespace Heap {
 
         QSqlQuery *sqlQuery; // type == Rows
         bool forwardOnly; // type == Rows
+
+        std::shared_ptr<QQmlSqlStatementCache> *statements; // type == Database, Query
     };
 }
 
@@ -175,6 +204,17 @@ QQmlSqlDatabaseData::~QQmlSqlDatabaseData()
 {
 }
 
+std::shared_ptr<QQmlSqlStatementCache> QQmlSqlDatabaseData::statementCache(const QString &connectionName)
+{
+    std::weak_ptr<QQmlSqlStatementCache> &cache = statementCaches[connectionName];
+    std::shared_ptr<QQmlSqlStatementCache> statements = cache.lock();
+    if (!statements) {
+        statements = std::make_shared<QQmlSqlStatementCache>();
+        cache = statements;
+    }
+    return statements;
+}
+
 static ReturnedValue qmlsqldatabase_rows_index(const QQmlSqlDatabaseWrapper *r, ExecutionEngine *v4, quint32 index, bool *hasProperty = nullptr)
 {
     Scope scope(v4);
@@ -232,6 +272,44 @@ static QVariant toSqlVariant(const QV4::ScopedValue &value)
     return QV4::ExecutionEngine::toVariant(value, /*typehint*/ QMetaType {});
 }
 
+// Returns the number of values bound
+static int qmlsqldatabase_bindValues(Scope &scope, QSqlQuery &query, const Value &argument)
+{
+    int count = 0;
+    ScopedValue values(scope, argument);
+    if (values->as<ArrayObject>()) {
+        ScopedArrayObject array(scope, values);
+        quint32 size = array->getLength();
+        QV4::ScopedValue v(scope);
+        for (quint32 ii = 0; ii < size; ++ii) {
+            query.bindValue(ii, toSqlVariant((v = array->get(ii))));
+        }
+        count = int(size);
+    } else if (values->as<Object>()) {
+        ScopedObject object(scope, values);
+        ObjectIterator it(scope, object, ObjectIterator::EnumerableOnly);
+        ScopedValue key(scope);
+        QV4::ScopedValue val(scope);
+        while (1) {
+            key = it.nextPropertyName(val);
+            if (key->isNull())
+                break;
+            QVariant v = toSqlVariant(val);
+            if (key->isString()) {
+                query.bindValue(key->stringValue()->toQString(), v);
+            } else {
+                Q_ASSERT(key->isInteger());
+                query.bindValue(key->integerValue(), v);
+            }
+            ++count;
+        }
+    } else {
+        query.bindValue(0, toSqlVariant(values));
+        count = 1;
+    }
+    return count;
+}
+
 static ReturnedValue qmlsqldatabase_executeSql(const FunctionObject *b, const Value *thisObject, const Value *argv, int argc)
 {
     Scope scope(b);
@@ -250,50 +328,30 @@ static ReturnedValue qmlsqldatabase_executeSql(const FunctionObject *b, const Va
         V4THROW_SQL(SQLEXCEPTION_SYNTAX_ERR, QQmlEngine::tr("Read-only Transaction"));
     }
 
-    QSqlQuery query(db);
+    QQmlSqlStatementCache *statements = r->d()->statements->get();
+    std::unique_ptr<QQmlSqlStatement> statement(statements ? statements->take(sql) : nullptr);
+    QSqlQuery query = statement ? std::move(statement->query) : QSqlQuery(db);
+    bool prepared = bool(statement);
     bool err = false;
 
     ScopedValue result(scope, Value::undefinedValue());
 
-    if (query.prepare(sql)) {
-        if (argc > 1) {
-            ScopedValue values(scope, argv[1]);
-            if (values->as<ArrayObject>()) {
-                ScopedArrayObject array(scope, values);
-                quint32 size = array->getLength();
-                QV4::ScopedValue v(scope);
-                for (quint32 ii = 0; ii < size; ++ii) {
-                    query.bindValue(ii, toSqlVariant((v = array->get(ii))));
-                }
-            } else if (values->as<Object>()) {
-                ScopedObject object(scope, values);
-                ObjectIterator it(scope, object, ObjectIterator::EnumerableOnly);
-                ScopedValue key(scope);
-                QV4::ScopedValue val(scope);
-                while (1) {
-                    key = it.nextPropertyName(val);
-                    if (key->isNull())
-                        break;
-                    QVariant v = toSqlVariant(val);
-                    if (key->isString()) {
-                        query.bindValue(key->stringValue()->toQString(), v);
-                    } else {
-                        Q_ASSERT(key->isInteger());
-                        query.bindValue(key->integerValue(), v);
-                    }
-                }
-            } else {
-                query.bindValue(0, toSqlVariant(values));
-            }
+    if (prepared || query.prepare(sql)) {
+        int boundValueCount = argc > 1 ? qmlsqldatabase_bindValues(scope, query, argv[1]) : 0;
+        if (prepared && boundValueCount != statement->boundValueCount) {
+            // Don't let values bound by an earlier call linger
+            query = QSqlQuery(db);
+            if (query.prepare(sql))
+                boundValueCount = argc > 1 ? qmlsqldatabase_bindValues(scope, query, argv[1]) : 0;
+            else
+                err = true;
         }
-        if (query.exec()) {
+        if (!err && query.exec()) {
             QV4::Scoped<QQmlSqlDatabaseWrapper> rows(scope, QQmlSqlDatabaseWrapper::create(scope.engine));
             QV4::ScopedObject p(scope, databaseData(scope.engine)->rowsProto.value());
             rows->setPrototypeUnchecked(p.getPointer());
             rows->d()->type = Heap::QQmlSqlDatabaseWrapper::Rows;
             *rows->d()->database = db;
-            *rows->d()->sqlQuery = std::move(query);
-            QSqlQuery *queryPtr = rows->d()->sqlQuery;
 
             ScopedObject resultObject(scope, scope.engine->newObject());
             result = resultObject.asReturnedValue();
@@ -301,11 +359,23 @@ static ReturnedValue qmlsqldatabase_executeSql(const FunctionObject *b, const Va
             ScopedString s(scope);
             ScopedValue v(scope);
             resultObject->put((s = scope.engine->newIdentifier(QLatin1String("rowsAffected"))).getPointer(),
-                              (v = Value::fromInt32(queryPtr->numRowsAffected())));
+                              (v = Value::fromInt32(query.numRowsAffected())));
             resultObject->put((s = scope.engine->newIdentifier(QLatin1String("insertId"))).getPointer(),
-                              (v = scope.engine->newString(queryPtr->lastInsertId().toString())));
+                              (v = scope.engine->newString(query.lastInsertId().toString())));
             resultObject->put((s = scope.engine->newIdentifier(QLatin1String("rows"))).getPointer(),
                               rows);
+
+            if (query.isSelect() || !statements) {
+                *rows->d()->sqlQuery = std::move(query);
+            } else {
+                // Nothing to read from it, so keep it prepared for the next call
+                query.finish();
+                if (!statement)
+                    statement = std::make_unique<QQmlSqlStatement>();
+                statement->query = std::move(query);
+                statement->boundValueCount = boundValueCount;
+                statements->insert(sql, statement.release());
+            }
         } else {
             err = true;
         }
@@ -318,6 +388,57 @@ static ReturnedValue qmlsqldatabase_executeSql(const FunctionObject *b, const Va
     RETURN_RESULT(result->asReturnedValue());
 }
 
+static ReturnedValue qmlsqldatabase_executeBatch(const FunctionObject *b, const Value *thisObject, const Value *argv, int argc)
+{
+    Scope scope(b);
+    QV4::Scoped<QQmlSqlDatabaseWrapper> r(scope, thisObject->as<QQmlSqlDatabaseWrapper>());
+    if (!r || r->d()->type != Heap::QQmlSqlDatabaseWrapper::Query)
+        V4THROW_REFERENCE("Not a SQLDatabase::Query object");
+
+    if (!r->d()->inTransaction)
+        V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR,QQmlEngine::tr("executeBatch called outside transaction()"));
+
+    QString sql = argc ? argv[0].toQString() : QString();
+
+    if (r->d()->readonly && !sql.startsWith(QLatin1String("SELECT"),Qt::CaseInsensitive)) {
+        V4THROW_SQL(SQLEXCEPTION_SYNTAX_ERR, QQmlEngine::tr("Read-only Transaction"));
+    }
+
+    ScopedArrayObject batch(scope, argc > 1 ? argv[1] : Value::undefinedValue());
+    if (!batch)
+        V4THROW_SQL(SQLEXCEPTION_SYNTAX_ERR, QQmlEngine::tr("executeBatch: values are not an array"));
+
+    QSqlQuery query(*r->d()->database);
+    if (!query.prepare(sql))
+        V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR, query.lastError().text());
+
+    // All parameter sets share the one prepared statement
+    int rowsAffected = 0;
+    int boundValueCount = -1;
+    const quint32 size = batch->getLength();
+    ScopedValue values(scope);
+    for (quint32 ii = 0; ii < size; ++ii) {
+        values = batch->get(ii);
+        const int count = qmlsqldatabase_bindValues(scope, query, values);
+        if (boundValueCount != -1 && count != boundValueCount) {
+            // Values of the previous set would still be bound otherwise
+            V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR,
+                        QQmlEngine::tr("executeBatch: entry %1 has %2 values, expected %3")
+                                .arg(ii).arg(count).arg(boundValueCount));
+        }
+        boundValueCount = count;
+        if (!query.exec())
+            V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR, query.lastError().text());
+        rowsAffected += qMax(0, query.numRowsAffected());
+    }
+
+    ScopedObject resultObject(scope, scope.engine->newObject());
+    ScopedString s(scope, scope.engine->newIdentifier(QLatin1String("rowsAffected")));
+    ScopedValue v(scope, Value::fromInt32(rowsAffected));
+    resultObject->put(s.getPointer(), v);
+    RETURN_RESULT(resultObject->asReturnedValue());
+}
+
 struct TransactionRollback {
     QSqlDatabase *db;
     bool *inTransactionFlag;
@@ -373,6 +494,7 @@ static ReturnedValue qmlsqldatabase_changeVersion(const FunctionObject *b, const
         query->d()->type = Heap::QQmlSqlDatabaseWrapper::Query;
         *query->d()->database = db;
         *query->d()->version = *r->d()->version;
+        *query->d()->statements = *r->d()->statements;
 
         ok = false;
         db.transaction();
@@ -399,6 +521,7 @@ static ReturnedValue qmlsqldatabase_changeVersion(const FunctionObject *b, const
         w->d()->type = Heap::QQmlSqlDatabaseWrapper::Database;
         *w->d()->database = db;
         *w->d()->version = to_version;
+        *w->d()->statements = *r->d()->statements;
 #if QT_CONFIG(settings)
         const QQmlEnginePrivate *enginePrivate = QQmlEnginePrivate::get(scope.engine->qmlEngine());
         QSettings ini(enginePrivate->offlineStorageDatabaseDirectory() + db.connectionName() + QLatin1String(".ini"), QSettings::IniFormat);
@@ -429,6 +552,7 @@ static ReturnedValue qmlsqldatabase_transaction_shared(const FunctionObject *b,
     w->d()->type = Heap::QQmlSqlDatabaseWrapper::Query;
     *w->d()->database = db;
     *w->d()->version = *r->d()->version;
+    *w->d()->statements = *r->d()->statements;
     w->d()->readonly = readOnly;
 
     db.transaction();
@@ -447,6 +571,43 @@ static ReturnedValue qmlsqldatabase_transaction_shared(const FunctionObject *b,
     RETURN_UNDEFINED();
 }
 
+static ReturnedValue qmlsqldatabase_queryModel(const FunctionObject *b, const Value *thisObject, const Value *argv, int argc)
+{
+    Scope scope(b);
+    QV4::Scoped<QQmlSqlDatabaseWrapper> r(scope, thisObject->as<QQmlSqlDatabaseWrapper>());
+    if (!r || r->d()->type != Heap::QQmlSqlDatabaseWrapper::Database)
+        V4THROW_REFERENCE("Not a SQLDatabase object");
+
+#if QT_CONFIG(settings)
+    // The model outlives the call, so make sure it is not built from a
+    // database that was moved to another version through a different handle.
+    const QQmlEnginePrivate *enginePrivate = QQmlEnginePrivate::get(scope.engine->qmlEngine());
+    QSettings ini(enginePrivate->offlineStorageDatabaseDirectory() + r->d()->database->connectionName() + QLatin1String(".ini"), QSettings::IniFormat);
+    const QString currentVersion = ini.value(QLatin1String("Version")).toString();
+    if (currentVersion != *r->d()->version)
+        V4THROW_SQL(SQLEXCEPTION_VERSION_ERR, QQmlEngine::tr("Version mismatch: expected %1, found %2").arg(*r->d()->version).arg(currentVersion));
+#endif
+
+    QString sql = argc ? argv[0].toQString() : QString();
+    if (!sql.startsWith(QLatin1String("SELECT"), Qt::CaseInsensitive))
+        V4THROW_SQL(SQLEXCEPTION_SYNTAX_ERR, QQmlEngine::tr("queryModel: only SELECT statements are supported"));
+
+    // Rows are fetched page by page as the model is asked for more, so the
+    // driver must not cache the whole result.
+    QSqlQuery query(*r->d()->database);
+    query.setForwardOnly(true);
+    if (!query.prepare(sql))
+        V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR, query.lastError().text());
+    if (argc > 1)
+        qmlsqldatabase_bindValues(scope, query, argv[1]);
+    if (!query.exec())
+        V4THROW_SQL(SQLEXCEPTION_DATABASE_ERR, query.lastError().text());
+
+    QQmlSqlQueryModel *model = new QQmlSqlQueryModel(std::move(query));
+    QQmlEngine::setObjectOwnership(model, QQmlEngine::JavaScriptOwnership);
+    RETURN_RESULT(QObjectWrapper::wrap(scope.engine, model));
+}
+
 static ReturnedValue qmlsqldatabase_transaction(const FunctionObject *f, const Value *thisObject, const Value *argv, int argc)
 {
     return qmlsqldatabase_transaction_shared(f, thisObject, argv, argc, false);
@@ -466,12 +627,14 @@ QQmlSqlDatabaseData::QQmlSqlDatabaseData(ExecutionEngine *v4)
         proto->defineDefaultProperty(QStringLiteral("readTransaction"), qmlsqldatabase_read_transaction);
         proto->defineAccessorProperty(QStringLiteral("version"), qmlsqldatabase_version, nullptr);
         proto->defineDefaultProperty(QStringLiteral("changeVersion"), qmlsqldatabase_changeVersion);
+        proto->defineDefaultProperty(QStringLiteral("queryModel"), qmlsqldatabase_queryModel);
         databaseProto = proto;
     }
 
     {
         ScopedObject proto(scope, v4->newObject());
         proto->defineDefaultProperty(QStringLiteral("executeSql"), qmlsqldatabase_executeSql);
+        proto->defineDefaultProperty(QStringLiteral("executeBatch"), qmlsqldatabase_executeBatch);
         queryProto = proto;
     }
     {
@@ -484,6 +647,84 @@ QQmlSqlDatabaseData::QQmlSqlDatabaseData(ExecutionEngine *v4)
     }
 }
 
+QQmlSqlQueryModel::QQmlSqlQueryModel(QSqlQuery &&query, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_query(std::move(query))
+    , m_record(m_query.record())
+{
+    // Have the first page ready for views that do not ask for more.
+    fetchMore(QModelIndex());
+}
+
+int QQmlSqlQueryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant QQmlSqlQueryModel::data(const QModelIndex &index, int role) const
+{
+    const int column = role - Qt::UserRole;
+    if (!index.isValid() || index.row() >= count() || column < 0 || column >= m_record.count())
+        return QVariant();
+    return m_rows.at(index.row()).at(column);
+}
+
+QHash<int, QByteArray> QQmlSqlQueryModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    for (int i = 0; i < m_record.count(); ++i)
+        roles.insert(Qt::UserRole + i, m_record.fieldName(i).toUtf8());
+    return roles;
+}
+
+bool QQmlSqlQueryModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && !m_atEnd;
+}
+
+void QQmlSqlQueryModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid() || m_atEnd)
+        return;
+
+    const int columns = m_record.count();
+    QList<QVariantList> page;
+    page.reserve(PageSize);
+    while (page.size() < PageSize) {
+        if (!m_query.next()) {
+            // Release the statement, and with it the database's read lock
+            m_atEnd = true;
+            m_query.finish();
+            break;
+        }
+
+        QVariantList row;
+        row.reserve(columns);
+        for (int i = 0; i < columns; ++i)
+            row.append(m_query.value(i));
+        page.append(std::move(row));
+    }
+
+    if (page.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), count(), count() + int(page.size()) - 1);
+    m_rows.append(std::move(page));
+    endInsertRows();
+    emit countChanged();
+}
+
+QVariantMap QQmlSqlQueryModel::get(int row) const
+{
+    QVariantMap values;
+    if (row < 0 || row >= count())
+        return values;
+    const QVariantList &rowValues = m_rows.at(row);
+    for (int i = 0; i < m_record.count(); ++i)
+        values.insert(m_record.fieldName(i), rowValues.at(i));
+    return values;
+}
+
 /*
 HTML5 "spec" says "rs.rows[n]", but WebKit only impelments "rs.rows.item(n)". We do both (and property iterator).
 We add a "forwardOnly" property that stops Qt caching results (code promises to only go forward
@@ -592,6 +833,60 @@ activities", 1000000); if (db.version == "0.1") { db.changeVersion("0.1", "0.2",
     });
 \endcode
 
+\section3 result = tx.executeBatch(statement, valuesArray)
+
+This method prepares the SQL \e statement once and executes it for each entry of
+\e valuesArray, binding the entry to the statement's parameters like
+\e executeSql does. This is considerably faster than calling \e executeSql in a
+loop when inserting many rows.
+
+It returns an object whose \c rowsAffected property holds the total number of
+rows affected. If one of the executions fails, an exception is thrown and the
+transaction is rolled back.
+
+\badcode
+    db.transaction(function(tx) {
+        tx.executeBatch("INSERT INTO trip_log VALUES(?, ?)",
+                        [ [ "01/10/2016", "Sylling - Vikersund" ],
+                          [ "02/10/2016", "Vikersund - Noresund" ] ])
+    })
+\endcode
+
+\section3 model = db.queryModel(statement, values)
+
+This method executes the SQL \c select \e statement, binding \e values like
+\e executeSql does, and returns a read-only model of the result that can be
+used directly as the model of a view such as ListView. It can be called outside
+of a transaction.
+
+Each column of the result is available as a role of the same name. Rows are
+fetched from the database in pages of 256 when the view asks for more data, so
+very large results do not have to be read into memory up front. The model's
+\c count property holds the number of rows fetched so far, and \c get(i)
+returns row \e i as an object.
+
+Like the rest of this API, the model is synchronous. The statement is executed
+and the first page is read before \c queryModel() returns, and each further
+page is read on the GUI thread when the view asks for it. Rows that have been
+fetched are kept for the lifetime of the model, so its memory use grows with
+the number of rows the view has scrolled through, up to the whole result. Use
+\c LIMIT to bound statements whose result may be very large.
+
+The model keeps the query active until all rows have been fetched or the model
+is destroyed. While the query is active, the database stays locked for
+writing from other connections.
+
+May throw exception with code property SQLException.DATABASE_ERR,
+SQLException.SYNTAX_ERR, or SQLException.VERSION_ERR if the version of the
+database was changed since \e db was obtained.
+
+\badcode
+    ListView {
+        model: db.queryModel("SELECT date, distance FROM trip_log ORDER BY date")
+        delegate: Text { text: date + ": " + distance }
+    }
+\endcode
+
 \section3 db.transaction(callback(tx))
 
 This method creates a read/write transaction and passed to \e callback. In this function,
@@ -655,6 +950,10 @@ It returns a results object, with the following properties:
 May throw exception with code property SQLException.DATABASE_ERR, SQLException.SYNTAX_ERR, or
 SQLException.UNKNOWN_ERR.
 
+Statements that do not return rows, such as \c insert or \c update, are kept
+prepared per database connection and reused when the same \e statement is
+executed again.
+
 See below for an example:
 
 \quotefromfile localstorage/Database.js
@@ -744,6 +1043,7 @@ void QQmlLocalStorage::openDatabaseSync(QQmlV4Function *args)
     db->setPrototypeUnchecked(p.getPointer());
     *db->d()->database = database;
     *db->d()->version = version;
+    *db->d()->statements = databaseData(scope.engine)->statementCache(database.connectionName());
 
     if (created && dbcreationCallback) {
         JSCallArguments jsCall(scope, 1);
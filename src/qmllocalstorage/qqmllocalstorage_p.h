@@ -18,8 +18,11 @@
 //
 
 #include <QtCore/qobject.h>
+#include <QtCore/qabstractitemmodel.h>
 #include <QtQml/qqml.h>
 #include <QtQml/private/qv4engine_p.h>
+#include <QtSql/qsqlquery.h>
+#include <QtSql/qsqlrecord.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -37,6 +40,40 @@ public:
     Q_INVOKABLE void openDatabaseSync(QQmlV4Function* args);
 };
 
+// Reads the result of a SELECT statement page by page, synchronously, as the
+// view asks for more. Fetched rows are kept until the model is destroyed.
+class Q_QMLLOCALSTORAGE_PRIVATE_EXPORT QQmlSqlQueryModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged FINAL)
+
+public:
+    explicit QQmlSqlQueryModel(QSqlQuery &&query, QObject *parent = nullptr);
+    ~QQmlSqlQueryModel() override = default;
+
+    int count() const { return int(m_rows.size()); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    Q_INVOKABLE QVariantMap get(int row) const;
+
+Q_SIGNALS:
+    void countChanged();
+
+private:
+    enum { PageSize = 256 };
+
+    QSqlQuery m_query;
+    QSqlRecord m_record;
+    QList<QVariantList> m_rows;
+    bool m_atEnd = false;
+};
+
 QT_END_NAMESPACE
 
 #endif // QQMLLOCALSTORAGE_P_H
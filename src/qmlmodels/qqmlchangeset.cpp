@@ -3,8 +3,165 @@
 
 #include "qqmlchangeset_p.h"
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+/*
+    Walks a sorted list of changes while it is being rewritten in place.
+
+    Entries the cursor has moved past are final. Instead of shifting the rest
+    of the vector on every insertion or removal, the cursor keeps a gap
+    between the final entries and the ones it has yet to visit, and only
+    closes it in finish(). Merging k changes into a set of n changes is then
+    O(n + k) rather than O(n * k), and skipping over unaffected entries
+    costs O(log n) as long as nothing has been inserted or removed yet.
+*/
+class ChangeCursor
+{
+public:
+    using Change = QQmlChangeSet::Change;
+
+    explicit ChangeCursor(QVector<Change> *list) : m_list(list) {}
+
+    bool atEnd() const { return m_pending.isEmpty() && m_read == m_list->size(); }
+
+    Change &operator*() { return current(); }
+    Change *operator->() { return &current(); }
+
+    // The n-th entry after the current one, if any.
+    bool hasPeek(qsizetype n) const
+    {
+        return n < m_pending.size() + m_list->size() - m_read;
+    }
+    Change &peek(qsizetype n)
+    {
+        if (n < m_pending.size())
+            return m_pending[m_pending.size() - 1 - n];
+        return (*m_list)[m_read + n - m_pending.size()];
+    }
+
+    // Moves past the current entry.
+    void next()
+    {
+        if (!m_pending.isEmpty()) {
+            const Change change = m_pending.takeLast();
+            put(change);
+        } else if (m_write == m_read) {
+            ++m_write;
+            ++m_read;
+        } else {
+            (*m_list)[m_write++] = (*m_list)[m_read++];
+        }
+    }
+
+    // Moves past all entries that match a predicate, calling visit on each of
+    // them. The entries have to be ordered such that the predicate holds for
+    // a prefix of them.
+    template <typename Predicate, typename Visitor>
+    void skipWhile(Predicate predicate, Visitor visit)
+    {
+        while (!m_pending.isEmpty() && predicate(m_pending.last())) {
+            visit(m_pending.last());
+            next();
+        }
+        if (!m_pending.isEmpty())
+            return;
+        const auto begin = m_list->begin() + m_read;
+        const auto end = std::partition_point(begin, m_list->end(), predicate);
+        if (m_write != m_read)
+            std::copy(begin, end, m_list->begin() + m_write);
+        for (auto it = m_list->begin() + m_write, last = it + (end - begin); it != last; ++it)
+            visit(*it);
+        m_write += end - begin;
+        m_read += end - begin;
+    }
+
+    template <typename Predicate>
+    void skipWhile(Predicate predicate)
+    {
+        skipWhile(predicate, [](Change &) {});
+    }
+
+    // Inserts a change before the current one.
+    void insert(const Change &change) { put(change); }
+
+    // Inserts a change after the current one, without moving past the latter.
+    void insertAfter(const Change &change)
+    {
+        const Change c = current();
+        drop();
+        m_pending.append(change);
+        m_pending.append(c);
+    }
+
+    // Removes the current entry.
+    void erase() { drop(); }
+
+    // Removes the n entries following the current one.
+    void eraseAfter(qsizetype n)
+    {
+        const Change c = current();
+        drop();
+        while (n-- > 0)
+            drop();
+        m_pending.append(c);
+    }
+
+    // Shifts the index of all remaining entries by delta and closes the gap.
+    // The list must not be used through the cursor afterwards.
+    void finish(int delta = 0)
+    {
+        while (!m_pending.isEmpty()) {
+            m_pending.last().index += delta;
+            next();
+        }
+        if (m_write != m_read)
+            m_list->remove(m_write, m_read - m_write);
+        if (delta != 0) {
+            for (auto it = m_list->begin() + m_write; it != m_list->end(); ++it)
+                it->index += delta;
+        }
+        m_read = m_write = m_list->size();
+    }
+
+private:
+    Change &current()
+    {
+        return m_pending.isEmpty() ? (*m_list)[m_read] : m_pending.last();
+    }
+
+    void drop()
+    {
+        if (m_pending.isEmpty())
+            ++m_read;
+        else
+            m_pending.removeLast();
+    }
+
+    void put(const Change &change)
+    {
+        if (m_write == m_read) {
+            // Grow the gap geometrically, so that many insertions only shift
+            // the remaining entries a logarithmic number of times. A single
+            // insertion shifts them only once, as it leaves no gap to close.
+            m_gapSize = m_gapSize == 0 ? 1 : qMax<qsizetype>(8, m_gapSize * 2);
+            m_list->insert(m_read, m_gapSize, Change());
+            m_read += m_gapSize;
+        }
+        (*m_list)[m_write++] = change;
+    }
+
+    QVector<Change> *m_list;
+    QVector<Change> m_pending;
+    qsizetype m_write = 0;
+    qsizetype m_read = 0;
+    qsizetype m_gapSize = 0;
+};
+
+}
 
 /*!
     \class QQmlChangeSet
@@ -146,38 +303,41 @@ void QQmlChangeSet::remove(QVector<Change> *removes, QVector<Change> *inserts)
 {
     int removeCount = 0;
     int insertCount = 0;
-    QVector<Change>::iterator insert = m_inserts.begin();
-    QVector<Change>::iterator change = m_changes.begin();
-    QVector<Change>::iterator rit = removes->begin();
-    for (; rit != removes->end(); ++rit) {
+    ChangeCursor insert(&m_inserts);
+    ChangeCursor change(&m_changes);
+    ChangeCursor rit(removes);
+    for (; !rit.atEnd(); rit.next()) {
         int index = rit->index + removeCount;
         int count = rit->count;
 
         // Decrement the accumulated remove count from the indexes of any changes prior to the
         // current remove.
-        for (; change != m_changes.end() && change->end() < rit->index; ++change)
-            change->index -= removeCount;
+        change.skipWhile([&](const Change &c) { return c.end() < rit->index; },
+                         [&](Change &c) { c.index -= removeCount; });
         // Remove any portion of a change notification that intersects the current remove.
-        for (; change != m_changes.end() && change->index > rit->end(); ++change) {
+        while (!change.atEnd() && change->index > rit->end()) {
             change->count -= qMin(change->end(), rit->end()) - qMax(change->index, rit->index);
             if (change->count == 0) {
-                change = m_changes.erase(change);
+                change.erase();
+                if (change.atEnd())
+                    break;
             } else if (rit->index < change->index) {
                 change->index = rit->index;
             }
+            change.next();
         }
 
         // Decrement the accumulated remove count from the indexes of any inserts prior to the
         // current remove.
-        for (; insert != m_inserts.end() && insert->end() <= index; ++insert) {
-            insertCount += insert->count;
-            insert->index -= removeCount;
-        }
+        insert.skipWhile([&](const Change &i) { return i.end() <= index; }, [&](Change &i) {
+            insertCount += i.count;
+            i.index -= removeCount;
+        });
 
         rit->index -= insertCount;
 
         // Remove any portion of a insert notification that intersects the current remove.
-        while (insert != m_inserts.end() && insert->index < index + count) {
+        while (!insert.atEnd() && insert->index < index + count) {
             int offset =  index - insert->index;
             const int difference = qMin(insert->end(), index + count) - qMax(insert->index, index);
 
@@ -185,9 +345,7 @@ void QQmlChangeSet::remove(QVector<Change> *removes, QVector<Change> *inserts)
             // a new delta for that portion and subtract the size of that delta from the current
             // one.
             if (offset < 0 && rit->moveId != -1) {
-                rit = removes->insert(rit, Change(
-                        rit->index, -offset, rit->moveId, rit->offset));
-                ++rit;
+                rit.insert(Change(rit->index, -offset, rit->moveId, rit->offset));
                 rit->count -= -offset;
                 rit->offset += -offset;
                 index += -offset;
@@ -195,9 +353,8 @@ void QQmlChangeSet::remove(QVector<Change> *removes, QVector<Change> *inserts)
                 removeCount += -offset;
                 offset = 0;
             } else if (offset > 0 && insert->moveId != -1) {
-                insert = m_inserts.insert(insert, Change(
+                insert.insert(Change(
                         insert->index - removeCount, offset, insert->moveId, insert->offset));
-                ++insert;
                 insert->index += offset;
                 insert->count -= offset;
                 insert->offset += offset;
@@ -261,7 +418,7 @@ void QQmlChangeSet::remove(QVector<Change> *removes, QVector<Change> *inserts)
             removeCount += difference;
 
             if (insert->count == 0) {
-                insert = m_inserts.erase(insert);
+                insert.erase();
             } else if (rit->count == -offset || rit->count == 0) {
                 insert->index += difference;
                 break;
@@ -269,87 +426,85 @@ void QQmlChangeSet::remove(QVector<Change> *removes, QVector<Change> *inserts)
                 insert->index -= removeCount - difference;
                 rit->index -= insert->count;
                 insertCount += insert->count;
-                ++insert;
+                insert.next();
             }
         }
         removeCount += rit->count;
     }
-    for (; insert != m_inserts.end(); ++insert)
-        insert->index -= removeCount;
+    insert.finish(-removeCount);
+    change.finish();
+    rit.finish();
 
     removeCount = 0;
-    QVector<Change>::iterator remove = m_removes.begin();
-    for (rit = removes->begin(); rit != removes->end(); ++rit) {
-        if (rit->count == 0)
+    ChangeCursor remove(&m_removes);
+    for (QVector<Change>::iterator it = removes->begin(); it != removes->end(); ++it) {
+        if (it->count == 0)
             continue;
         // Accumulate consecutive removes into a single delta before attempting to apply.
-        for (QVector<Change>::iterator next = rit + 1; next != removes->end()
-                && next->index == rit->index
+        for (QVector<Change>::iterator next = it + 1; next != removes->end()
+                && next->index == it->index
                 && next->moveId == -1
-                && rit->moveId == -1; ++next) {
-            next->count += rit->count;
-            rit = next;
+                && it->moveId == -1; ++next) {
+            next->count += it->count;
+            it = next;
         }
-        int index = rit->index + removeCount;
+        int index = it->index + removeCount;
         // Decrement the accumulated remove count from the indexes of any inserts prior to the
         // current remove.
-        for (; remove != m_removes.end() && index > remove->index; ++remove)
-            remove->index -= removeCount;
-        while (remove != m_removes.end() && index + rit->count >= remove->index) {
+        remove.skipWhile([&](const Change &r) { return index > r.index; },
+                         [&](Change &r) { r.index -= removeCount; });
+        while (!remove.atEnd() && index + it->count >= remove->index) {
             int count = 0;
             const int offset = remove->index - index;
-            QVector<Change>::iterator rend = remove;
-            for (; rend != m_removes.end()
-                    && rit->moveId == -1
-                    && rend->moveId == -1
-                    && index + rit->count >= rend->index; ++rend) {
-                count += rend->count;
+            qsizetype rend = 0;
+            for (; remove.hasPeek(rend)
+                    && it->moveId == -1
+                    && remove.peek(rend).moveId == -1
+                    && index + it->count >= remove.peek(rend).index; ++rend) {
+                count += remove.peek(rend).count;
             }
-            if (remove != rend) {
+            if (rend > 0) {
                 // Accumulate all existing non-move removes that are encapsulated by or immediately
                 // follow the current remove into it.
                 int difference = 0;
-                if (rend == m_removes.end()) {
-                    difference = rit->count;
-                } else if (rit->index + rit->count < rend->index - removeCount) {
-                    difference = rit->count;
-                } else if (rend->moveId != -1) {
-                    difference = rend->index - removeCount - rit->index;
+                if (!remove.hasPeek(rend)) {
+                    difference = it->count;
+                } else if (it->index + it->count < remove.peek(rend).index - removeCount) {
+                    difference = it->count;
+                } else if (remove.peek(rend).moveId != -1) {
+                    difference = remove.peek(rend).index - removeCount - it->index;
                     index += difference;
                 }
                 count += difference;
 
-                rit->count -= difference;
+                it->count -= difference;
                 removeCount += difference;
-                remove->index = rit->index;
+                remove->index = it->index;
                 remove->count = count;
-                remove = m_removes.erase(++remove, rend);
+                remove.next();
+                for (; rend > 1; --rend)
+                    remove.erase();
             } else {
                 // Insert a remove for the portion of the unmergable current remove prior to the
                 // point of intersection.
                 if (offset > 0) {
-                    remove = m_removes.insert(remove, Change(
-                            rit->index, offset, rit->moveId, rit->offset));
-                    ++remove;
-                    rit->count -= offset;
-                    rit->offset += offset;
+                    remove.insert(Change(it->index, offset, it->moveId, it->offset));
+                    it->count -= offset;
+                    it->offset += offset;
                     removeCount += offset;
                     index += offset;
                 }
-                remove->index = rit->index;
+                remove->index = it->index;
 
-                ++remove;
+                remove.next();
             }
         }
 
-        if (rit->count > 0) {
-            remove = m_removes.insert(remove, *rit);
-            ++remove;
-        }
-        removeCount += rit->count;
+        if (it->count > 0)
+            remove.insert(*it);
+        removeCount += it->count;
     }
-    for (; remove != m_removes.end(); ++remove)
-        remove->index -= removeCount;
+    remove.finish(-removeCount);
     m_difference -= removeCount;
 }
 
@@ -360,8 +515,8 @@ void QQmlChangeSet::remove(QVector<Change> *removes, QVector<Change> *inserts)
 void QQmlChangeSet::insert(const QVector<Change> &inserts)
 {
     int insertCount = 0;
-    QVector<Change>::iterator insert = m_inserts.begin();
-    QVector<Change>::iterator change = m_changes.begin();
+    ChangeCursor insert(&m_inserts);
+    ChangeCursor change(&m_changes);
     for (QVector<Change>::const_iterator iit = inserts.begin(); iit != inserts.end(); ++iit) {
         if (iit->count == 0)
             continue;
@@ -379,33 +534,30 @@ void QQmlChangeSet::insert(const QVector<Change> &inserts)
 
         // Increment the index of any changes before the current insert by the accumlated insert
         // count.
-        for (; change != m_changes.end() && change->index >= index; ++change)
+        for (; !change.atEnd() && change->index >= index; change.next())
             change->index += insertCount;
         // If the current insert index is in the middle of a change split it in two at that
         // point and increment the index of the latter half.
-        if (change != m_changes.end() && change->index < index + iit->count) {
+        if (!change.atEnd() && change->index < index + iit->count) {
                 int offset = index - change->index;
-                change = m_changes.insert(change, Change(change->index + insertCount, offset));
-                ++change;
+                change.insert(Change(change->index + insertCount, offset));
                 change->index += iit->count + offset;
                 change->count -= offset;
         }
 
         // Increment the index of any inserts before the current insert by the accumlated insert
         // count.
-        for (; insert != m_inserts.end() && index > insert->index + insert->count; ++insert)
-            insert->index += insertCount;
-        if (insert == m_inserts.end()) {
-            insert = m_inserts.insert(insert, current);
-            ++insert;
+        insert.skipWhile([&](const Change &i) { return index > i.index + i.count; },
+                         [&](Change &i) { i.index += insertCount; });
+        if (insert.atEnd()) {
+            insert.insert(current);
         } else {
             const int offset = index - insert->index;
 
             if (offset < 0) {
                 // If the current insert is before an existing insert and not adjacent just insert
                 // it into the list.
-                insert = m_inserts.insert(insert, current);
-                ++insert;
+                insert.insert(current);
             } else if (iit->moveId == -1 && insert->moveId == -1) {
                 // If neither the current nor existing insert has a moveId add the current insert
                 // to the existing one.
@@ -415,32 +567,29 @@ void QQmlChangeSet::insert(const QVector<Change> &inserts)
                 } else {
                     insert->index += insertCount;
                     insert->count += current.count;
-                    ++insert;
+                    insert.next();
                 }
             } else if (offset < insert->count) {
                 // If either insert has a moveId then split the existing insert and insert the
                 // current one in the middle.
                 if (offset > 0) {
-                    insert = m_inserts.insert(insert, Change(
+                    insert.insert(Change(
                             insert->index + insertCount, offset, insert->moveId, insert->offset));
-                    ++insert;
                     insert->index += offset;
                     insert->count -= offset;
                     insert->offset += offset;
                 }
-                insert = m_inserts.insert(insert, current);
-                ++insert;
+                insert.insert(current);
             } else {
                 insert->index += insertCount;
-                ++insert;
-                insert = m_inserts.insert(insert, current);
-                ++insert;
+                insert.next();
+                insert.insert(current);
             }
         }
         insertCount += current.count;
     }
-    for (; insert != m_inserts.end(); ++insert)
-        insert->index += insertCount;
+    insert.finish(insertCount);
+    change.finish();
     m_difference += insertCount;
 }
 
@@ -469,29 +618,29 @@ void QQmlChangeSet::change(const QVector<Change> &changes)
 
 void QQmlChangeSet::change(QVector<Change> *changes)
 {
-    QVector<Change>::iterator insert = m_inserts.begin();
-    QVector<Change>::iterator change = m_changes.begin();
-    for (QVector<Change>::iterator cit = changes->begin(); cit != changes->end(); ++cit) {
-        for (; insert != m_inserts.end() && insert->end() < cit->index; ++insert) {}
-        for (; insert != m_inserts.end() && insert->index < cit->end(); ++insert) {
+    QVector<Change>::const_iterator insert = m_inserts.cbegin();
+    ChangeCursor change(&m_changes);
+    ChangeCursor cit(changes);
+    for (; !cit.atEnd(); cit.next()) {
+        insert = std::partition_point(insert, m_inserts.cend(), [&](const Change &i) {
+            return i.end() < cit->index;
+        });
+        for (; insert != m_inserts.cend() && insert->index < cit->end(); ++insert) {
             const int offset = insert->index - cit->index;
             const int count = cit->count + cit->index - insert->index - insert->count;
             if (offset == 0) {
                 cit->index = insert->index + insert->count;
                 cit->count = count;
             } else {
-                cit = changes->insert(++cit, Change(insert->index + insert->count, count));
-                --cit;
+                cit.insertAfter(Change(insert->index + insert->count, count));
                 cit->count = offset;
             }
         }
 
-        for (; change != m_changes.end() && change->index + change->count < cit->index; ++change) {}
-        if (change == m_changes.end() || change->index > cit->index + cit->count) {
-            if (cit->count > 0) {
-                change = m_changes.insert(change, *cit);
-                ++change;
-            }
+        change.skipWhile([&](const Change &c) { return c.index + c.count < cit->index; });
+        if (change.atEnd() || change->index > cit->index + cit->count) {
+            if (cit->count > 0)
+                change.insert(*cit);
         } else {
             if (cit->index < change->index) {
                 change->count += change->index - cit->index;
@@ -500,19 +649,19 @@ void QQmlChangeSet::change(QVector<Change> *changes)
 
             if (cit->index + cit->count > change->index + change->count) {
                 change->count = cit->index + cit->count - change->index;
-                QVector<Change>::iterator cbegin = change;
-                QVector<Change>::iterator cend = ++cbegin;
-                for (; cend != m_changes.end() && cend->index <= change->index + change->count; ++cend) {
-                    if (cend->index + cend->count > change->index + change->count)
-                        change->count = cend->index + cend->count - change->index;
-                }
-                if (cbegin != cend) {
-                    change = m_changes.erase(cbegin, cend);
-                    --change;
+                qsizetype merged = 1;
+                for (; change.hasPeek(merged)
+                        && change.peek(merged).index <= change->index + change->count; ++merged) {
+                    const Change &next = change.peek(merged);
+                    if (next.index + next.count > change->index + change->count)
+                        change->count = next.index + next.count - change->index;
                 }
+                change.eraseAfter(merged - 1);
             }
         }
     }
+    cit.finish();
+    change.finish();
 }
 
 /*!
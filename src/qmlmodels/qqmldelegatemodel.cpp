@@ -104,6 +104,7 @@ public:
 };
 
 V4_DEFINE_EXTENSION(QQmlDelegateModelEngineData, qdmEngineData)
+V4_DEFINE_EXTENSION(QQmlSharedDelegateModelItemsPool, qdmSharedItemsPool)
 
 
 void QQmlDelegateModelPartsMetaObject::propertyCreated(int, QMetaPropertyBuilder &prop)
@@ -157,6 +158,7 @@ QQmlDelegateModelPrivate::QQmlDelegateModelPrivate(QQmlContext *ctxt)
     , m_cacheMetaType(nullptr)
     , m_context(ctxt)
     , m_parts(nullptr)
+    , m_reusableItemsPool([this](QQmlDelegateModelItem *cacheItem) { destroyCacheItem(cacheItem); })
     , m_filterGroup(QStringLiteral("items"))
     , m_count(0)
     , m_groupCount(Compositor::MinimumGroupCount)
@@ -1061,6 +1063,65 @@ void QQmlDelegateModelPrivate::reuseItem(QQmlDelegateModelItem *item, int newMod
     emit q_func()->itemReused(newModelIndex, item->object);
 }
 
+bool QQmlDelegateModelPrivate::canAdoptPooledItem(const QQmlDelegateModelItem *pooledItem) const
+{
+    // Only items of other delegate models can be handed over, and only if
+    // nothing in the delegate object is tied to the model that created it. The
+    // context object of the item's context is cleared for delegates with
+    // required properties, whose bindings would keep reading the old model
+    // item, and is never set for bound components.
+    QQmlDelegateModel *model = pooledItem->metaType->model;
+    if (!model || model == q_func() || m_adaptorModel.hasProxyObject())
+        return false;
+    if (!pooledItem->object || pooledItem->attached || pooledItem->incubationTask)
+        return false;
+    if (qobject_cast<QQuickPackage *>(pooledItem->object))
+        return false;
+    if (qobject_cast<QQmlAdaptorModelProxyInterface *>(const_cast<QQmlDelegateModelItem *>(pooledItem)))
+        return false;
+    if (!pooledItem->contextData || pooledItem->contextData->contextObject() != pooledItem)
+        return false;
+
+    // The delegate object must have been created in the context we would
+    // create it in ourselves.
+    QQmlContext *creationContext = pooledItem->delegate->creationContext();
+    return pooledItem->contextData->parent()
+            == QQmlContextData::get(creationContext ? creationContext : m_context.data());
+}
+
+QQmlDelegateModelItem *QQmlDelegateModelPrivate::adoptPooledItem(QQmlDelegateModelItem *pooledItem, int modelIndex)
+{
+    QQmlDelegateModelItem *cacheItem = m_adaptorModel.createItem(m_cacheMetaType, modelIndex);
+    if (!cacheItem) {
+        if (QQmlDelegateModel *model = pooledItem->metaType->model)
+            QQmlDelegateModelPrivate::get(model)->destroyCacheItem(pooledItem);
+        return nullptr;
+    }
+
+    // Move the delegate object and its context over to a model item of our
+    // own, and make the object resolve model data through it.
+    cacheItem->delegate = pooledItem->delegate;
+    cacheItem->contextData = pooledItem->contextData;
+    cacheItem->contextData->setContextObject(cacheItem);
+    cacheItem->object = pooledItem->object;
+    pooledItem->contextData.reset();
+    pooledItem->object = nullptr;
+
+    if (QQmlData *ddata = QQmlData::get(cacheItem->object)) {
+        if (ddata->context && ddata->context->extraObject() == pooledItem)
+            ddata->context->setExtraObject(cacheItem);
+    }
+
+    // The bindings of the delegate still depend on the properties of the old
+    // model item. Evaluate them again to make them track the new one.
+    cacheItem->contextData->refreshExpressions();
+
+    if (!pooledItem->isReferenced())
+        delete pooledItem;
+
+    return cacheItem;
+}
+
 void QQmlDelegateModelPrivate::drainReusableItemsPool(int maxPoolTime)
 {
     m_reusableItemsPool.drain(maxPoolTime, [this](QQmlDelegateModelItem *cacheItem){ destroyCacheItem(cacheItem); });
@@ -1076,6 +1137,11 @@ int QQmlDelegateModel::poolSize()
     return d_func()->m_reusableItemsPool.size();
 }
 
+QQmlInstanceModel::PoolStatistics QQmlDelegateModel::poolStatistics() const
+{
+    return d_func()->m_reusableItemsPool.statistics();
+}
+
 QQmlComponent *QQmlDelegateModelPrivate::resolveDelegate(int index)
 {
     if (!m_delegateChooser)
@@ -1205,12 +1271,23 @@ QObject *QQmlDelegateModelPrivate::object(Compositor::Group group, int index, QQ
             return nullptr;
 
         if (!cacheItem) {
-            cacheItem = m_reusableItemsPool.takeItem(delegate, index);
+            cacheItem = m_reusableItemsPool.takeItem(
+                        delegate, index, [this](const QQmlDelegateModelItem *pooledItem) {
+                return canAdoptPooledItem(pooledItem);
+            });
+            bool handedOver = false;
+            if (cacheItem && cacheItem->metaType.data() != m_cacheMetaType) {
+                // The item was pooled by another view using the same delegate.
+                cacheItem = adoptPooledItem(cacheItem, modelIndex);
+                handedOver = cacheItem != nullptr;
+            }
             if (cacheItem) {
                 // Move the pooled item back into the cache, update
                 // all related properties, and return the object (which
                 // has already been incubated, otherwise it wouldn't be in the pool).
                 addCacheItem(cacheItem, it);
+                if (handedOver)
+                    emit q_func()->initItem(index, cacheItem->object);
                 reuseItem(cacheItem, index, flags);
                 cacheItem->referenceObject();
 
@@ -3790,6 +3867,47 @@ void QQmlPartsModel::emitModelUpdated(const QQmlChangeSet &changeSet, bool reset
     }
 }
 
+QQmlReusableDelegateModelItemsPool::QQmlReusableDelegateModelItemsPool(ReleaseItemFunction evictItem)
+    : m_evictItem(std::move(evictItem))
+{
+}
+
+QQmlReusableDelegateModelItemsPool::~QQmlReusableDelegateModelItemsPool()
+{
+    // The owning model drains the pool before it goes away, so normally there
+    // is nothing left to account for in the shared pool.
+    if (m_sharedPool) {
+        m_sharedPool->m_size -= int(m_reusableItemsPool.size());
+        m_sharedPool->m_pools.removeOne(this);
+    }
+}
+
+void QQmlReusableDelegateModelItemsPool::attach(QV4::ExecutionEngine *v4)
+{
+    if (m_sharedPool || !v4)
+        return;
+    m_sharedPool = QQmlSharedDelegateModelItemsPool::get(v4);
+    m_sharedPool->m_pools.append(this);
+}
+
+void QQmlReusableDelegateModelItemsPool::evictOldestItem()
+{
+    Q_ASSERT(!m_reusableItemsPool.isEmpty());
+    QQmlDelegateModelItem *modelItem = m_reusableItemsPool.takeFirst().item;
+    ++m_statistics.evicted;
+    if (m_sharedPool) {
+        --m_sharedPool->m_size;
+        ++m_sharedPool->m_statistics.evicted;
+    }
+
+    qCDebug(lcItemViewDelegateRecycling)
+            << "evicting item:" << modelItem
+            << "delegate:" << modelItem->delegate
+            << "pool size:" << m_reusableItemsPool.size();
+
+    m_evictItem(modelItem);
+}
+
 void QQmlReusableDelegateModelItemsPool::insertItem(QQmlDelegateModelItem *modelItem)
 {
     // Currently, the only way for a view to reuse items is to call release()
@@ -3839,8 +3957,18 @@ void QQmlReusableDelegateModelItemsPool::insertItem(QQmlDelegateModelItem *model
     Q_ASSERT(modelItem->object);
     Q_ASSERT(modelItem->delegate);
 
+    // All pools of an engine share a budget for the number of items that may
+    // rest in them. Once the budget is exceeded, the item that has been pooled
+    // for the longest time is evicted, no matter which view it belongs to.
+    // An item stays in the pool of the model that created it, but can be
+    // handed over to another model that asks for the same delegate, see
+    // takeItem().
+    attach(modelItem->v4);
+
     modelItem->poolTime = 0;
-    m_reusableItemsPool.append(modelItem);
+    const quint64 sequence = m_sharedPool ? m_sharedPool->itemInserted() : 0;
+    m_reusableItemsPool.append({ modelItem, sequence });
+    ++m_statistics.pooled;
 
     qCDebug(lcItemViewDelegateRecycling)
             << "item:" << modelItem
@@ -3849,17 +3977,27 @@ void QQmlReusableDelegateModelItemsPool::insertItem(QQmlDelegateModelItem *model
             << "row:" << modelItem->modelRow()
             << "column:" << modelItem->modelColumn()
             << "pool size:" << m_reusableItemsPool.size();
+
+    if (m_sharedPool)
+        m_sharedPool->enforceBudget();
 }
 
-QQmlDelegateModelItem *QQmlReusableDelegateModelItemsPool::takeItem(const QQmlComponent *delegate, int newIndexHint)
+QQmlDelegateModelItem *QQmlReusableDelegateModelItemsPool::takeItem(
+        const QQmlComponent *delegate, int newIndexHint, const AcceptItemFunction &acceptForeignItem)
 {
     // Find the oldest item in the pool that was made from the same delegate as
     // the given argument, remove it from the pool, and return it.
-    for (auto it = m_reusableItemsPool.begin(); it != m_reusableItemsPool.end(); ++it) {
-        if ((*it)->delegate != delegate)
-            continue;
-        auto modelItem = *it;
-        m_reusableItemsPool.erase(it);
+    if (delegate && delegate->engine())
+        attach(delegate->engine()->handle());
+
+    const int poolIndex = findItem(delegate, {});
+    if (poolIndex >= 0) {
+        auto modelItem = m_reusableItemsPool.takeAt(poolIndex).item;
+        ++m_statistics.hits;
+        if (m_sharedPool) {
+            --m_sharedPool->m_size;
+            ++m_sharedPool->m_statistics.hits;
+        }
 
         qCDebug(lcItemViewDelegateRecycling)
                 << "item:" << modelItem
@@ -3873,6 +4011,29 @@ QQmlDelegateModelItem *QQmlReusableDelegateModelItemsPool::takeItem(const QQmlCo
         return modelItem;
     }
 
+    // If the caller knows how to adopt items created by other models, let it
+    // have a matching item pooled by another view of the engine. The caller
+    // owns the returned item from now on, and must check its meta type to
+    // tell it apart from an item of its own.
+    if (acceptForeignItem && m_sharedPool) {
+        if (auto modelItem = m_sharedPool->takeForeignItem(this, delegate, acceptForeignItem)) {
+            ++m_statistics.hits;
+            ++m_sharedPool->m_statistics.hits;
+
+            qCDebug(lcItemViewDelegateRecycling)
+                    << "handed over item:" << modelItem
+                    << "delegate:" << delegate
+                    << "new index:" << newIndexHint
+                    << "shared pool size:" << m_sharedPool->size();
+
+            return modelItem;
+        }
+    }
+
+    ++m_statistics.misses;
+    if (m_sharedPool)
+        ++m_sharedPool->m_statistics.misses;
+
     qCDebug(lcItemViewDelegateRecycling)
             << "no available item for delegate:" << delegate
             << "new index:" << newIndexHint
@@ -3881,7 +4042,18 @@ QQmlDelegateModelItem *QQmlReusableDelegateModelItemsPool::takeItem(const QQmlCo
     return nullptr;
 }
 
-void QQmlReusableDelegateModelItemsPool::drain(int maxPoolTime, std::function<void(QQmlDelegateModelItem *cacheItem)> releaseItem)
+int QQmlReusableDelegateModelItemsPool::findItem(
+        const QQmlComponent *delegate, const AcceptItemFunction &accept) const
+{
+    for (int i = 0, count = int(m_reusableItemsPool.size()); i < count; ++i) {
+        const QQmlDelegateModelItem *modelItem = m_reusableItemsPool.at(i).item;
+        if (modelItem->delegate == delegate && (!accept || accept(modelItem)))
+            return i;
+    }
+    return -1;
+}
+
+void QQmlReusableDelegateModelItemsPool::drain(int maxPoolTime, ReleaseItemFunction releaseItem)
 {
     // Rather than releasing all pooled items upon a call to this function, each
     // item has a poolTime. The poolTime specifies for how many loading cycles an item
@@ -3891,18 +4063,131 @@ void QQmlReusableDelegateModelItemsPool::drain(int maxPoolTime, std::function<vo
     // items should stay in "circulation", even if they are not recycled right away.
     qCDebug(lcItemViewDelegateRecycling) << "pool size before drain:" << m_reusableItemsPool.size();
 
+    // Take the expired items out of the pool before releasing them, since
+    // releasing an item can make a view pool other items, which in turn can
+    // make the shared pool evict items from this pool.
+    QVarLengthArray<QQmlDelegateModelItem *, 32> expiredItems;
     for (auto it = m_reusableItemsPool.begin(); it != m_reusableItemsPool.end();) {
-        auto modelItem = *it;
+        auto modelItem = it->item;
         modelItem->poolTime++;
         if (modelItem->poolTime <= maxPoolTime) {
             ++it;
         } else {
             it = m_reusableItemsPool.erase(it);
-            releaseItem(modelItem);
+            expiredItems.append(modelItem);
         }
     }
 
-    qCDebug(lcItemViewDelegateRecycling) << "pool size after drain:" << m_reusableItemsPool.size();
+    m_statistics.drained += expiredItems.size();
+    if (m_sharedPool) {
+        m_sharedPool->m_size -= int(expiredItems.size());
+        m_sharedPool->m_statistics.drained += expiredItems.size();
+    }
+
+    for (QQmlDelegateModelItem *modelItem : std::as_const(expiredItems))
+        releaseItem(modelItem);
+
+    qCDebug(lcItemViewDelegateRecycling) << "pool size after drain:" << m_reusableItemsPool.size()
+                                         << "hit rate:" << m_statistics.hitRate();
+    if (m_sharedPool) {
+        qCDebug(lcItemViewDelegateRecycling)
+                << "shared pool size:" << m_sharedPool->size()
+                << "budget:" << m_sharedPool->budget()
+                << "hit rate:" << m_sharedPool->statistics().hitRate()
+                << "evicted:" << m_sharedPool->statistics().evicted;
+    }
+}
+
+/*!
+    \internal
+    \class QQmlSharedDelegateModelItemsPool
+
+    Keeps track of all the reusable item pools of an engine. The pools stay
+    owned by their models, but share a budget for the total number of items
+    that may rest in them at the same time. The budget can be set with the
+    \c QML_DELEGATE_POOL_BUDGET environment variable; 0 (the default) means
+    that it is unlimited. When a view misses in its own pool, the shared pool
+    can hand it an item made from the same delegate by another view, provided
+    the receiving model accepts it. The shared pool also accumulates reuse
+    statistics for all views of the engine.
+*/
+QQmlSharedDelegateModelItemsPool::QQmlSharedDelegateModelItemsPool(QV4::ExecutionEngine *)
+    : m_budget(qMax(0, qEnvironmentVariableIntValue("QML_DELEGATE_POOL_BUDGET")))
+{
+}
+
+QQmlSharedDelegateModelItemsPool::~QQmlSharedDelegateModelItemsPool()
+{
+    for (QQmlReusableDelegateModelItemsPool *pool : std::as_const(m_pools))
+        pool->m_sharedPool = nullptr;
+}
+
+QQmlSharedDelegateModelItemsPool *QQmlSharedDelegateModelItemsPool::get(QV4::ExecutionEngine *v4)
+{
+    return qdmSharedItemsPool(v4);
+}
+
+void QQmlSharedDelegateModelItemsPool::setBudget(int budget)
+{
+    m_budget = qMax(0, budget);
+    enforceBudget();
+}
+
+quint64 QQmlSharedDelegateModelItemsPool::itemInserted()
+{
+    ++m_size;
+    ++m_statistics.pooled;
+    return ++m_sequence;
+}
+
+void QQmlSharedDelegateModelItemsPool::enforceBudget()
+{
+    while (m_budget > 0 && m_size > m_budget) {
+        // Each pool is ordered by insertion, so the globally oldest item is
+        // the first item of one of the pools.
+        QQmlReusableDelegateModelItemsPool *oldestPool = nullptr;
+        for (QQmlReusableDelegateModelItemsPool *pool : std::as_const(m_pools)) {
+            if (pool->m_reusableItemsPool.isEmpty())
+                continue;
+            if (!oldestPool || pool->m_reusableItemsPool.first().sequence
+                    < oldestPool->m_reusableItemsPool.first().sequence) {
+                oldestPool = pool;
+            }
+        }
+        if (!oldestPool)
+            break;
+        oldestPool->evictOldestItem();
+    }
+}
+
+QQmlDelegateModelItem *QQmlSharedDelegateModelItemsPool::takeForeignItem(
+        QQmlReusableDelegateModelItemsPool *requester, const QQmlComponent *delegate,
+        const QQmlReusableDelegateModelItemsPool::AcceptItemFunction &accept)
+{
+    // Hand over the oldest matching item of all other pools, which is the one
+    // that would otherwise be evicted first.
+    QQmlReusableDelegateModelItemsPool *donor = nullptr;
+    int donorIndex = -1;
+    for (QQmlReusableDelegateModelItemsPool *pool : std::as_const(m_pools)) {
+        if (pool == requester)
+            continue;
+        const int poolIndex = pool->findItem(delegate, accept);
+        if (poolIndex < 0)
+            continue;
+        if (!donor || pool->m_reusableItemsPool.at(poolIndex).sequence
+                < donor->m_reusableItemsPool.at(donorIndex).sequence) {
+            donor = pool;
+            donorIndex = poolIndex;
+        }
+    }
+    if (!donor)
+        return nullptr;
+
+    QQmlDelegateModelItem *modelItem = donor->m_reusableItemsPool.takeAt(donorIndex).item;
+    ++donor->m_statistics.handedOver;
+    ++m_statistics.handedOver;
+    --m_size;
+    return modelItem;
 }
 
 //============================================================================
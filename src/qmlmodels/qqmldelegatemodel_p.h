@@ -85,6 +85,7 @@ public:
 
     void drainReusableItemsPool(int maxPoolTime) override;
     int poolSize() override;
+    PoolStatistics poolStatistics() const override;
 
     int indexOf(QObject *object, QObject *objectContext) const override;
 
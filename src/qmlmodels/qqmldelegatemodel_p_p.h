@@ -163,17 +163,74 @@ void QV4::Heap::QQmlDelegateModelItemObject::init(QQmlDelegateModelItem *item)
     this->item = item;
 }
 
+class QQmlSharedDelegateModelItemsPool;
+
 class QQmlReusableDelegateModelItemsPool
 {
 public:
+    using ReleaseItemFunction = std::function<void(QQmlDelegateModelItem *cacheItem)>;
+    using AcceptItemFunction = std::function<bool(const QQmlDelegateModelItem *pooledItem)>;
+
+    explicit QQmlReusableDelegateModelItemsPool(ReleaseItemFunction evictItem);
+    ~QQmlReusableDelegateModelItemsPool();
+
     void insertItem(QQmlDelegateModelItem *modelItem);
-    QQmlDelegateModelItem *takeItem(const QQmlComponent *delegate, int newIndexHint);
+    QQmlDelegateModelItem *takeItem(const QQmlComponent *delegate, int newIndexHint,
+                                    const AcceptItemFunction &acceptForeignItem = {});
     void reuseItem(QQmlDelegateModelItem *item, int newModelIndex);
-    void drain(int maxPoolTime, std::function<void(QQmlDelegateModelItem *cacheItem)> releaseItem);
+    void drain(int maxPoolTime, ReleaseItemFunction releaseItem);
     int size() { return m_reusableItemsPool.size(); }
 
+    const QQmlInstanceModel::PoolStatistics &statistics() const { return m_statistics; }
+
+private:
+    friend class QQmlSharedDelegateModelItemsPool;
+
+    struct PooledItem
+    {
+        QQmlDelegateModelItem *item;
+        quint64 sequence;
+    };
+
+    void attach(QV4::ExecutionEngine *v4);
+    void evictOldestItem();
+    int findItem(const QQmlComponent *delegate, const AcceptItemFunction &accept) const;
+
+    QList<PooledItem> m_reusableItemsPool;
+    ReleaseItemFunction m_evictItem;
+    QQmlSharedDelegateModelItemsPool *m_sharedPool = nullptr;
+    QQmlInstanceModel::PoolStatistics m_statistics;
+};
+
+class Q_QMLMODELS_PRIVATE_EXPORT QQmlSharedDelegateModelItemsPool
+    : public QV4::ExecutionEngine::Deletable
+{
+public:
+    QQmlSharedDelegateModelItemsPool(QV4::ExecutionEngine *v4);
+    ~QQmlSharedDelegateModelItemsPool() override;
+
+    static QQmlSharedDelegateModelItemsPool *get(QV4::ExecutionEngine *v4);
+
+    int size() const { return m_size; }
+    int budget() const { return m_budget; }
+    void setBudget(int budget);
+
+    const QQmlInstanceModel::PoolStatistics &statistics() const { return m_statistics; }
+
 private:
-    QList<QQmlDelegateModelItem *> m_reusableItemsPool;
+    friend class QQmlReusableDelegateModelItemsPool;
+
+    quint64 itemInserted();
+    void enforceBudget();
+    QQmlDelegateModelItem *takeForeignItem(
+            QQmlReusableDelegateModelItemsPool *requester, const QQmlComponent *delegate,
+            const QQmlReusableDelegateModelItemsPool::AcceptItemFunction &accept);
+
+    QList<QQmlReusableDelegateModelItemsPool *> m_pools;
+    QQmlInstanceModel::PoolStatistics m_statistics;
+    quint64 m_sequence = 0;
+    int m_size = 0;
+    int m_budget = 0;
 };
 
 class QQmlDelegateModelPrivate;
@@ -278,6 +335,8 @@ public:
     void updateFilterGroup();
 
     void reuseItem(QQmlDelegateModelItem *item, int newModelIndex, int newGroups);
+    bool canAdoptPooledItem(const QQmlDelegateModelItem *pooledItem) const;
+    QQmlDelegateModelItem *adoptPooledItem(QQmlDelegateModelItem *pooledItem, int modelIndex);
     void drainReusableItemsPool(int maxPoolTime);
     QQmlComponent *resolveDelegate(int index);
 
@@ -59,9 +59,11 @@ QT_BEGIN_NAMESPACE
     that group.  To avoid the inefficiency of iterating over potentially all ranges when looking
     for a specific index, each time a lookup is done the range and its indexes are cached and the
     next lookup is done relative to this.   This works out to near constant time in most relevant
-    use cases because successive index lookups are most frequently adjacent.  The total number of
-    ranges is often quite small, which helps as well. If there is a need for faster random access
-    then a skip list like index may be an appropriate addition.
+    use cases because successive index lookups are most frequently adjacent.  Lookups that fall
+    outside the cached range descend a randomly balanced binary tree (a treap) that is maintained
+    over the ranges in addition to the list, each node of which holds the number of items in each
+    group within its subtree.  This keeps random access, such as when group memberships of many
+    items are toggled, logarithmic in the number of ranges.
 
     \sa DelegateModel
 */
@@ -122,7 +124,8 @@ static bool qt_printInfo(const QQmlListCompositor &compositor)
 static bool qt_verifyIntegrity(
         const QQmlListCompositor::iterator &begin,
         const QQmlListCompositor::iterator &end,
-        const QQmlListCompositor::iterator &cachedIt)
+        const QQmlListCompositor::iterator &cachedIt,
+        const QQmlListCompositor::Range *root)
 {
     bool valid = true;
 
@@ -176,17 +179,22 @@ static bool qt_verifyIntegrity(
             qWarning() << "Group" << i << "count invalid. Expected:" << end.index[i] << "Actual:" << it.index[i];
             valid = false;
         }
+        if (end.index[i] != (root ? root->subtreeCounts[i] : 0)) {
+            qWarning() << "Group" << i << "tree count invalid. Expected:" << end.index[i]
+                    << "Actual:" << (root ? root->subtreeCounts[i] : 0);
+            valid = false;
+        }
     }
     return valid;
 }
 #endif
 
 #if defined(QT_QML_VERIFY_MINIMAL)
-#   define QT_QML_VERIFY_LISTCOMPOSITOR Q_ASSERT(!(!(qt_verifyIntegrity(iterator(m_ranges.next, 0, Default, m_groupCount), m_end, m_cacheIt) \
+#   define QT_QML_VERIFY_LISTCOMPOSITOR Q_ASSERT(!(!(qt_verifyIntegrity(iterator(m_ranges.next, 0, Default, m_groupCount), m_end, m_cacheIt, m_root) \
             && qt_verifyMinimal(iterator(m_ranges.next, 0, Default, m_groupCount), m_end)) \
             && qt_printInfo(*this)));
 #elif defined(QT_QML_VERIFY_INTEGRITY)
-#   define QT_QML_VERIFY_LISTCOMPOSITOR Q_ASSERT(!(!qt_verifyIntegrity(iterator(m_ranges.next, 0, Default, m_groupCount), m_end, m_cacheIt) \
+#   define QT_QML_VERIFY_LISTCOMPOSITOR Q_ASSERT(!(!qt_verifyIntegrity(iterator(m_ranges.next, 0, Default, m_groupCount), m_end, m_cacheIt, m_root) \
             && qt_printInfo(*this)));
 #else
 #   define QT_QML_VERIFY_LISTCOMPOSITOR
@@ -244,6 +252,15 @@ QQmlListCompositor::insert_iterator &QQmlListCompositor::insert_iterator::operat
 }
 
 
+static inline void qt_countSubtree(QQmlListCompositor::Range *range)
+{
+    for (int i = 0; i < QQmlListCompositor::MaximumGroupCount; ++i) {
+        range->subtreeCounts[i] = (range->flags & (1 << i) ? range->count : 0)
+                + (range->left ? range->left->subtreeCounts[i] : 0)
+                + (range->right ? range->right->subtreeCounts[i] : 0);
+    }
+}
+
 /*!
     Constructs an empty list compositor.
 */
@@ -278,7 +295,32 @@ QQmlListCompositor::~QQmlListCompositor()
 inline QQmlListCompositor::Range *QQmlListCompositor::insert(
         Range *before, void *list, int index, int count, uint flags)
 {
-    return new Range(before, list, index, count, flags);
+    Range *range = new Range(before, list, index, count, flags);
+
+    // xorshift, the priorities only need to be uncorrelated with the insert order.
+    m_priorityState ^= m_priorityState << 13;
+    m_priorityState ^= m_priorityState >> 17;
+    m_priorityState ^= m_priorityState << 5;
+    range->priority = m_priorityState;
+
+    // Attach the range as a leaf adjacent to its neighbours in the list, if the previous range
+    // has no right child the range can become that, otherwise the next range is the leftmost
+    // node of that child and has no left child.
+    if (!m_root) {
+        m_root = range;
+    } else if (range->previous != &m_ranges && !range->previous->right) {
+        range->parent = range->previous;
+        range->previous->right = range;
+    } else {
+        range->parent = range->next;
+        range->next->left = range;
+    }
+    updateRange(range);
+
+    while (range->parent && range->parent->priority < range->priority)
+        rotateUp(range);
+
+    return range;
 }
 
 /*!
@@ -293,10 +335,70 @@ inline QQmlListCompositor::Range *QQmlListCompositor::erase(
     Range *next = range->next;
     next->previous = range->previous;
     next->previous->next = range->next;
+
+    // Rotate the range down until it has at most one child and replace it with that child.
+    while (range->left && range->right)
+        rotateUp(range->left->priority > range->right->priority ? range->left : range->right);
+    Range *child = range->left ? range->left : range->right;
+    Range *parent = range->parent;
+    if (child)
+        child->parent = parent;
+    if (!parent)
+        m_root = child;
+    else if (parent->left == range)
+        parent->left = child;
+    else
+        parent->right = child;
+    updateRange(parent);
+
     delete range;
     return next;
 }
 
+/*!
+    Updates the group counts of the tree nodes from \a range to the root after the count or
+    flags of \a range have changed.
+*/
+
+inline void QQmlListCompositor::updateRange(Range *range)
+{
+    for (; range; range = range->parent)
+        qt_countSubtree(range);
+}
+
+/*!
+    Rotates \a range into the position of its parent in the tree, without changing the order
+    of ranges.
+*/
+
+inline void QQmlListCompositor::rotateUp(Range *range)
+{
+    Range *parent = range->parent;
+    Range *grandParent = parent->parent;
+    if (parent->left == range) {
+        parent->left = range->right;
+        if (range->right)
+            range->right->parent = parent;
+        range->right = parent;
+    } else {
+        parent->right = range->left;
+        if (range->left)
+            range->left->parent = parent;
+        range->left = parent;
+    }
+    parent->parent = range;
+    range->parent = grandParent;
+    if (!grandParent)
+        m_root = range;
+    else if (grandParent->left == parent)
+        grandParent->left = range;
+    else
+        grandParent->right = range;
+
+    qt_countSubtree(parent);
+    qt_countSubtree(range);
+}
+
 /*!
     Sets the number (\a count) of possible groups that items may belong to in a compositor.
 */
@@ -327,13 +429,17 @@ QQmlListCompositor::iterator QQmlListCompositor::find(Group group, int index)
 {
     QT_QML_TRACE_LISTCOMPOSITOR(<< group << index)
     Q_ASSERT(index >=0 && index < count(group));
-    if (m_cacheIt == m_end) {
-        m_cacheIt = iterator(m_ranges.next, 0, group, m_groupCount);
-        m_cacheIt += index;
-    } else {
-        const int offset = index - m_cacheIt.index[group];
+    const int offset = index - m_cacheIt.index[group];
+    if (m_cacheIt != m_end
+            && m_cacheIt->inGroup(group)
+            && m_cacheIt.offset + offset >= 0
+            && m_cacheIt.offset + offset < m_cacheIt->count) {
+        // Successive lookups are frequently within the same range, so just move the offset.
+        m_cacheIt.incrementIndexes(offset);
+        m_cacheIt.offset += offset;
         m_cacheIt.setGroup(group);
-        m_cacheIt += offset;
+    } else {
+        m_cacheIt = findInTree(group, index);
     }
     Q_ASSERT(m_cacheIt.index[group] == index);
     Q_ASSERT(m_cacheIt->inGroup(group));
@@ -369,19 +475,80 @@ QQmlListCompositor::insert_iterator QQmlListCompositor::findInsertPosition(Group
     QT_QML_TRACE_LISTCOMPOSITOR(<< group << index)
     Q_ASSERT(index >=0 && index <= count(group));
     insert_iterator it;
-    if (m_cacheIt == m_end) {
-        it = iterator(m_ranges.next, 0, group, m_groupCount);
-        it += index;
-    } else {
-        const int offset = index - m_cacheIt.index[group];
+    const int offset = index - m_cacheIt.index[group];
+    if (m_cacheIt != m_end
+            && m_cacheIt->inGroup(group)
+            && m_cacheIt.offset + offset > 0
+            && m_cacheIt.offset + offset < m_cacheIt->count) {
         it = m_cacheIt;
+        it.incrementIndexes(offset);
+        it.offset += offset;
         it.setGroup(group);
-        it += offset;
+    } else {
+        it = findInsertPositionInTree(group, index);
     }
     Q_ASSERT(it.index[group] == index);
     return it;
 }
 
+/*!
+    \internal
+
+    Returns an iterator representing the item at \a index in a \a group, or the end of the
+    compositor if \a index is equal to count(group), by descending the tree of ranges.
+
+    This doesn't depend on the cached iterator so it can be used while that is invalid.
+*/
+
+QQmlListCompositor::iterator QQmlListCompositor::findInTree(Group group, int index) const
+{
+    iterator it(const_cast<Range *>(&m_ranges), 0, group, m_groupCount);
+    for (Range *range = m_root; range;) {
+        if (Range *left = range->left) {
+            if (index < left->subtreeCounts[group]) {
+                range = left;
+                continue;
+            }
+            index -= left->subtreeCounts[group];
+            for (int i = 0; i < m_groupCount; ++i)
+                it.index[i] += left->subtreeCounts[i];
+        }
+        if (range->inGroup(group)) {
+            if (index < range->count) {
+                it.range = range;
+                it.offset = index;
+                it.incrementIndexes(index);
+                break;
+            }
+            index -= range->count;
+        }
+        it.incrementIndexes(range->count, range->flags);
+        range = range->right;
+    }
+    return it;
+}
+
+/*!
+    \internal
+
+    Returns an iterator representing an insert position in front of the item at \a index in a
+    \a group by descending the tree of ranges.
+*/
+
+QQmlListCompositor::insert_iterator QQmlListCompositor::findInsertPositionInTree(
+        Group group, int index) const
+{
+    insert_iterator it = findInTree(group, index);
+
+    // If the previous range contains the append flag move the iterator to the tail of the previous
+    // range so that appended appear after the insert position.
+    if (it.offset == 0 && it->previous->append()) {
+        *it = it->previous;
+        it.offset = it->inGroup() ? it->count : 0;
+    }
+    return it;
+}
+
 /*!
     Appends a range of \a count indexes starting at \a index from a \a list into a compositor
     with the given \a flags.
@@ -434,6 +601,7 @@ QQmlListCompositor::iterator QQmlListCompositor::insert(
                 *before, before->list, before->index, before.offset, before->flags & ~AppendFlag)->next;
         before->index += before.offset;
         before->count -= before.offset;
+        updateRange(*before);
         before.offset = 0;
     }
 
@@ -445,6 +613,7 @@ QQmlListCompositor::iterator QQmlListCompositor::insert(
         // The insert arguments represent a continuation of the previous range so increment
         // its count instead of inserting a new range.
         before->previous->count += count;
+        updateRange(before->previous);
         before.incrementIndexes(count, flags);
     } else {
         *before = insert(*before, list, index, count, flags);
@@ -458,6 +627,7 @@ QQmlListCompositor::iterator QQmlListCompositor::insert(
         // The current range and the next are continuous so add their counts and delete one.
         before->next->index = before->index;
         before->next->count += before->count;
+        updateRange(before->next);
         *before = erase(*before);
     }
 
@@ -505,6 +675,7 @@ void QQmlListCompositor::setFlags(
         *from = insert(*from, from->list, from->index, from.offset, from->flags & ~AppendFlag)->next;
         from->index += from.offset;
         from->count -= from.offset;
+        updateRange(*from);
         from.offset = 0;
     }
 
@@ -533,8 +704,10 @@ void QQmlListCompositor::setFlags(
             // If the additional flags make the current range a continuation of the previous
             // then move the affected items over to the previous range.
             from->previous->count += difference;
+            updateRange(from->previous);
             from->index += difference;
             from->count -= difference;
+            updateRange(*from);
             if (from->count == 0) {
                 // Delete the current range if it is now empty, preserving the append flag
                 // in the previous range.
@@ -555,9 +728,11 @@ void QQmlListCompositor::setFlags(
             *from = insert(*from, from->list, from->index, difference, setFlags)->next;
             from->index += difference;
             from->count -= difference;
+            updateRange(*from);
         } else {
             // The whole range is affected so simply update the flags.
             from->flags |= flags;
+            updateRange(*from);
             continue;
         }
         from.incrementIndexes(from->count);
@@ -571,6 +746,7 @@ void QQmlListCompositor::setFlags(
         from.offset = from->previous->count;
         from->previous->count += from->count;
         from->previous->flags = from->flags;
+        updateRange(from->previous);
         *from = erase(*from)->previous;
     }
     m_cacheIt = from;
@@ -617,6 +793,7 @@ void QQmlListCompositor::clearFlags(
         *from = insert(*from, from->list, from->index, from.offset, from->flags & ~AppendFlag)->next;
         from->index += from.offset;
         from->count -= from.offset;
+        updateRange(*from);
         from.offset = 0;
     }
 
@@ -651,8 +828,10 @@ void QQmlListCompositor::clearFlags(
             // If the removed flags make the current range a continuation of the previous
             // then move the affected items over to the previous range.
             from->previous->count += difference;
+            updateRange(from->previous);
             from->index += difference;
             from->count -= difference;
+            updateRange(*from);
             if (from->count == 0) {
                 // Delete the current range if it is now empty, preserving the append flag
                 if (from->append())
@@ -668,10 +847,12 @@ void QQmlListCompositor::clearFlags(
                 *from = insert(*from, from->list, from->index, difference, clearedFlags)->next;
             from->index += difference;
             from->count -= difference;
+            updateRange(*from);
             from.incrementIndexes(from->count);
         } else if (clearedFlags) {
             // The whole range is affected so simply update the flags.
             from->flags &= ~flags;
+            updateRange(*from);
         } else {
             // All flags have been removed from the range so remove it.
             *from = erase(*from)->previous;
@@ -686,6 +867,7 @@ void QQmlListCompositor::clearFlags(
         from.offset = from->previous->count;
         from->previous->count += from->count;
         from->previous->flags = from->flags;
+        updateRange(from->previous);
         *from = erase(*from)->previous;
     }
     m_cacheIt = from;
@@ -759,6 +941,7 @@ void QQmlListCompositor::move(
                 *fromIt, fromIt->list, fromIt->index, fromIt.offset, fromIt->flags & ~AppendFlag)->next;
         fromIt->index += fromIt.offset;
         fromIt->count -= fromIt.offset;
+        updateRange(*fromIt);
         fromIt.offset = 0;
     }
 
@@ -785,6 +968,7 @@ void QQmlListCompositor::move(
             removes->append(Remove(fromIt, difference, fromIt->flags, ++moveId));
         count -= difference;
         fromIt->count -= difference;
+        updateRange(*fromIt);
 
         // If the existing range contains the prepend flag replace the removed items with
         // a placeholder range for new items inserted into the source model.
@@ -796,6 +980,7 @@ void QQmlListCompositor::move(
                 && fromIt->previous->end() == fromIt->index) {
             // Grow the previous range instead of creating a new one if possible.
             fromIt->previous->count += difference;
+            updateRange(fromIt->previous);
         } else if (fromIt->prepend()) {
             *fromIt = insert(*fromIt, fromIt->list, removeIndex, difference, PrependFlag)->next;
         }
@@ -815,6 +1000,7 @@ void QQmlListCompositor::move(
                     && fromIt->previous->end() == fromIt->index) {
                 fromIt.incrementIndexes(fromIt->count);
                 fromIt->previous->count += fromIt->count;
+                updateRange(fromIt->previous);
                 *fromIt = erase(*fromIt);
             }
         } else if (count > 0) {
@@ -833,15 +1019,12 @@ void QQmlListCompositor::move(
         fromIt.offset = fromIt->previous->count;
         fromIt->previous->count += fromIt->count;
         fromIt->previous->flags = fromIt->flags;
+        updateRange(fromIt->previous);
         *fromIt = erase(*fromIt)->previous;
     }
 
     // Find the destination position of the move.
-    insert_iterator toIt = fromIt;
-    toIt.setGroup(toGroup);
-
-    const int difference = to - toIt.index[toGroup];
-    toIt += difference;
+    insert_iterator toIt = findInsertPositionInTree(toGroup, to);
 
     // If the insert position is part way through a range; split it and move the iterator to the
     // start of the second range.
@@ -849,6 +1032,7 @@ void QQmlListCompositor::move(
         *toIt = insert(*toIt, toIt->list, toIt->index, toIt.offset, toIt->flags & ~AppendFlag)->next;
         toIt->index += toIt.offset;
         toIt->count -= toIt.offset;
+        updateRange(*toIt);
         toIt.offset = 0;
     }
 
@@ -861,6 +1045,7 @@ void QQmlListCompositor::move(
                 && range->flags == (toIt->flags & ~AppendFlag)) {
             toIt->index -= range->count;
             toIt->count += range->count;
+            updateRange(*toIt);
         } else {
             *toIt = insert(*toIt, range->list, range->index, range->count, range->flags);
         }
@@ -873,6 +1058,7 @@ void QQmlListCompositor::move(
         toIt.offset = toIt->previous->count;
         toIt->previous->count += toIt->count;
         toIt->previous->flags = toIt->flags;
+        updateRange(toIt->previous);
         *toIt = erase(*toIt)->previous;
     }
     // Create insert notification for the ranges moved.
@@ -962,6 +1148,7 @@ void QQmlListCompositor::listItemsInserted(
                         // Accumulate items on the current range it its flags are the same as
                         // the insert flags.
                         it->count += insertion.count;
+                        updateRange(*it);
                     } else if (offset == 0
                             && it->previous != &m_ranges
                             && it->previous->list == list
@@ -970,6 +1157,7 @@ void QQmlListCompositor::listItemsInserted(
                         // Attempt to append to the previous range if the insert position is at
                         // the start of the current range.
                         it->previous->count += insertion.count;
+                        updateRange(it->previous);
                         it->index += insertion.count;
                         it.incrementIndexes(insertion.count);
                     } else {
@@ -983,6 +1171,7 @@ void QQmlListCompositor::listItemsInserted(
                         it.incrementIndexes(insertion.count, flags);
                         it->index += offset + insertion.count;
                         it->count -= offset;
+                        updateRange(*it);
                     }
                     m_end.incrementIndexes(insertion.count, flags);
                 } else {
@@ -992,6 +1181,7 @@ void QQmlListCompositor::listItemsInserted(
                         *it = insert(*it, it->list, it->index, offset, it->flags)->next;
                         it->index += offset;
                         it->count -= offset;
+                        updateRange(*it);
                     }
                     it->index += insertion.count;
                 }
@@ -1058,6 +1248,7 @@ void QQmlListCompositor::listItemsRemoved(
                 const int offset = qMax(0, relativeIndex);
                 int removeCount = qMin(it->count, relativeIndex + removal->count) - offset;
                 it->count -= removeCount;
+                updateRange(*it);
                 int removeFlags = it->flags & m_removeFlags;
                 Remove translatedRemoval(it, removeCount, it->flags);
                 for (int i = 0; i < m_groupCount; ++i) {
@@ -1121,6 +1312,7 @@ void QQmlListCompositor::listItemsRemoved(
                             *it = insert(*it, it->list, it->index, offset, it->flags & ~AppendFlag)->next;
                             it->index += offset;
                             it->count -= offset;
+                            updateRange(*it);
                             it.incrementIndexes(offset);
                         }
                         if (it->previous != &m_ranges
@@ -1128,6 +1320,7 @@ void QQmlListCompositor::listItemsRemoved(
                                 && it->end() == insertion->index
                                 && it->previous->flags == (it->flags | MovedFlag)) {
                             it->previous->count += removeCount;
+                            updateRange(it->previous);
                         } else {
                             *it = insert(*it, it->list, insertion->index, removeCount, it->flags | MovedFlag)->next;
                         }
@@ -1143,12 +1336,14 @@ void QQmlListCompositor::listItemsRemoved(
                         *it = insert(*it, it->list, it->index, offset, it->flags & ~AppendFlag)->next;
                         it->index += offset;
                         it->count -= offset;
+                        updateRange(*it);
                         it.incrementIndexes(offset);
                     }
                     if (it->previous != &m_ranges
                             && it->previous->list == it->list
                             && it->previous->flags == CacheFlag) {
                         it->previous->count += removeCount;
+                        updateRange(it->previous);
                     } else {
                         *it = insert(*it, it->list, -1, removeCount, CacheFlag)->next;
                     }
@@ -1179,6 +1374,7 @@ void QQmlListCompositor::listItemsRemoved(
                     it.decrementIndexes(it->previous->count);
                     it->previous->count += it->count;
                     it->previous->flags = it->flags;
+                    updateRange(it->previous);
                     *it = erase(*it)->previous;
                 }
             }
@@ -1187,6 +1383,7 @@ void QQmlListCompositor::listItemsRemoved(
             // Compress consecutive cache only ranges.
             it.index[Cache] += it->next->count;
             it->count += it->next->count;
+            updateRange(*it);
             erase(it->next);
         } else if (!removed) {
             it.incrementIndexes(it->count);
@@ -63,6 +63,14 @@ public:
         int count = 0;
         uint flags = 0;
 
+        // Order statistics tree of ranges, each node holds the per group item count of its
+        // subtree so a group index can be translated without iterating over all ranges.
+        Range *parent = nullptr;
+        Range *left = nullptr;
+        Range *right = nullptr;
+        uint priority = 0;
+        int subtreeCounts[MaximumGroupCount] = { 0 };
+
         inline int start() const { return index; }
         inline int end() const { return index + count; }
 
@@ -234,16 +242,23 @@ public:
 
 private:
     Range m_ranges;
+    Range *m_root = nullptr;
     iterator m_end;
     iterator m_cacheIt;
     int m_groupCount;
     int m_defaultFlags;
     int m_removeFlags;
     int m_moveId;
+    uint m_priorityState = 0x9e3779b9;
 
     inline Range *insert(Range *before, void *list, int index, int count, uint flags);
     inline Range *erase(Range *range);
 
+    inline void updateRange(Range *range);
+    inline void rotateUp(Range *range);
+    iterator findInTree(Group group, int index) const;
+    insert_iterator findInsertPositionInTree(Group group, int index) const;
+
     struct MovedFlags
     {
         MovedFlags() {}
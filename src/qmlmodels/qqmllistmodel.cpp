@@ -29,6 +29,8 @@
 #include <QtCore/qdatetime.h>
 #include <QScopedValueRollback>
 
+#include <new>
+
 Q_DECLARE_METATYPE(const QV4::CompiledData::Binding*);
 
 QT_BEGIN_NAMESPACE
@@ -400,7 +402,7 @@ bool ListModel::sync(ListModel *src, ListModel *target)
         Q_ASSERT(s.srcIndex >= 0);
         ListElement *targetElement = s.target;
         if (targetElement == nullptr) {
-            targetElement = new ListElement(srcElement->getUid());
+            targetElement = new (target->elementPool()) ListElement(srcElement->getUid());
         }
         s.changedRoles = ListElement::sync(srcElement, src->m_layout, targetElement, target->m_layout);
         target->elements.append(targetElement);
@@ -469,7 +471,10 @@ bool ListModel::sync(ListModel *src, ListModel *target)
     return hasChanges;
 }
 
-ListModel::ListModel(ListLayout *layout, QQmlListModel *modelCache) : m_layout(layout), m_modelCache(modelCache)
+ListModel::ListModel(ListLayout *layout, QQmlListModel *modelCache, ListElementPool *elementPool)
+    : m_layout(layout)
+    , m_elementPool(elementPool ? elementPool : new ListElementPool)
+    , m_modelCache(modelCache)
 {
 }
 
@@ -521,7 +526,7 @@ void ListModel::move(int from, int to, int n)
 
 void ListModel::newElement(int index)
 {
-    ListElement *e = new ListElement;
+    ListElement *e = new (elementPool()) ListElement;
     elements.insert(index, e);
 }
 
@@ -593,7 +598,7 @@ void ListModel::set(int elementIndex, QV4::Object *object, QVector<int> *roles)
             roleIndex = e->setDoubleProperty(r, propertyValue->asDouble());
         } else if (QV4::ArrayObject *a = propertyValue->as<QV4::ArrayObject>()) {
             const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::List);
-            ListModel *subModel = new ListModel(r.subLayout, nullptr);
+            ListModel *subModel = new ListModel(r.subLayout, nullptr, elementPool());
 
             int arrayLength = a->getLength();
             for (int j=0 ; j < arrayLength ; ++j) {
@@ -651,7 +656,8 @@ void ListModel::set(int elementIndex, QV4::Object *object, QVector<int> *roles)
         mo->updateValues(*roles);
 }
 
-void ListModel::set(int elementIndex, QV4::Object *object, ListModel::SetElement reason)
+void ListModel::set(int elementIndex, QV4::Object *object, ListModel::SetElement reason,
+                    RoleCache *cache)
 {
     if (!object)
         return;
@@ -660,87 +666,151 @@ void ListModel::set(int elementIndex, QV4::Object *object, ListModel::SetElement
 
     QV4::ExecutionEngine *v4 = object->engine();
     QV4::Scope scope(v4);
-
-    QV4::ObjectIterator it(scope, object, QV4::ObjectIterator::EnumerableOnly);
     QV4::ScopedString propertyName(scope);
     QV4::ScopedValue propertyValue(scope);
-    QV4::ScopedObject o(scope);
+
+    // Plain objects of the same shape keep their properties in the same slots, so
+    // when adding many of them the roles only need to be looked up once per shape.
+    if (cache && cache->update(object)) {
+        const QV4::Heap::InternalClass *ic = object->internalClass();
+        for (uint i = 0; i < ic->size; ++i) {
+            RoleCache::Slot &slot = cache->slots[i];
+            if (!slot.isRole)
+                continue;
+            propertyName = ic->nameMap.at(i).asStringOrSymbol();
+            propertyValue = *object->propertyData(i);
+            setElementProperty(e, propertyName, propertyValue, reason, &slot.role);
+        }
+        return;
+    }
+
+    QV4::ObjectIterator it(scope, object, QV4::ObjectIterator::EnumerableOnly);
     while (1) {
         propertyName = it.nextPropertyNameAsString(propertyValue);
         if (!propertyName)
             break;
 
-        // Add the value now
-        if (QV4::String *s = propertyValue->stringValue()) {
-            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::String);
-            if (r.type == ListLayout::Role::String)
-                e->setStringPropertyFast(r, s->toQString());
-        } else if (propertyValue->isNumber()) {
-            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::Number);
-            if (r.type == ListLayout::Role::Number) {
-                e->setDoublePropertyFast(r, propertyValue->asDouble());
-            }
-        } else if (QV4::ArrayObject *a = propertyValue->as<QV4::ArrayObject>()) {
-            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::List);
-            if (r.type == ListLayout::Role::List) {
-                ListModel *subModel = new ListModel(r.subLayout, nullptr);
+        setElementProperty(e, propertyName, propertyValue, reason, nullptr);
+    }
+}
 
-                int arrayLength = a->getLength();
-                for (int j=0 ; j < arrayLength ; ++j) {
-                    o = a->get(j);
-                    subModel->append(o);
-                }
+bool ListModel::RoleCache::update(QV4::Object *object)
+{
+    if (object->vtable() != QV4::Object::staticVTable() || object->arrayData())
+        return false;
 
-                e->setListPropertyFast(r, subModel);
-            }
-        } else if (propertyValue->isBoolean()) {
-            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::Bool);
-            if (r.type == ListLayout::Role::Bool) {
-                e->setBoolPropertyFast(r, propertyValue->booleanValue());
-            }
-        } else if (QV4::DateObject *date = propertyValue->as<QV4::DateObject>()) {
-            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::DateTime);
-            if (r.type == ListLayout::Role::DateTime) {
-                QDateTime dt = date->toQDateTime();
-                e->setDateTimePropertyFast(r, dt);
-            }
-        } else if (QV4::UrlObject *url = propertyValue->as<QV4::UrlObject>()){
-            const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::Url);
-            if (r.type == ListLayout::Role::Url) {
-                QUrl qurl = QUrl(url->href()); // does what the private UrlObject->toQUrl would do
-                e->setUrlPropertyFast(r, qurl);
-            }
-        } else if (QV4::Object *o = propertyValue->as<QV4::Object>()) {
-            if (QV4::QObjectWrapper *wrapper = o->as<QV4::QObjectWrapper>()) {
-                const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::QObject);
-                if (r.type == ListLayout::Role::QObject)
-                    e->setQObjectPropertyFast(r, wrapper);
-            } else {
-                QVariant maybeUrl = QV4::ExecutionEngine::toVariant(
-                            o->asReturnedValue(), QMetaType::fromType<QUrl>(), true);
-                if (maybeUrl.metaType() == QMetaType::fromType<QUrl>()) {
-                    const QUrl qurl = maybeUrl.toUrl();
-                    const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::Url);
-                    if (r.type == ListLayout::Role::Url)
-                        e->setUrlPropertyFast(r, qurl);
-                } else {
-                    const ListLayout::Role &role = m_layout->getRoleOrCreate(propertyName, ListLayout::Role::VariantMap);
-                    if (role.type == ListLayout::Role::VariantMap)
-                        e->setVariantMapFast(role, o);
-                }
+    QV4::Heap::InternalClass *ic = object->internalClass();
+    if (ic == internalClass)
+        return usable;
+
+    internalClass = ic;
+    usable = true;
+    slots.resize(ic->size);
+    for (uint i = 0; i < ic->size; ++i) {
+        const QV4::PropertyKey key = ic->nameMap.at(i);
+        const QV4::PropertyAttributes attributes = ic->propertyData.at(i);
+        slots[i].role = nullptr;
+        slots[i].isRole = false;
+        if (!key.isStringOrSymbol())
+            continue;
+        if (attributes.isAccessor()) {
+            // Would need to call the getter; leave that to ObjectIterator
+            usable = false;
+            return false;
+        }
+        slots[i].isRole = key.isString() && attributes.isEnumerable()
+                && ic->find(key).index == i;
+    }
+    return true;
+}
+
+void ListModel::setElementProperty(ListElement *e, QV4::String *propertyName,
+                                   const QV4::Value &value, SetElement reason,
+                                   const ListLayout::Role **cachedRole)
+{
+    QV4::Scope scope(propertyName->engine());
+    QV4::ScopedValue propertyValue(scope, value);
+    QV4::ScopedObject o(scope);
+
+    auto roleFor = [&](ListLayout::Role::DataType type) -> const ListLayout::Role & {
+        if (cachedRole && *cachedRole && (*cachedRole)->type == type)
+            return **cachedRole;
+        const ListLayout::Role &r = m_layout->getRoleOrCreate(propertyName, type);
+        if (cachedRole)
+            *cachedRole = &r;
+        return r;
+    };
+
+    // Add the value now
+    if (QV4::String *s = propertyValue->stringValue()) {
+        const ListLayout::Role &r = roleFor(ListLayout::Role::String);
+        if (r.type == ListLayout::Role::String)
+            e->setStringPropertyFast(r, s->toQString());
+    } else if (propertyValue->isNumber()) {
+        const ListLayout::Role &r = roleFor(ListLayout::Role::Number);
+        if (r.type == ListLayout::Role::Number) {
+            e->setDoublePropertyFast(r, propertyValue->asDouble());
+        }
+    } else if (QV4::ArrayObject *a = propertyValue->as<QV4::ArrayObject>()) {
+        const ListLayout::Role &r = roleFor(ListLayout::Role::List);
+        if (r.type == ListLayout::Role::List) {
+            ListModel *subModel = new ListModel(r.subLayout, nullptr, elementPool());
+
+            int arrayLength = a->getLength();
+            for (int j=0 ; j < arrayLength ; ++j) {
+                o = a->get(j);
+                subModel->append(o);
             }
-        } else if (propertyValue->isNullOrUndefined()) {
-            if (reason == SetElement::WasJustInserted) {
-                QQmlError err;
-                auto memberName = propertyName->toString(v4)->toQString();
-                err.setDescription(QString::fromLatin1("%1 is %2. Adding an object with a %2 member does not create a role for it.").arg(memberName, propertyValue->isNull() ? QLatin1String("null") : QLatin1String("undefined")));
-                qmlWarning(nullptr, err);
+
+            e->setListPropertyFast(r, subModel);
+        }
+    } else if (propertyValue->isBoolean()) {
+        const ListLayout::Role &r = roleFor(ListLayout::Role::Bool);
+        if (r.type == ListLayout::Role::Bool) {
+            e->setBoolPropertyFast(r, propertyValue->booleanValue());
+        }
+    } else if (QV4::DateObject *date = propertyValue->as<QV4::DateObject>()) {
+        const ListLayout::Role &r = roleFor(ListLayout::Role::DateTime);
+        if (r.type == ListLayout::Role::DateTime) {
+            QDateTime dt = date->toQDateTime();
+            e->setDateTimePropertyFast(r, dt);
+        }
+    } else if (QV4::UrlObject *url = propertyValue->as<QV4::UrlObject>()){
+        const ListLayout::Role &r = roleFor(ListLayout::Role::Url);
+        if (r.type == ListLayout::Role::Url) {
+            QUrl qurl = QUrl(url->href()); // does what the private UrlObject->toQUrl would do
+            e->setUrlPropertyFast(r, qurl);
+        }
+    } else if (QV4::Object *o = propertyValue->as<QV4::Object>()) {
+        if (QV4::QObjectWrapper *wrapper = o->as<QV4::QObjectWrapper>()) {
+            const ListLayout::Role &r = roleFor(ListLayout::Role::QObject);
+            if (r.type == ListLayout::Role::QObject)
+                e->setQObjectPropertyFast(r, wrapper);
+        } else {
+            QVariant maybeUrl = QV4::ExecutionEngine::toVariant(
+                        o->asReturnedValue(), QMetaType::fromType<QUrl>(), true);
+            if (maybeUrl.metaType() == QMetaType::fromType<QUrl>()) {
+                const QUrl qurl = maybeUrl.toUrl();
+                const ListLayout::Role &r = roleFor(ListLayout::Role::Url);
+                if (r.type == ListLayout::Role::Url)
+                    e->setUrlPropertyFast(r, qurl);
             } else {
-                const ListLayout::Role *r = m_layout->getExistingRole(propertyName);
-                if (r)
-                    e->clearProperty(*r);
+                const ListLayout::Role &role = roleFor(ListLayout::Role::VariantMap);
+                if (role.type == ListLayout::Role::VariantMap)
+                    e->setVariantMapFast(role, o);
             }
         }
+    } else if (propertyValue->isNullOrUndefined()) {
+        if (reason == SetElement::WasJustInserted) {
+            QQmlError err;
+            auto memberName = propertyName->toQString();
+            err.setDescription(QString::fromLatin1("%1 is %2. Adding an object with a %2 member does not create a role for it.").arg(memberName, propertyValue->isNull() ? QLatin1String("null") : QLatin1String("undefined")));
+            qmlWarning(nullptr, err);
+        } else {
+            const ListLayout::Role *r = m_layout->getExistingRole(propertyName);
+            if (r)
+                e->clearProperty(*r);
+        }
     }
 }
 
@@ -760,19 +830,41 @@ QVector<std::function<void()>> ListModel::remove(int index, int count)
     return toDestroy;
 }
 
-void ListModel::insert(int elementIndex, QV4::Object *object)
+void ListModel::insert(int elementIndex, QV4::Object *object, RoleCache *cache)
 {
     insertElement(elementIndex);
-    set(elementIndex, object, SetElement::WasJustInserted);
+    set(elementIndex, object, SetElement::WasJustInserted, cache);
 }
 
-int ListModel::append(QV4::Object *object)
+int ListModel::append(QV4::Object *object, RoleCache *cache)
 {
     int elementIndex = appendElement();
-    set(elementIndex, object, SetElement::WasJustInserted);
+    set(elementIndex, object, SetElement::WasJustInserted, cache);
     return elementIndex;
 }
 
+void ListModel::appendColumns(QV4::ExecutionEngine *v4, const QV4::Value *names,
+                              const QV4::Value *columns, int columnCount, int rowCount)
+{
+    QV4::Scope scope(v4);
+    QV4::ScopedString propertyName(scope);
+    QV4::ScopedObject column(scope);
+    QV4::ScopedValue propertyValue(scope);
+    QVarLengthArray<const ListLayout::Role *, 16> roles(columnCount, nullptr);
+
+    elements.reserve(elements.count() + rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        ListElement *e = elements[appendElement()];
+        for (int i = 0; i < columnCount; ++i) {
+            propertyName = names[i];
+            column = columns[i];
+            propertyValue = column->get(uint(row));
+            setElementProperty(e, propertyName, propertyValue, SetElement::WasJustInserted,
+                               &roles[i]);
+        }
+    }
+}
+
 int ListModel::setOrCreateProperty(int elementIndex, const QString &key, const QVariant &data)
 {
     int roleIndex = -1;
@@ -814,7 +906,7 @@ inline char *ListElement::getPropertyMemory(const ListLayout::Role &role)
     int blockIndex = 0;
     while (blockIndex < role.blockIndex) {
         if (e->next == nullptr) {
-            e->next = new ListElement;
+            e->next = new (ListElementPool::owner(e)) ListElement;
             e->next->uid = uid;
         }
         e = e->next;
@@ -1294,6 +1386,190 @@ void ListElement::clearProperty(const ListLayout::Role &role)
     }
 }
 
+/*
+    A model row consists of one or more ListElement blocks, depending on how
+    many roles the layout has. Allocating each of them separately fragments
+    large models into hundreds of thousands of small heap blocks, so they are
+    instead carved out of slabs.
+
+    A slab consists of one or more 1 KiB segments and is aligned to the
+    segment size. Each segment starts with a header pointing to its slab, so
+    the slab of a block, and through it the owning pool, is found by masking
+    the block's address. The first segment's header is the slab itself.
+
+    Each model owns a pool, shared with the models nested in its list roles.
+    A model and its nested models are only ever used from one thread at a
+    time, so the pool is not synchronized. Slabs are only allocated once the
+    first block is needed. The first slab of a pool is a single segment, so
+    that small models stay small, and the following ones double in size up
+    to four segments. Slabs are released as soon as they become empty, and
+    all of them go away with the model.
+*/
+struct ListElementPool::FreeBlock
+{
+    FreeBlock *next;
+};
+
+struct ListElementPool::Segment
+{
+    Slab *slab = nullptr;
+};
+
+struct ListElementPool::Slab : Segment
+{
+    ListElementPool *pool = nullptr;
+    Slab *prev = nullptr;
+    Slab *next = nullptr;
+    FreeBlock *freeList = nullptr;
+    int used = 0;
+    int bumpIndex = 0;
+    int segmentCount = 0;
+
+    static constexpr size_t HeaderSize()
+    {
+        return (sizeof(Slab) + alignof(ListElement) - 1) & ~(alignof(ListElement) - 1);
+    }
+    static constexpr int BlocksPerSegment()
+    {
+        return int((SegmentSize - HeaderSize()) / sizeof(ListElement));
+    }
+
+    int blockCount() const { return segmentCount * BlocksPerSegment(); }
+
+    void *blockAt(int index)
+    {
+        return reinterpret_cast<char *>(this) + (index / BlocksPerSegment()) * SegmentSize
+                + HeaderSize() + (index % BlocksPerSegment()) * sizeof(ListElement);
+    }
+};
+
+static QBasicAtomicInteger<qsizetype> listElementSlabBytes = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+ListElementPool::~ListElementPool()
+{
+    // Only slabs with free blocks are tracked. Full ones can only remain if
+    // elements were leaked, in which case so are their slabs.
+    while (Slab *slab = partialSlabs) {
+        unlink(slab);
+        destroy(slab);
+    }
+}
+
+ListElementPool *ListElementPool::owner(const void *block)
+{
+    return slabOf(block)->pool;
+}
+
+qsizetype ListElementPool::allocatedBytes()
+{
+    return listElementSlabBytes.loadRelaxed();
+}
+
+ListElementPool::Slab *ListElementPool::slabOf(const void *block)
+{
+    return reinterpret_cast<const Segment *>(quintptr(block) & ~quintptr(SegmentSize - 1))->slab;
+}
+
+void *ListElementPool::allocate()
+{
+    static_assert(Slab::BlocksPerSegment() > 1);
+
+    Slab *slab = partialSlabs;
+    if (!slab) {
+        const int segmentCount = slabCount < 2 ? 1 << slabCount : int(MaximumSegmentsPerSlab);
+        const size_t size = size_t(segmentCount) * SegmentSize;
+        char *memory = static_cast<char *>(::operator new(size, std::align_val_t(SegmentSize)));
+        slab = new (memory) Slab;
+        slab->slab = slab;
+        for (int i = 1; i < segmentCount; ++i)
+            (new (memory + i * SegmentSize) Segment)->slab = slab;
+        slab->pool = this;
+        slab->segmentCount = segmentCount;
+        ++slabCount;
+        listElementSlabBytes.fetchAndAddRelaxed(qsizetype(size));
+        link(slab);
+    }
+
+    void *block;
+    if (slab->freeList) {
+        block = slab->freeList;
+        slab->freeList = slab->freeList->next;
+    } else {
+        block = slab->blockAt(slab->bumpIndex++);
+    }
+
+    if (++slab->used == slab->blockCount())
+        unlink(slab);
+    return block;
+}
+
+void ListElementPool::release(void *block)
+{
+    Slab *slab = slabOf(block);
+    ListElementPool *pool = slab->pool;
+    if (slab->used-- == slab->blockCount())
+        pool->link(slab);
+
+    if (slab->used == 0) {
+        pool->unlink(slab);
+        destroy(slab);
+        return;
+    }
+
+    FreeBlock *freeBlock = static_cast<FreeBlock *>(block);
+    freeBlock->next = slab->freeList;
+    slab->freeList = freeBlock;
+}
+
+void ListElementPool::link(Slab *slab)
+{
+    slab->prev = nullptr;
+    slab->next = partialSlabs;
+    if (partialSlabs)
+        partialSlabs->prev = slab;
+    partialSlabs = slab;
+}
+
+void ListElementPool::unlink(Slab *slab)
+{
+    if (slab->prev)
+        slab->prev->next = slab->next;
+    else
+        partialSlabs = slab->next;
+    if (slab->next)
+        slab->next->prev = slab->prev;
+    slab->prev = slab->next = nullptr;
+}
+
+void ListElementPool::destroy(Slab *slab)
+{
+    const size_t size = size_t(slab->segmentCount) * SegmentSize;
+    --slab->pool->slabCount;
+    listElementSlabBytes.fetchAndSubRelaxed(qsizetype(size));
+    slab->~Slab();
+    ::operator delete(slab, std::align_val_t(SegmentSize));
+}
+
+void *ListElement::operator new(size_t size, ListElementPool *pool)
+{
+    Q_ASSERT(size == sizeof(ListElement));
+    Q_UNUSED(size);
+    return pool->allocate();
+}
+
+void ListElement::operator delete(void *ptr, ListElementPool *)
+{
+    ListElementPool::release(ptr);
+}
+
+void ListElement::operator delete(void *ptr, size_t size)
+{
+    Q_ASSERT(size == sizeof(ListElement));
+    Q_UNUSED(size);
+    if (ptr)
+        ListElementPool::release(ptr);
+}
+
 ListElement::ListElement()
 {
     m_objectCache = nullptr;
@@ -1331,7 +1607,8 @@ QVector<int> ListElement::sync(ListElement *src, ListLayout *srcLayout, ListElem
 
                     if (srcSubModel) {
                         if (targetSubModel == nullptr) {
-                            targetSubModel = new ListModel(targetRole.subLayout, nullptr);
+                            targetSubModel = new ListModel(targetRole.subLayout, nullptr,
+                                                           ListElementPool::owner(target));
                             target->setListPropertyFast(targetRole, targetSubModel);
                         }
                         if (ListModel::sync(srcSubModel, targetSubModel))
@@ -1505,7 +1782,7 @@ int ListElement::setJsProperty(const ListLayout::Role &role, const QV4::Value &d
             QV4::Scope scope(a->engine());
             QV4::ScopedObject o(scope);
 
-            ListModel *subModel = new ListModel(role.subLayout, nullptr);
+            ListModel *subModel = new ListModel(role.subLayout, nullptr, ListElementPool::owner(this));
             int arrayLength = a->getLength();
             for (int j=0 ; j < arrayLength ; ++j) {
                 o = a->get(j);
@@ -2488,6 +2765,7 @@ void QQmlListModel::insert(QQmlV4Function *args)
         QV4::ScopedArrayObject objectArray(scope, (*args)[1]);
         if (objectArray) {
             QV4::ScopedObject argObject(scope);
+            ListModel::RoleCache roleCache;
 
             int objectArrayLength = objectArray->getLength();
             emitItemsAboutToBeInserted(index, objectArrayLength);
@@ -2497,7 +2775,7 @@ void QQmlListModel::insert(QQmlV4Function *args)
                 if (m_dynamicRoles) {
                     m_modelObjects.insert(index+i, DynamicRoleModelNode::create(scope.engine->variantMapFromJS(argObject), this));
                 } else {
-                    m_listModel->insert(index+i, argObject);
+                    m_listModel->insert(index+i, argObject, &roleCache);
                 }
             }
             emitItemsInserted();
@@ -2597,6 +2875,7 @@ void QQmlListModel::append(QQmlV4Function *args)
 
         if (objectArray) {
             QV4::ScopedObject argObject(scope);
+            ListModel::RoleCache roleCache;
 
             int objectArrayLength = objectArray->getLength();
             if (objectArrayLength > 0) {
@@ -2609,7 +2888,7 @@ void QQmlListModel::append(QQmlV4Function *args)
                     if (m_dynamicRoles) {
                         m_modelObjects.append(DynamicRoleModelNode::create(scope.engine->variantMapFromJS(argObject), this));
                     } else {
-                        m_listModel->append(argObject);
+                        m_listModel->append(argObject, &roleCache);
                     }
                 }
 
@@ -2637,6 +2916,89 @@ void QQmlListModel::append(QQmlV4Function *args)
     }
 }
 
+/*!
+    \qmlmethod ListModel::appendColumns(jsobject columns)
+    \since 6.7
+
+    Adds new items to the end of the list model, with the values given
+    column by column. Each property of \a columns names a role and holds an
+    array or typed array with one value per new item. All columns must have
+    the same length.
+
+    \code
+        pointModel.appendColumns({ "x": new Float64Array([0, 1, 2]),
+                                   "y": new Float64Array([4, 2, 0]) })
+    \endcode
+
+    This is equivalent to, but faster than, appending one object per item,
+    in particular for large amounts of numeric data.
+
+    \sa append()
+*/
+void QQmlListModel::appendColumns(QQmlV4Function *args)
+{
+    QV4::Scope scope(args->v4engine());
+    QV4::ScopedObject columnObject(scope, (*args)[0]);
+    if (args->length() != 1 || !columnObject || columnObject->as<QV4::ArrayObject>()) {
+        qmlWarning(this) << tr("appendColumns: value is not an object");
+        return;
+    }
+
+    QV4::ScopedString name(scope);
+    QV4::ScopedValue value(scope);
+    int columnCount = 0;
+    {
+        QV4::ObjectIterator it(scope, columnObject, QV4::ObjectIterator::EnumerableOnly);
+        while ((name = it.nextPropertyNameAsString(value)))
+            ++columnCount;
+    }
+    if (columnCount == 0)
+        return;
+
+    QV4::Value *names = scope.alloc(columnCount);
+    QV4::Value *columns = scope.alloc(columnCount);
+    QV4::ScopedObject column(scope);
+    int rowCount = -1;
+    QV4::ObjectIterator it(scope, columnObject, QV4::ObjectIterator::EnumerableOnly);
+    for (int i = 0; i < columnCount; ++i) {
+        name = it.nextPropertyNameAsString(value);
+        column = value->asReturnedValue();
+        if (!column) {
+            qmlWarning(this) << tr("appendColumns: column %1 is not an array").arg(name->toQString());
+            return;
+        }
+        const int length = int(column->getLength());
+        if (rowCount != -1 && length != rowCount) {
+            qmlWarning(this) << tr("appendColumns: columns differ in length");
+            return;
+        }
+        rowCount = length;
+        names[i] = name;
+        columns[i] = column;
+    }
+
+    if (rowCount <= 0)
+        return;
+
+    const int index = count();
+    emitItemsAboutToBeInserted(index, rowCount);
+    if (m_dynamicRoles) {
+        for (int row = 0; row < rowCount; ++row) {
+            QVariantMap values;
+            for (int i = 0; i < columnCount; ++i) {
+                column = columns[i];
+                value = column->get(uint(row));
+                values.insert(names[i].toQString(),
+                              QV4::ExecutionEngine::toVariant(value, QMetaType()));
+            }
+            m_modelObjects.append(DynamicRoleModelNode::create(values, this));
+        }
+    } else {
+        m_listModel->appendColumns(scope.engine, names, columns, columnCount, rowCount);
+    }
+    emitItemsInserted();
+}
+
 /*!
     \qmlmethod object ListModel::get(int index)
 
@@ -2864,7 +3226,7 @@ bool QQmlListModelParser::applyProperty(
             if (role.type == ListLayout::Role::List) {
                 subModel = model->getListProperty(outterElementIndex, role);
                 if (subModel == nullptr) {
-                    subModel = new ListModel(role.subLayout, nullptr);
+                    subModel = new ListModel(role.subLayout, nullptr, model->elementPool());
                     QVariant vModel = QVariant::fromValue(subModel);
                     model->setOrCreateProperty(outterElementIndex, elementName, vModel);
                 }
@@ -2896,7 +3258,7 @@ bool QQmlListModelParser::applyProperty(
             QString scriptStr = compilationUnit->bindingValueAsScriptString(binding);
             if (definesEmptyList(scriptStr)) {
                 const ListLayout::Role &role = model->getOrCreateListRole(elementName);
-                ListModel *emptyModel = new ListModel(role.subLayout, nullptr);
+                ListModel *emptyModel = new ListModel(role.subLayout, nullptr, model->elementPool());
                 value = QVariant::fromValue(emptyModel);
             } else if (binding->isFunctionExpression()) {
                 QQmlBinding::Identifier id = binding->value.compiledScriptIndex;
@@ -68,6 +68,7 @@ public:
     Q_INVOKABLE void remove(QQmlV4Function *args);
     Q_INVOKABLE void append(QQmlV4Function *args);
     Q_INVOKABLE void insert(QQmlV4Function *args);
+    Q_REVISION(6, 7) Q_INVOKABLE void appendColumns(QQmlV4Function *args);
     Q_INVOKABLE QJSValue get(int index) const;
     Q_INVOKABLE void set(int index, const QJSValue &value);
     Q_INVOKABLE void setProperty(int index, const QString& property, const QVariant& value);
@@ -22,6 +22,9 @@
 #include <private/qv4qobjectwrapper_p.h>
 #include <qqml.h>
 
+#include <QtCore/qshareddata.h>
+#include <QtCore/qvarlengtharray.h>
+
 QT_REQUIRE_CONFIG(qml_list_model);
 
 QT_BEGIN_NAMESPACE
@@ -236,6 +239,39 @@ private:
     uint stringSize = 0;
 };
 
+/*!
+\internal
+*/
+class Q_QMLMODELS_PRIVATE_EXPORT ListElementPool : public QSharedData
+{
+public:
+    ListElementPool() = default;
+    ~ListElementPool();
+    Q_DISABLE_COPY_MOVE(ListElementPool)
+
+    void *allocate();
+    static void release(void *block);
+    static ListElementPool *owner(const void *block);
+
+    // For benchmarks, the size of all slabs of all pools
+    static qsizetype allocatedBytes();
+
+private:
+    enum { SegmentSize = 1024, MaximumSegmentsPerSlab = 4 };
+
+    struct FreeBlock;
+    struct Segment;
+    struct Slab;
+
+    static Slab *slabOf(const void *block);
+    static void destroy(Slab *slab);
+    void link(Slab *slab);
+    void unlink(Slab *slab);
+
+    Slab *partialSlabs = nullptr;
+    int slabCount = 0;
+};
+
 /*!
 \internal
 */
@@ -249,6 +285,11 @@ public:
     ListElement(int existingUid);
     ~ListElement();
 
+    // Blocks are carved out of the slabs of their model's ListElementPool
+    static void *operator new(size_t size, ListElementPool *pool);
+    static void operator delete(void *ptr, ListElementPool *pool);
+    static void operator delete(void *ptr, size_t size);
+
     static QVector<int> sync(ListElement *src, ListLayout *srcLayout, ListElement *target, ListLayout *targetLayout);
 
 private:
@@ -315,7 +356,7 @@ class ListModel
 {
 public:
 
-    ListModel(ListLayout *layout, QQmlListModel *modelCache);
+    ListModel(ListLayout *layout, QQmlListModel *modelCache, ListElementPool *elementPool = nullptr);
     ~ListModel() {}
 
     void destroy();
@@ -355,11 +396,31 @@ public:
 
     enum class SetElement {WasJustInserted, IsCurrentlyUpdated};
 
+    // Remembers the roles of the properties of the last object shape seen,
+    // for adding many objects in one go.
+    struct RoleCache
+    {
+        struct Slot
+        {
+            const ListLayout::Role *role = nullptr;
+            bool isRole = false;
+        };
+
+        bool update(QV4::Object *object);
+
+        QV4::Heap::InternalClass *internalClass = nullptr;
+        QVarLengthArray<Slot, 16> slots;
+        bool usable = false;
+    };
+
     void set(int elementIndex, QV4::Object *object, QVector<int> *roles);
-    void set(int elementIndex, QV4::Object *object, SetElement reason = SetElement::IsCurrentlyUpdated);
+    void set(int elementIndex, QV4::Object *object, SetElement reason = SetElement::IsCurrentlyUpdated,
+             RoleCache *cache = nullptr);
 
-    int append(QV4::Object *object);
-    void insert(int elementIndex, QV4::Object *object);
+    int append(QV4::Object *object, RoleCache *cache = nullptr);
+    void insert(int elementIndex, QV4::Object *object, RoleCache *cache = nullptr);
+    void appendColumns(QV4::ExecutionEngine *v4, const QV4::Value *names,
+                       const QV4::Value *columns, int columnCount, int rowCount);
 
     Q_REQUIRED_RESULT QVector<std::function<void()>> remove(int index, int count);
 
@@ -372,9 +433,12 @@ public:
 
     QObject *getOrCreateModelObject(QQmlListModel *model, int elementIndex);
 
+    ListElementPool *elementPool() { return m_elementPool.data(); }
+
 private:
     QPODVector<ListElement *, 4> elements;
     ListLayout *m_layout;
+    QExplicitlySharedDataPointer<ListElementPool> m_elementPool;
 
     QQmlListModel *m_modelCache;
 
@@ -389,6 +453,9 @@ private:
 
     void newElement(int index);
 
+    void setElementProperty(ListElement *e, QV4::String *propertyName, const QV4::Value &value,
+                            SetElement reason, const ListLayout::Role **cachedRole);
+
     void updateCacheIndices(int start = 0, int end = -1);
 
     friend class ListElement;
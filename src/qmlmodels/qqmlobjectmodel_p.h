@@ -55,8 +55,25 @@ public:
     virtual void setWatchedRoles(const QList<QByteArray> &roles) = 0;
     virtual QQmlIncubator::Status incubationStatus(int index) = 0;
 
+    struct PoolStatistics
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 pooled = 0;
+        quint64 drained = 0;
+        quint64 evicted = 0;
+        quint64 handedOver = 0;
+
+        qreal hitRate() const
+        {
+            const quint64 requests = hits + misses;
+            return requests ? qreal(hits) / qreal(requests) : qreal(0);
+        }
+    };
+
     virtual void drainReusableItemsPool(int maxPoolTime) { Q_UNUSED(maxPoolTime); }
     virtual int poolSize() { return 0; }
+    virtual PoolStatistics poolStatistics() const { return PoolStatistics(); }
 
     virtual int indexOf(QObject *object, QObject *objectContext) const = 0;
     virtual const QAbstractItemModel *abstractItemModel() const { return nullptr; }
@@ -38,6 +38,11 @@ QQmlTableInstanceModel::QQmlTableInstanceModel(QQmlContext *qmlContext, QObject
     , m_qmlContext(qmlContext)
     , m_metaType(new QQmlDelegateModelItemMetaType(m_qmlContext->engine()->handle(), nullptr, QStringList()),
                  QQmlRefPointer<QQmlDelegateModelItemMetaType>::Adopt)
+    , m_reusableItemsPool([this](QQmlDelegateModelItem *modelItem) {
+        // Evictions can be triggered by other views sharing the pool budget,
+        // so don't delete the object from under their feet.
+        destroyModelItem(modelItem, Deferred);
+    })
 {
 }
 
@@ -79,6 +79,7 @@ public:
 
     void drainReusableItemsPool(int maxPoolTime) override;
     int poolSize() override { return m_reusableItemsPool.size(); }
+    PoolStatistics poolStatistics() const override { return m_reusableItemsPool.statistics(); }
     void reuseItem(QQmlDelegateModelItem *item, int newModelIndex);
 
     QQmlIncubator::Status incubationStatus(int index) override;
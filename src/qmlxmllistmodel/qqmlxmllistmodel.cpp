@@ -490,6 +490,7 @@ void QQmlXmlListModel::tryExecuteQuery(const QByteArray &data)
 {
     auto job = createJob(data);
     m_queryId = job.queryId;
+    m_queryRowsDelivered = false;
     QQmlXmlListModelQueryRunnable *runnable = new QQmlXmlListModelQueryRunnable(std::move(job));
     if (runnable) {
         auto future = runnable->future();
@@ -497,15 +498,29 @@ void QQmlXmlListModel::tryExecuteQuery(const QByteArray &data)
         // No need to connect to canceled signal, because it just notifies that
         // QFuture::cancel() was called. We will get the finished() signal in
         // both cases.
+        // The runnable reports its rows in batches while it is still parsing,
+        // so that the first rows become visible long before large documents
+        // are fully processed.
+        connect(watcher, &ResultFutureWatcher::resultsReadyAt, this, [this](int begin, int end) {
+            auto *watcher = static_cast<ResultFutureWatcher *>(sender());
+            if (!watcher || watcher->isCanceled())
+                return;
+            for (int i = begin; i < end; ++i) {
+                const QQmlXmlListModelQueryResult result = watcher->resultAt(i);
+                // handle errors
+                for (const auto &errorInfo : result.errors)
+                    queryError(errorInfo.first, errorInfo.second);
+                // fill results
+                appendQueryRows(result);
+            }
+        });
         connect(watcher, &ResultFutureWatcher::finished, this, [id = m_queryId, this]() {
             auto *watcher = static_cast<ResultFutureWatcher *>(sender());
             if (watcher) {
                 if (!watcher->isCanceled()) {
-                    QQmlXmlListModelQueryResult result = watcher->result();
-                    // handle errors
-                    for (const auto &errorInfo : result.errors)
-                        queryError(errorInfo.first, errorInfo.second);
-                    // fill results
+                    // All the rows have already been delivered in batches
+                    QQmlXmlListModelQueryResult result;
+                    result.queryId = id;
                     queryCompleted(result);
                 }
                 // remove from watchers
@@ -566,6 +581,11 @@ int QQmlXmlListModel::nextQueryId()
     \value XmlListModel.Error   An error occurred while the model was loading. See
                                 \l errorString() for details about the error.
 
+    The XML data is parsed in a background thread, and rows are appended to
+    the model in batches while the status is still \c XmlListModel.Loading.
+    The rows of the previous query are removed when the first batch of a new
+    query arrives.
+
     \sa progress
 */
 QQmlXmlListModel::Status QQmlXmlListModel::status() const
@@ -750,13 +770,42 @@ void QQmlXmlListModel::queryError(void *object, const QString &error)
     qmlWarning(this) << QQmlXmlListModel::tr("Query error: \"%1\"").arg(error);
 }
 
+void QQmlXmlListModel::appendQueryRows(const QQmlXmlListModelQueryResult &result)
+{
+    if (result.queryId != m_queryId)
+        return;
+
+    const int origCount = m_size;
+
+    // The rows of the previous query are kept until the first batch of the
+    // new query arrives, so that views do not flicker while reloading.
+    if (!m_queryRowsDelivered) {
+        m_queryRowsDelivered = true;
+        if (m_size > 0) {
+            beginRemoveRows(QModelIndex(), 0, m_size - 1);
+            m_data.clear();
+            m_size = 0;
+            endRemoveRows();
+        }
+    }
+
+    if (!result.data.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_size, m_size + result.data.size() - 1);
+        m_data.append(result.data);
+        m_size = m_data.size();
+        endInsertRows();
+    }
+
+    if (m_size != origCount)
+        Q_EMIT countChanged();
+}
+
 void QQmlXmlListModel::queryCompleted(const QQmlXmlListModelQueryResult &result)
 {
     if (result.queryId != m_queryId)
         return;
 
-    int origCount = m_size;
-    bool sizeChanged = result.data.size() != m_size;
+    appendQueryRows(result);
 
     if (m_source.isEmpty())
         m_status = Null;
@@ -764,21 +813,7 @@ void QQmlXmlListModel::queryCompleted(const QQmlXmlListModelQueryResult &result)
         m_status = Ready;
     m_errorString.clear();
     m_queryId = -1;
-
-    if (origCount > 0) {
-        beginRemoveRows(QModelIndex(), 0, origCount - 1);
-        endRemoveRows();
-    }
-    m_size = result.data.size();
-    m_data = result.data;
-
-    if (m_size > 0) {
-        beginInsertRows(QModelIndex(), 0, m_size - 1);
-        endInsertRows();
-    }
-
-    if (sizeChanged)
-        Q_EMIT countChanged();
+    m_queryRowsDelivered = false;
 
     Q_EMIT statusChanged(m_status);
 }
@@ -792,6 +827,9 @@ void QQmlXmlListModel::notifyQueryStarted(bool remoteSource)
     Q_EMIT statusChanged(m_status);
 }
 
+static constexpr qsizetype InitialBatchSize = 32;
+static constexpr qsizetype MaximumBatchSize = 2048;
+
 static qsizetype findIndexOfName(const QStringList &elementNames, const QStringView &name,
                                  qsizetype startIndex = 0)
 {
@@ -815,7 +853,8 @@ void QQmlXmlListModelQueryRunnable::run()
         QQmlXmlListModelQueryResult result;
         result.queryId = m_job.queryId;
         doQueryJob(&result);
-        m_promise.addResult(std::move(result));
+        if (!result.data.isEmpty() || !result.errors.isEmpty())
+            m_promise.addResult(std::move(result));
     }
     m_promise.finish();
 }
@@ -829,12 +868,17 @@ void QQmlXmlListModelQueryRunnable::doQueryJob(QQmlXmlListModelQueryResult *curr
 {
     Q_ASSERT(m_job.queryId != -1);
 
-    QByteArray data(m_job.data);
+    // Hand the document over to the reader, so that it is not kept alive
+    // twice while parsing.
     QXmlStreamReader reader;
-    reader.addData(data);
+    reader.addData(std::exchange(m_job.data, QByteArray()));
 
     QStringList items = m_job.query.split(QLatin1Char('/'), Qt::SkipEmptyParts);
 
+    // Start with a small batch so that the first rows show up quickly, then
+    // grow it to keep the per-batch overhead on the GUI thread low.
+    qsizetype batchSize = InitialBatchSize;
+
     while (!reader.atEnd() && !m_promise.isCanceled()) {
         int i = 0;
         while (i < items.size()) {
@@ -845,6 +889,13 @@ void QQmlXmlListModelQueryRunnable::doQueryJob(QQmlXmlListModelQueryResult *curr
                         continue;
                     } else {
                         processElement(currentResult, items.at(i), reader);
+                        if (currentResult->data.size() >= batchSize) {
+                            QQmlXmlListModelQueryResult batch;
+                            batch.queryId = currentResult->queryId;
+                            std::swap(batch, *currentResult);
+                            m_promise.addResult(std::move(batch));
+                            batchSize = qMin(batchSize * 2, MaximumBatchSize);
+                        }
                     }
                 } else {
                     reader.skipCurrentElement();
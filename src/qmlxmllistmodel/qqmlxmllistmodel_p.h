@@ -165,6 +165,7 @@ private:
     static void clearRole(QQmlListProperty<QQmlXmlListModelRole> *);
 
     void tryExecuteQuery(const QByteArray &data);
+    void appendQueryRows(const QQmlXmlListModelQueryResult &result);
 
     QQmlXmlListModelQueryJob createJob(const QByteArray &data);
     int nextQueryId();
@@ -187,6 +188,7 @@ private:
     QString m_errorString;
     qreal m_progress = 0;
     int m_queryId = -1;
+    bool m_queryRowsDelivered = false;
     int m_nextQueryIdGenerator = -1;
     int m_highestRole = Qt::UserRole;
     using ResultFutureWatcher = QFutureWatcher<QQmlXmlListModelQueryResult>;
@@ -280,6 +280,90 @@ qreal QQuickFlickablePrivate::overShootDistance(qreal velocity) const
     return qMin(qreal(QML_FLICK_OVERSHOOT), velocity / 3);
 }
 
+static int &prefetchLookaheadValue()
+{
+    static int lookahead = qMax(0, qEnvironmentVariableIntValue("QML_VIEW_PREFETCH_LOOKAHEAD"));
+    return lookahead;
+}
+
+static int &prefetchBudgetValue()
+{
+    static int budget = qEnvironmentVariableIsSet("QML_VIEW_PREFETCH_BUDGET")
+            ? qMax(0, qEnvironmentVariableIntValue("QML_VIEW_PREFETCH_BUDGET"))
+            : 64;
+    return budget;
+}
+
+/*!
+    \internal
+
+    Returns the time, in milliseconds, that item views look ahead of a flick
+    when deciding how much content to prefetch beyond their viewport. This is
+    controlled by the \c QML_VIEW_PREFETCH_LOOKAHEAD environment variable, and
+    is 0 (prefetching disabled) by default.
+*/
+int QQuickFlickablePrivate::prefetchLookahead()
+{
+    return prefetchLookaheadValue();
+}
+
+// For autotests
+void QQuickFlickablePrivate::setPrefetchLookahead(int lookahead)
+{
+    prefetchLookaheadValue() = qMax(0, lookahead);
+}
+
+/*!
+    \internal
+
+    Returns the maximum number of delegates that a view keeps prefetched
+    without them having been flicked into view yet. Once a view holds that
+    many, it stops prefetching until some of them are either shown or
+    released. This bounds the memory spent on delegates that may never be
+    needed. It is controlled by the \c QML_VIEW_PREFETCH_BUDGET environment
+    variable, and is 64 by default. 0 means that the number is unlimited.
+*/
+int QQuickFlickablePrivate::prefetchBudget()
+{
+    return prefetchBudgetValue();
+}
+
+// For autotests
+void QQuickFlickablePrivate::setPrefetchBudget(int budget)
+{
+    prefetchBudgetValue() = qMax(0, budget);
+}
+
+/*!
+    \internal
+
+    Returns the distance the content will move along \a data within the
+    prefetch lookahead time, based on the smoothed flick velocity. To bound the
+    number of delegates created ahead of time, the distance never exceeds one
+    \a viewportSize.
+*/
+qreal QQuickFlickablePrivate::prefetchDistance(const AxisData &data, qreal viewportSize) const
+{
+    const int lookahead = prefetchLookahead();
+    if (!lookahead || viewportSize <= 0)
+        return 0;
+    const qreal distance = qAbs(data.smoothVelocity.value()) * lookahead / 1000;
+    return qMin(distance, viewportSize);
+}
+
+/*!
+    \internal
+
+    Returns \c true if the view holds as many prefetched delegates as the
+    prefetch budget allows. The view should then keep the delegates it has
+    prefetched, but not create any more ahead of the flick.
+*/
+bool QQuickFlickablePrivate::isPrefetchBudgetUsedUp() const
+{
+    const int budget = prefetchBudget();
+    return budget > 0 && pendingPrefetchedItems >= budget;
+}
+
 void QQuickFlickablePrivate::AxisData::addVelocitySample(qreal v, qreal maxVelocity)
 {
     if (v > maxVelocity)
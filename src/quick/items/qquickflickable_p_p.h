@@ -165,6 +165,22 @@ public:
 
     qreal overShootDistance(qreal velocity) const;
 
+    struct PrefetchStatistics
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 wasted = 0;
+    };
+
+    static int prefetchLookahead();
+    static void setPrefetchLookahead(int lookahead);
+    static int prefetchBudget();
+    static void setPrefetchBudget(int budget);
+    qreal prefetchDistance(const AxisData &data, qreal viewportSize) const;
+    bool isPrefetchBudgetUsedUp() const;
+    const PrefetchStatistics &prefetchStatistics() const { return prefetchStats; }
+    int pendingPrefetchedItemCount() const { return pendingPrefetchedItems; }
+
     void itemGeometryChanged(QQuickItem *, QQuickGeometryChange, const QRectF &) override;
 
     void draggingStarting();
@@ -227,6 +243,11 @@ public:
     QQuickFlickable::BoundsMovement boundsMovement;
     QQuickTransition *rebound;
 
+    // Delegates created ahead of a flick by item views and TableView, which
+    // have not been flicked into view yet.
+    PrefetchStatistics prefetchStats;
+    int pendingPrefetchedItems = 0;
+
     void viewportAxisMoved(AxisData &data, qreal minExtent, qreal maxExtent,
                        QQuickTimeLineCallback::Callback fixupCallback);
 
@@ -1786,19 +1786,31 @@ void QQuickItemViewPrivate::refill(qreal from, qreal to)
         qreal fillFrom = from;
         qreal fillTo = to;
 
+        // While flicking, bufferMode only covers the direction of movement.
+        // Extend the buffer further in that direction, so that the delegates
+        // about to be flicked into view are incubated ahead of time.
+        // Once the prefetch budget is used up, we keep the items that have
+        // been prefetched, but don't create any more.
+        const qreal prefetch = prefetchDistance();
+        const bool canPrefetch = prefetch > 0 && !isPrefetchBudgetUsedUp();
+        if (bufferMode == BufferAfter)
+            bufferTo += prefetch;
+        else if (bufferMode == BufferBefore)
+            bufferFrom -= prefetch;
+
         bool added = addVisibleItems(fillFrom, fillTo, bufferFrom, bufferTo, false);
         bool removed = removeNonVisibleItems(bufferFrom, bufferTo);
 
-        if (requestedIndex == -1 && buffer && bufferMode != NoBuffer) {
+        if (requestedIndex == -1 && (buffer || canPrefetch) && bufferMode != NoBuffer) {
             if (added) {
                 // We've already created a new delegate this frame.
                 // Just schedule a buffer refill.
                 bufferPause.start();
             } else {
                 if (bufferMode & BufferAfter)
-                    fillTo = bufferTo;
+                    fillTo = canPrefetch ? bufferTo : to + buffer;
                 if (bufferMode & BufferBefore)
-                    fillFrom = bufferFrom;
+                    fillFrom = canPrefetch ? bufferFrom : from - buffer;
                 added |= addVisibleItems(fillFrom, fillTo, bufferFrom, bufferTo, true);
             }
         }
@@ -1814,10 +1826,35 @@ void QQuickItemViewPrivate::refill(qreal from, qreal to)
 
         if (prevCount != itemCount)
             emit q->countChanged();
+
+        if (pendingPrefetchedItems > 0)
+            updatePrefetchStatistics(from, to);
     } while (currentChanges.hasPendingChanges() || bufferedChanges.hasPendingChanges());
     storeFirstVisibleItemPosition();
 }
 
+qreal QQuickItemViewPrivate::prefetchDistance() const
+{
+    const AxisData &data = layoutOrientation() == Qt::Vertical ? vData : hData;
+    return QQuickFlickablePrivate::prefetchDistance(data, size());
+}
+
+void QQuickItemViewPrivate::updatePrefetchStatistics(qreal from, qreal to)
+{
+    // A prefetched item that has been flicked into view is a hit
+    for (FxViewItem *item : std::as_const(visibleItems)) {
+        if (!item->prefetched || item->position() + item->size() <= from || item->position() >= to)
+            continue;
+        item->prefetched = false;
+        --pendingPrefetchedItems;
+        ++prefetchStats.hits;
+    }
+
+    qCDebug(lcItemViewDelegateLifecycle) << "prefetch hits:" << prefetchStats.hits
+                                         << "misses:" << prefetchStats.misses
+                                         << "wasted:" << prefetchStats.wasted;
+}
+
 void QQuickItemViewPrivate::regenerate(bool orientationChanged)
 {
     Q_Q(QQuickItemView);
@@ -2397,6 +2434,22 @@ FxViewItem *QQuickItemViewPrivate::createItem(int modelIndex, QQmlIncubator::Inc
             // until after bindings are evaluated
             initializeViewItem(viewItem);
             unrequestedItems.remove(item);
+
+            if (prefetchLookahead() > 0) {
+                // Only items incubated asynchronously while the buffer is
+                // extended ahead of a flick are prefetched. Anything else
+                // created while flicking had to be created on demand, and is
+                // a prefetch miss.
+                const AxisData &data = layoutOrientation() == Qt::Vertical ? vData : hData;
+                if (incubationMode == QQmlIncubator::Asynchronous) {
+                    if (prefetchDistance() > 0 && !isPrefetchBudgetUsedUp()) {
+                        viewItem->prefetched = true;
+                        ++pendingPrefetchedItems;
+                    }
+                } else if (!qFuzzyIsNull(data.smoothVelocity.value())) {
+                    ++prefetchStats.misses;
+                }
+            }
         }
         inRequest = false;
         return viewItem;
@@ -2467,6 +2520,10 @@ bool QQuickItemViewPrivate::releaseItem(FxViewItem *item, QQmlInstanceModel::Reu
     if (trackedItem == item)
         trackedItem = nullptr;
     item->trackGeometry(false);
+    if (item->prefetched) {
+        --pendingPrefetchedItems;
+        ++prefetchStats.wasted;
+    }
 
     QQmlInstanceModel::ReleaseFlags flags = {};
     if (model && item->item) {
@@ -143,6 +143,9 @@ public:
     void refill(qreal from, qreal to);
     void mirrorChange() override;
 
+    qreal prefetchDistance() const;
+    void updatePrefetchStatistics(qreal from, qreal to);
+
     FxViewItem *createItem(int modelIndex,QQmlIncubator::IncubationMode incubationMode = QQmlIncubator::AsynchronousIfNested);
     virtual bool releaseItem(FxViewItem *item, QQmlInstanceModel::ReusableFlag reusableFlag);
 
@@ -16,6 +16,7 @@ QQuickItemViewFxItem::QQuickItemViewFxItem(QQuickItem *item, bool ownItem, QQuic
     , ownItem(ownItem)
     , releaseAfterTransition(false)
     , trackGeom(false)
+    , prefetched(false)
 {
 }
 
@@ -73,6 +73,7 @@ public:
     bool ownItem : 1;
     bool releaseAfterTransition : 1;
     bool trackGeom : 1;
+    bool prefetched : 1;
 };
 
 QT_END_NAMESPACE
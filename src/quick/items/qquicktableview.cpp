@@ -2618,6 +2618,11 @@ void QQuickTableViewPrivate::releaseItem(FxTableItem *fxTableItem, QQmlTableInst
     // the item is owned by the QML context rather than the model (e.g ObjectModel etc).
     auto item = fxTableItem->item;
 
+    if (fxTableItem->prefetched) {
+        --pendingPrefetchedItems;
+        ++prefetchStats.wasted;
+    }
+
     if (fxTableItem->ownItem) {
         Q_TABLEVIEW_ASSERT(item, fxTableItem->index);
         delete item;
@@ -2738,6 +2743,81 @@ Qt::Edge QQuickTableViewPrivate::nextEdgeToUnload(const QRectF rect)
     return Qt::Edge(0);
 }
 
+QRectF QQuickTableViewPrivate::prefetchRect() const
+{
+    // Return the viewport extended in the direction of the flick by the
+    // distance the content is expected to move within the prefetch lookahead
+    // time. When not flicking, or when prefetching is disabled, this is the
+    // same as the viewport.
+    QRectF rect = viewportRect;
+    if (prefetchLookahead() <= 0)
+        return rect;
+
+    const qreal dx = prefetchDistance(hData, viewportRect.width());
+    const qreal dy = prefetchDistance(vData, viewportRect.height());
+    if (hData.smoothVelocity.value() > 0)
+        rect.setRight(rect.right() + dx);
+    else
+        rect.setLeft(rect.left() - dx);
+    if (vData.smoothVelocity.value() > 0)
+        rect.setBottom(rect.bottom() + dy);
+    else
+        rect.setTop(rect.top() - dy);
+    return rect;
+}
+
+bool QQuickTableViewPrivate::stopPrefetchingEdge()
+{
+    // An edge ahead of a flick is still incubating asynchronously, while the
+    // viewport has moved and needs an edge loaded as well. If it needs the
+    // same edge, we finish loading it right away, as if it had been requested
+    // for the viewport in the first place. Otherwise we give up on it, since
+    // it would hold back the viewport. Returns true if the load request was
+    // completed or stopped.
+    Q_TABLEVIEW_ASSERT(loadRequest.isActive() && prefetchingEdge, "");
+
+    const Qt::Edge edge = nextEdgeToLoad(viewportRect);
+    if (!edge)
+        return false;
+
+    prefetchingEdge = false;
+
+    if (edge == loadRequest.edge()) {
+        qCDebug(lcTableViewDelegateLifecycle) << "completing prefetched edge:" << loadRequest.toString();
+        loadRequest.setIncubationMode(QQmlIncubator::AsynchronousIfNested);
+        processLoadRequest();
+        return !loadRequest.isActive();
+    }
+
+    // Release the cells of the edge that are already loaded. The model
+    // deletes the cell that is still incubating once it's done, since
+    // nothing references it.
+    qCDebug(lcTableViewDelegateLifecycle) << "cancelling prefetched edge:" << loadRequest.toString();
+    for (int i = 0; i < loadRequest.loadedCellCount(); ++i) {
+        const int modelIndex = modelIndexAtCell(loadRequest.loadedCellAt(i));
+        if (FxTableItem *fxTableItem = loadedItems.take(modelIndex))
+            releaseItem(fxTableItem, reusableFlag);
+    }
+    loadRequest.markAsDone();
+    return true;
+}
+
+void QQuickTableViewPrivate::updatePrefetchStatistics()
+{
+    // A prefetched cell that has been flicked into view is a hit
+    for (FxTableItem *fxTableItem : std::as_const(loadedItems)) {
+        if (!fxTableItem->prefetched || !fxTableItem->geometry().intersects(viewportRect))
+            continue;
+        fxTableItem->prefetched = false;
+        --pendingPrefetchedItems;
+        ++prefetchStats.hits;
+    }
+
+    qCDebug(lcTableViewDelegateLifecycle) << "prefetch hits:" << prefetchStats.hits
+                                          << "misses:" << prefetchStats.misses
+                                          << "wasted:" << prefetchStats.wasted;
+}
+
 qreal QQuickTableViewPrivate::cellWidth(const QPoint& cell) const
 {
     // Using an items width directly is not an option, since we change
@@ -3269,6 +3349,14 @@ void QQuickTableViewPrivate::processLoadRequest()
             return;
         }
 
+        if (prefetchingEdge) {
+            fxTableItem->prefetched = true;
+            ++pendingPrefetchedItems;
+        } else if (rebuildState == RebuildState::Done && prefetchRect() != viewportRect) {
+            // The cell was needed in the viewport during a flick before it could be prefetched
+            ++prefetchStats.misses;
+        }
+
         loadedItems.insert(modelIndexAtCell(cell), fxTableItem);
         loadRequest.moveToNextCell();
     }
@@ -3307,6 +3395,7 @@ void QQuickTableViewPrivate::processLoadRequest()
     }
 
     loadRequest.markAsDone();
+    prefetchingEdge = false;
 
     qCDebug(lcTableViewDelegateLifecycle()) << "current table:" << tableLayoutToString();
     qCDebug(lcTableViewDelegateLifecycle()) << "Load request completed!";
@@ -3634,6 +3723,7 @@ void QQuickTableViewPrivate::loadInitialTable()
 
     // Load top-left item. After loaded, loadItemsInsideRect() will take
     // care of filling out the rest of the table.
+    prefetchingEdge = false;
     loadRequest.begin(topLeft, topLeftPos, QQmlIncubator::AsynchronousIfNested);
     processLoadRequest();
     loadAndUnloadVisibleEdges();
@@ -3805,7 +3895,7 @@ void QQuickTableViewPrivate::loadAndUnloadVisibleEdges(QQmlIncubator::Incubation
     // cancel the buffering quickly if the user starts to flick, and then
     // focus all further loading on the edges that are flicked into view.
 
-    if (loadRequest.isActive()) {
+    if (loadRequest.isActive() && !(prefetchingEdge && stopPrefetchingEdge())) {
         // Don't start loading more edges while we're
         // already waiting for another one to load.
         return;
@@ -3818,21 +3908,40 @@ void QQuickTableViewPrivate::loadAndUnloadVisibleEdges(QQmlIncubator::Incubation
         return;
     }
 
+    if (pendingPrefetchedItems > 0)
+        updatePrefetchStatistics();
+
+    // While flicking, we also load the edges that are about to be flicked
+    // into view. Those are incubated asynchronously, so that the incubation
+    // controller can spend the time left over in each frame on them. And we
+    // always load edges inside the viewport first.
+    const QRectF fillRect = prefetchRect();
+    const bool prefetch = fillRect != viewportRect;
+
     bool tableModified;
 
     do {
         tableModified = false;
 
-        if (Qt::Edge edge = nextEdgeToUnload(viewportRect)) {
+        if (Qt::Edge edge = nextEdgeToUnload(fillRect)) {
             tableModified = true;
             unloadEdge(edge);
         }
 
         if (Qt::Edge edge = nextEdgeToLoad(viewportRect)) {
             tableModified = true;
+            prefetchingEdge = false;
             loadEdge(edge, incubationMode);
             if (loadRequest.isActive())
                 return;
+        } else if (prefetch && !isPrefetchBudgetUsedUp()) {
+            if (Qt::Edge edge = nextEdgeToLoad(fillRect)) {
+                tableModified = true;
+                prefetchingEdge = true;
+                loadEdge(edge, QQmlIncubator::Asynchronous);
+                if (loadRequest.isActive())
+                    return;
+            }
         }
     } while (tableModified);
 
@@ -3955,6 +4064,13 @@ bool QQuickTableViewPrivate::updateTable()
     Q_TABLEVIEW_ASSERT(!polishing, "recursive updatePolish() calls are not allowed!");
     QBoolBlocker polishGuard(polishing, true);
 
+    if (loadRequest.isActive() && prefetchingEdge) {
+        // An edge ahead of a flick must not hold back the edges that
+        // the viewport needs now.
+        syncViewportRect();
+        stopPrefetchingEdge();
+    }
+
     if (loadRequest.isActive()) {
         // We're currently loading items async to build a new edge in the table. We see the loading
         // as an atomic operation, which means that we don't continue doing anything else until all
@@ -4154,8 +4270,10 @@ void QQuickTableViewPrivate::itemCreatedCallback(int modelIndex, QObject*)
     // Since the item we waited for has finished incubating, we can
     // continue with the load request. processLoadRequest will
     // ask the model for the requested item once more, which will be
-    // quick since the model has cached it.
-    processLoadRequest();
+    // quick since the model has cached it. If the load request was
+    // for an edge ahead of a flick, it might have been stopped already.
+    if (loadRequest.isActive())
+        processLoadRequest();
     loadAndUnloadVisibleEdges();
     updatePolish();
 }
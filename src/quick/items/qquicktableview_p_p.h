@@ -172,10 +172,14 @@ public:
         inline bool hasCurrentCell() const { return m_currentIndex < m_visibleCellsInEdge.size(); }
         inline void moveToNextCell() { ++m_currentIndex; }
 
+        inline int loadedCellCount() const { return m_currentIndex; }
+        inline QPoint loadedCellAt(int index) const { Q_ASSERT(index < m_currentIndex); return cellAt(index); }
+
         inline Qt::Edge edge() const { return m_edge; }
         inline int row() const { return cellAt(0).y(); }
         inline int column() const { return cellAt(0).x(); }
         inline QQmlIncubator::IncubationMode incubationMode() const { return m_mode; }
+        inline void setIncubationMode(QQmlIncubator::IncubationMode incubationMode) { m_mode = incubationMode; }
 
         inline QPointF startPosition() const { return m_startPos; }
 
@@ -295,6 +299,10 @@ public:
 
     QRectF viewportRect = QRectF(0, 0, -1, -1);
 
+    // Edges loaded ahead of a flick are incubated asynchronously, and the
+    // cells they contain are marked as prefetched until flicked into view.
+    bool prefetchingEdge = false;
+
     QSize tableSize;
 
     RebuildState rebuildState = RebuildState::Done;
@@ -466,6 +474,9 @@ public:
     bool canUnloadTableEdge(Qt::Edge tableEdge, const QRectF fillRect) const;
     Qt::Edge nextEdgeToLoad(const QRectF rect);
     Qt::Edge nextEdgeToUnload(const QRectF rect);
+    QRectF prefetchRect() const;
+    bool stopPrefetchingEdge();
+    void updatePrefetchStatistics();
 
     qreal cellWidth(const QPoint &cell) const;
     qreal cellHeight(const QPoint &cell) const;
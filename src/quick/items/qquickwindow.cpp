@@ -79,6 +79,10 @@ public:
         // Allow incubation for 1/3 of a frame.
         m_incubation_time = qMax(1, int(1000 / QGuiApplication::primaryScreen()->refreshRate()) / 3);
 
+        // Optionally use whatever is left of the current frame instead, minus
+        // some headroom for event processing before the next frame starts.
+        m_useFrameBudget = qEnvironmentVariableIntValue("QSG_INCUBATION_FRAME_BUDGET") != 0;
+
         QAnimationDriver *animationDriver = m_renderLoop->animationDriver();
         if (animationDriver) {
             connect(animationDriver, &QAnimationDriver::stopped, this, &QQuickWindowIncubationController::animationStopped);
@@ -106,7 +110,7 @@ public slots:
     void incubate() {
         if (m_renderLoop && incubatingObjectCount()) {
             if (m_renderLoop->interleaveIncubation()) {
-                incubateFor(m_incubation_time);
+                incubateFor(interleavedIncubationTime());
             } else {
                 incubateFor(m_incubation_time * 2);
                 if (incubatingObjectCount())
@@ -117,6 +121,17 @@ public slots:
 
     void animationStopped() { incubate(); }
 
+private:
+    int interleavedIncubationTime() const
+    {
+        if (m_useFrameBudget) {
+            const int remaining = m_renderLoop->remainingFrameTime();
+            if (remaining >= 0)
+                return qMax(1, remaining - m_incubation_time / 2);
+        }
+        return m_incubation_time;
+    }
+
 protected:
     void incubatingObjectCountChanged(int count) override
     {
@@ -128,6 +143,7 @@ private:
     QPointer<QSGRenderLoop> m_renderLoop;
     int m_incubation_time;
     int m_timer;
+    bool m_useFrameBudget;
 };
 
 #if QT_CONFIG(accessibility)
@@ -766,6 +782,7 @@ void QQuickWindowPrivate::init(QQuickWindow *c, QQuickRenderControl *control)
     QObject::connect(context, &QSGRenderContext::initialized, q, &QQuickWindow::sceneGraphInitialized, Qt::DirectConnection);
     QObject::connect(context, &QSGRenderContext::invalidated, q, &QQuickWindow::sceneGraphInvalidated, Qt::DirectConnection);
     QObject::connect(context, &QSGRenderContext::invalidated, q, &QQuickWindow::cleanupSceneGraph, Qt::DirectConnection);
+    QObject::connect(context, &QSGRenderContext::glyphsReady, q, &QQuickWindow::update, Qt::QueuedConnection);
 
     QObject::connect(q, &QQuickWindow::focusObjectChanged, q, &QQuickWindow::activeFocusItemChanged);
     QObject::connect(q, &QQuickWindow::screenChanged, q, &QQuickWindow::handleScreenChanged);
@@ -1875,6 +1892,21 @@ void QQuickWindowPrivate::cleanupNodesOnShutdown()
     q->cleanupSceneGraph();
 }
 
+/*!
+    Returns the size in bytes of the distance field glyph cache textures used
+    by this window, or 0 when not rendering with QRhi. Glyph caches shared
+    with other windows are counted in equal parts for each of them.
+
+    This must be called from the render thread, or with the render thread
+    blocked, for example during synchronization.
+ */
+qint64 QQuickWindowPrivate::glyphCacheTextureMemory() const
+{
+    if (!rhi || !context || !context->isValid())
+        return 0;
+    return static_cast<QSGDefaultRenderContext *>(context)->glyphCacheTextureMemory();
+}
+
 void QQuickWindowPrivate::updateDirtyNodes()
 {
     qCDebug(lcDirty) << "QQuickWindowPrivate::updateDirtyNodes():";
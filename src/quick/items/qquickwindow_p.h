@@ -181,6 +181,8 @@ public:
 
     void clearGrabbers(QPointerEvent *event);
 
+    qint64 glyphCacheTextureMemory() const;
+
     QSGRenderContext *context;
     QSGRenderer *renderer;
     QByteArray visualizationMode; // Default renderer supports "clip", "overdraw", "changes", "batches" and blank.
@@ -9,13 +9,24 @@
 #include "qsgsoftwarerenderablenode_p.h"
 
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtGui/QFontDatabase>
 #include <QtGui/QWindow>
+#include <QtGui/qpa/qplatformpixmap.h>
 #include <QtQuick/QSGSimpleRectNode>
 
 Q_LOGGING_CATEGORY(lc2DRender, "qt.scenegraph.softwarecontext.abstractrenderer")
 
 QT_BEGIN_NAMESPACE
 
+// Size, in device pixels, of the tiles that are rasterized in parallel
+static const int TILE_SIZE = 256;
+
+Q_GLOBAL_STATIC(QThreadPool, qsgSoftwareTileThreadPool)
+
 QSGAbstractSoftwareRenderer::QSGAbstractSoftwareRenderer(QSGRenderContext *context)
     : QSGRenderer(context)
     , m_background(new QSGSimpleRectNode)
@@ -24,6 +35,10 @@ QSGAbstractSoftwareRenderer::QSGAbstractSoftwareRenderer(QSGRenderContext *conte
     // Setup special background node
     auto backgroundRenderable = new QSGSoftwareRenderableNode(QSGSoftwareRenderableNode::SimpleRect, m_background);
     addNodeMapping(m_background, backgroundRenderable);
+
+    // QSG_SOFTWARE_RENDER_THREADS=0 uses one thread per core
+    if (qEnvironmentVariableIsSet("QSG_SOFTWARE_RENDER_THREADS"))
+        setRenderThreadCount(qEnvironmentVariableIntValue("QSG_SOFTWARE_RENDER_THREADS"));
 }
 
 QSGAbstractSoftwareRenderer::~QSGAbstractSoftwareRenderer()
@@ -86,6 +101,19 @@ void QSGAbstractSoftwareRenderer::nodeChanged(QSGNode *node, QSGNode::DirtyState
         QSGRenderer::nodeChanged(node, state);
 }
 
+/*!
+    \internal
+
+    Sets the number of threads used to rasterize the render list to \a count.
+    With more than one thread, the dirty area is split into tiles that are
+    painted in parallel, each with its own painter. A \a count of 0 uses one
+    thread per core.
+ */
+void QSGAbstractSoftwareRenderer::setRenderThreadCount(int count)
+{
+    m_renderThreadCount = count > 0 ? count : QThread::idealThreadCount();
+}
+
 QRegion QSGAbstractSoftwareRenderer::renderNodes(QPainter *painter)
 {
     QRegion dirtyRegion;
@@ -93,6 +121,19 @@ QRegion QSGAbstractSoftwareRenderer::renderNodes(QPainter *painter)
     if (m_renderableNodes.isEmpty())
         return dirtyRegion;
 
+    if (QSG_RASTER_LOG_TIME_RENDERER().isDebugEnabled()) {
+        int paintedNodeCount = 0;
+        for (QSGSoftwareRenderableNode *node : std::as_const(m_renderableNodes)) {
+            if (node->needsPainting())
+                ++paintedNodeCount;
+        }
+        qCDebug(QSG_RASTER_LOG_TIME_RENDERER, "render list: nodes=%d, painted=%d, culled=%d",
+                int(m_renderableNodes.size()), paintedNodeCount, m_culledNodeCount);
+    }
+
+    if (QImage *target = tiledRenderTarget(painter))
+        return renderNodesTiled(painter, target);
+
     auto iterator = m_renderableNodes.begin();
     // First node is the background and needs to painted without blending
     auto backgroundNode = *iterator;
@@ -107,6 +148,154 @@ QRegion QSGAbstractSoftwareRenderer::renderNodes(QPainter *painter)
     return dirtyRegion;
 }
 
+/*
+    Returns the image that \a painter paints on, if the render list can be
+    rasterized in parallel tiles on it. Otherwise returns nullptr, and the
+    render list is painted serially.
+ */
+QImage *QSGAbstractSoftwareRenderer::tiledRenderTarget(QPainter *painter) const
+{
+    if (m_renderThreadCount <= 1)
+        return nullptr;
+
+    // Tiles are painted through images sharing the pixel data of the target,
+    // so the target must be backed by a QImage.
+    QPaintDevice *device = painter->device();
+    QImage *target = nullptr;
+    if (device->devType() == QInternal::Image) {
+        target = static_cast<QImage *>(device);
+    } else if (device->devType() == QInternal::Pixmap) {
+        if (QPlatformPixmap *platformPixmap = static_cast<QPixmap *>(device)->handle())
+            target = platformPixmap->buffer();
+    }
+    if (!target || target->isNull() || target->depth() < 8)
+        return nullptr;
+
+    // Tile origins need to map to whole logical pixels for the tiles to be
+    // rasterized exactly like the full image.
+    const qreal dpr = device->devicePixelRatio();
+    if (!qFuzzyCompare(dpr, qreal(qRound(dpr))))
+        return nullptr;
+
+    // Render nodes paint with the painter of the render context, and text
+    // can only be painted outside of the GUI thread on some platforms.
+    const bool threadedText = QFontDatabase::supportsThreadedFontRendering();
+    for (QSGSoftwareRenderableNode *node : m_renderableNodes) {
+        if (!node->needsPainting())
+            continue;
+        if (node->type() == QSGSoftwareRenderableNode::RenderNode)
+            return nullptr;
+        if (node->type() == QSGSoftwareRenderableNode::Glyph && !threadedText)
+            return nullptr;
+    }
+
+    return target;
+}
+
+/*
+    Paints the render list on \a target split into tiles, which are rasterized
+    in parallel on a thread pool. Each tile is painted with its own painter,
+    set up like \a painter but translated to the tile, and gets the nodes
+    whose dirty region intersect the tile in render list order. Since nodes
+    are clipped to the same dirty regions as when painting serially, the
+    result is identical.
+ */
+QRegion QSGAbstractSoftwareRenderer::renderNodesTiled(QPainter *painter, QImage *target)
+{
+    const qreal dpr = painter->device()->devicePixelRatio();
+    const int intDpr = qMax(1, qRound(dpr));
+    const int tileSize = qMax(1, TILE_SIZE / intDpr) * intDpr;
+    const int columns = (target->width() + tileSize - 1) / tileSize;
+    const int rows = (target->height() + tileSize - 1) / tileSize;
+    const QRect targetRect = target->rect();
+    const QTransform deviceTransform = painter->deviceTransform();
+
+    // Build the render list of each tile
+    QList<QList<QSGSoftwareRenderableNode *>> tileNodes(columns * rows);
+    for (QSGSoftwareRenderableNode *node : std::as_const(m_renderableNodes)) {
+        if (!node->needsPainting())
+            continue;
+        node->preparePaint(dpr);
+        const QRect deviceRect = deviceTransform.mapRect(QRectF(node->dirtyRegion().boundingRect()))
+                .toAlignedRect().adjusted(-1, -1, 1, 1).intersected(targetRect);
+        if (deviceRect.isEmpty())
+            continue;
+        for (int row = deviceRect.top() / tileSize; row <= deviceRect.bottom() / tileSize; ++row) {
+            for (int column = deviceRect.left() / tileSize; column <= deviceRect.right() / tileSize; ++column)
+                tileNodes[row * columns + column].append(node);
+        }
+    }
+
+    QVarLengthArray<int, 64> tiles;
+    for (int i = 0; i < tileNodes.size(); ++i) {
+        if (!tileNodes.at(i).isEmpty())
+            tiles.append(i);
+    }
+
+    // The tile images share the pixel data of the target, so make sure not to
+    // detach it from the buffer that the painter paints on.
+    uchar *bits = const_cast<uchar *>(target->constBits());
+    const qsizetype bytesPerLine = target->bytesPerLine();
+    const int bytesPerPixel = target->depth() / 8;
+    QSGSoftwareRenderableNode *backgroundNode = m_renderableNodes.constFirst();
+    QMutex glyphMutex;
+
+    auto renderTile = [&](int tile) {
+        const QRect tileRect = QRect((tile % columns) * tileSize, (tile / columns) * tileSize,
+                                     tileSize, tileSize).intersected(targetRect);
+        QImage tileImage(bits + tileRect.y() * bytesPerLine + tileRect.x() * bytesPerPixel,
+                         tileRect.width(), tileRect.height(), bytesPerLine, target->format());
+        tileImage.setDevicePixelRatio(dpr);
+
+        QPainter tilePainter(&tileImage);
+        tilePainter.setRenderHints(painter->renderHints());
+        tilePainter.setWindow(painter->window());
+        tilePainter.setViewport(painter->viewport().translated(-tileRect.topLeft() / intDpr));
+
+        for (QSGSoftwareRenderableNode *node : std::as_const(tileNodes.at(tile))) {
+            const bool forceOpaquePainting = node == backgroundNode;
+            if (node->type() == QSGSoftwareRenderableNode::Glyph) {
+                // Font engines cache glyphs without any locking
+                QMutexLocker locker(&glyphMutex);
+                node->paint(&tilePainter, node->dirtyRegion(), forceOpaquePainting);
+            } else {
+                node->paint(&tilePainter, node->dirtyRegion(), forceOpaquePainting);
+            }
+        }
+    };
+
+    // The calling thread renders tiles as well, the helpers just pick up
+    // tiles that are not taken yet.
+    QAtomicInt nextTile = 0;
+    auto renderTiles = [&]() {
+        for (int i = nextTile.fetchAndAddRelaxed(1); i < tiles.size(); i = nextTile.fetchAndAddRelaxed(1))
+            renderTile(tiles.at(i));
+    };
+
+    const int helperCount = qMin(m_renderThreadCount, int(tiles.size())) - 1;
+    QSemaphore helpersDone;
+    if (helperCount > 0) {
+        QThreadPool *pool = qsgSoftwareTileThreadPool();
+        if (pool->maxThreadCount() < helperCount)
+            pool->setMaxThreadCount(helperCount);
+        for (int i = 0; i < helperCount; ++i) {
+            pool->start([&]() {
+                renderTiles();
+                helpersDone.release();
+            });
+        }
+    }
+    renderTiles();
+    helpersDone.acquire(qMax(0, helperCount));
+
+    qCDebug(lc2DRender) << "rendered" << tiles.size() << "tiles with" << helperCount + 1 << "threads";
+
+    QRegion dirtyRegion;
+    for (QSGSoftwareRenderableNode *node : std::as_const(m_renderableNodes))
+        dirtyRegion += node->markAsPainted();
+    return dirtyRegion;
+}
+
 void QSGAbstractSoftwareRenderer::buildRenderList()
 {
     // Clear the previous renderlist
@@ -117,12 +306,38 @@ void QSGAbstractSoftwareRenderer::buildRenderList()
     QSGSoftwareRenderListBuilder(this).visitChildren(rootNode());
 }
 
+static bool isCovered(const QRect &rect, const QRegion &region)
+{
+    return !rect.isEmpty() && region.intersects(rect) && QRegion(rect).subtracted(region).isEmpty();
+}
+
 QRegion QSGAbstractSoftwareRenderer::optimizeRenderList()
 {
+    m_culledNodes.fill(false, m_renderableNodes.size());
+    m_culledNodeCount = 0;
+
     // Iterate through the renderlist from front to back
     // Objective is to update the dirty status and rects.
-    for (auto i = m_renderableNodes.rbegin(); i != m_renderableNodes.rend(); ++i) {
-        auto node = *i;
+    for (qsizetype index = m_renderableNodes.size() - 1; index >= 0; --index) {
+        auto node = m_renderableNodes.at(index);
+
+        // Nodes that are completely covered by opaque nodes in front of them
+        // are culled, so that they need neither dirty region updates nor
+        // painting. The area they were previously painted in still needs
+        // to be repainted by the nodes below if they moved.
+        if (node->type() != QSGSoftwareRenderableNode::RenderNode
+                && isCovered(node->boundingRectMax(), m_obscuredRegion)) {
+            if (node->isDirty()) {
+                QRegion prevDirty = node->previousDirtyRegion();
+                if (!prevDirty.isNull())
+                    m_dirtyRegion += prevDirty;
+            }
+            node->markAsCulled();
+            m_culledNodes.setBit(index);
+            ++m_culledNodeCount;
+            continue;
+        }
+
         if (!m_dirtyRegion.isEmpty()) {
             // See if the current dirty regions apply to the current node
             node->addDirtyRegion(m_dirtyRegion, true);
@@ -175,8 +390,11 @@ QRegion QSGAbstractSoftwareRenderer::optimizeRenderList()
 
     // Iterate through the renderlist from back to front
     // Objective is to make sure all non-opaque items are painted when an item under them is dirty
-    for (auto j = m_renderableNodes.begin(); j != m_renderableNodes.end(); ++j) {
-        auto node = *j;
+    for (qsizetype index = 0; index < m_renderableNodes.size(); ++index) {
+        if (m_culledNodes.testBit(index))
+            continue;
+
+        auto node = m_renderableNodes.at(index);
 
         if ((!node->isOpaque() || node->boundingRectMax() != node->boundingRectMin()) && !m_dirtyRegion.isEmpty()) {
             // Blended nodes need to be updated
@@ -17,6 +17,7 @@
 
 #include <private/qsgrenderer_p.h>
 
+#include <QtCore/QBitArray>
 #include <QtCore/QHash>
 
 QT_BEGIN_NAMESPACE
@@ -40,6 +41,12 @@ public:
 
     void markDirty();
 
+    int renderThreadCount() const { return m_renderThreadCount; }
+    void setRenderThreadCount(int count);
+
+    // only known after calling optimizeRenderList()
+    int culledNodeCount() const { return m_culledNodeCount; }
+
 protected:
     QRegion renderNodes(QPainter *painter);
     void buildRenderList();
@@ -54,6 +61,9 @@ protected:
     const QVector<QSGSoftwareRenderableNode*> &renderableNodes() const;
 
 private:
+    QImage *tiledRenderTarget(QPainter *painter) const;
+    QRegion renderNodesTiled(QPainter *painter, QImage *target);
+
     void nodeAdded(QSGNode *node);
     void nodeRemoved(QSGNode *node);
     void nodeGeometryUpdated(QSGNode *node);
@@ -70,6 +80,11 @@ private:
     QRegion m_obscuredRegion;
     qreal m_devicePixelRatio = 1;
     bool m_isOpaque = false;
+    int m_renderThreadCount = 1;
+
+    // Nodes completely covered by opaque nodes, found by optimizeRenderList()
+    QBitArray m_culledNodes;
+    int m_culledNodeCount = 0;
 
     QSGSoftwareRenderableNodeUpdater *m_nodeUpdater;
 };
@@ -2,10 +2,78 @@
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qsgsoftwareglyphnode_p.h"
+#include <QtCore/qmath.h>
+#include <QtCore/qmutex.h>
 #include <QtGui/private/qrawfont_p.h>
 
 QT_BEGIN_NAMESPACE
 
+/*
+    Keeps the rasterized glyph runs of all glyph nodes within a memory budget,
+    evicting the least recently painted ones first. The budget is set with the
+    QSG_SOFTWARE_GLYPH_CACHE_SIZE environment variable in kilobytes, and is 0
+    (no caching) by default. Glyph nodes of different windows can be painted
+    on different render threads, so everything is guarded by one mutex.
+*/
+class QSGSoftwareGlyphImageCache
+{
+public:
+    QSGSoftwareGlyphImageCache()
+        : budget(qsizetype(qMax(0, qEnvironmentVariableIntValue("QSG_SOFTWARE_GLYPH_CACHE_SIZE"))) * 1024)
+    {
+    }
+
+    void unlink(QSGSoftwareGlyphNode *node)
+    {
+        if (node->m_lessRecentlyUsed)
+            node->m_lessRecentlyUsed->m_moreRecentlyUsed = node->m_moreRecentlyUsed;
+        else if (leastRecentlyUsed == node)
+            leastRecentlyUsed = node->m_moreRecentlyUsed;
+        if (node->m_moreRecentlyUsed)
+            node->m_moreRecentlyUsed->m_lessRecentlyUsed = node->m_lessRecentlyUsed;
+        else if (mostRecentlyUsed == node)
+            mostRecentlyUsed = node->m_lessRecentlyUsed;
+        node->m_lessRecentlyUsed = nullptr;
+        node->m_moreRecentlyUsed = nullptr;
+    }
+
+    void touch(QSGSoftwareGlyphNode *node)
+    {
+        if (mostRecentlyUsed == node)
+            return;
+        unlink(node);
+        node->m_lessRecentlyUsed = mostRecentlyUsed;
+        if (mostRecentlyUsed)
+            mostRecentlyUsed->m_moreRecentlyUsed = node;
+        mostRecentlyUsed = node;
+        if (!leastRecentlyUsed)
+            leastRecentlyUsed = node;
+    }
+
+    void release(QSGSoftwareGlyphNode *node)
+    {
+        if (node->m_cachedImage.isNull())
+            return;
+        size -= node->m_cachedImage.sizeInBytes();
+        node->m_cachedImage = QImage();
+        unlink(node);
+    }
+
+    void evict()
+    {
+        while (size > budget && leastRecentlyUsed && leastRecentlyUsed != mostRecentlyUsed)
+            release(leastRecentlyUsed);
+    }
+
+    QMutex mutex;
+    QSGSoftwareGlyphNode *leastRecentlyUsed = nullptr;
+    QSGSoftwareGlyphNode *mostRecentlyUsed = nullptr;
+    qsizetype size = 0;
+    qsizetype budget;
+};
+
+Q_GLOBAL_STATIC(QSGSoftwareGlyphImageCache, qsgSoftwareGlyphImageCache)
+
 QSGSoftwareGlyphNode::QSGSoftwareGlyphNode()
     : m_geometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 0)
     , m_style(QQuickText::Normal)
@@ -14,6 +82,55 @@ QSGSoftwareGlyphNode::QSGSoftwareGlyphNode()
     setGeometry(&m_geometry);
 }
 
+QSGSoftwareGlyphNode::~QSGSoftwareGlyphNode()
+{
+    invalidateCachedImage();
+}
+
+qsizetype QSGSoftwareGlyphNode::imageCacheBudget()
+{
+    QSGSoftwareGlyphImageCache *cache = qsgSoftwareGlyphImageCache();
+    QMutexLocker locker(&cache->mutex);
+    return cache->budget;
+}
+
+void QSGSoftwareGlyphNode::setImageCacheBudget(qsizetype bytes)
+{
+    QSGSoftwareGlyphImageCache *cache = qsgSoftwareGlyphImageCache();
+    QMutexLocker locker(&cache->mutex);
+    cache->budget = qMax(qsizetype(0), bytes);
+    cache->evict();
+    if (!cache->budget && cache->leastRecentlyUsed)
+        cache->release(cache->leastRecentlyUsed);
+}
+
+// For autotests
+qsizetype QSGSoftwareGlyphNode::imageCacheSize()
+{
+    QSGSoftwareGlyphImageCache *cache = qsgSoftwareGlyphImageCache();
+    QMutexLocker locker(&cache->mutex);
+    return cache->size;
+}
+
+// For autotests
+bool QSGSoftwareGlyphNode::hasCachedImage() const
+{
+    QSGSoftwareGlyphImageCache *cache = qsgSoftwareGlyphImageCache();
+    QMutexLocker locker(&cache->mutex);
+    return !m_cachedImage.isNull();
+}
+
+void QSGSoftwareGlyphNode::invalidateCachedImage()
+{
+    // The cached image and the LRU links can be changed by eviction from
+    // another render thread at any time, so they're only read with the lock.
+    if (QSGSoftwareGlyphImageCache *cache = qsgSoftwareGlyphImageCache()) {
+        QMutexLocker locker(&cache->mutex);
+        cache->release(this);
+        cache->unlink(this);
+    }
+}
+
 namespace {
 QRectF calculateBoundingRect(const QPointF &position, const QGlyphRun &glyphs)
 {
@@ -60,21 +177,25 @@ void QSGSoftwareGlyphNode::setGlyphs(const QPointF &position, const QGlyphRun &g
     m_position = position;
     m_glyphRun = glyphs;
     m_bounding_rect = calculateBoundingRect(position, glyphs);
+    invalidateCachedImage();
 }
 
 void QSGSoftwareGlyphNode::setColor(const QColor &color)
 {
     m_color = color;
+    invalidateCachedImage();
 }
 
 void QSGSoftwareGlyphNode::setStyle(QQuickText::TextStyle style)
 {
     m_style = style;
+    invalidateCachedImage();
 }
 
 void QSGSoftwareGlyphNode::setStyleColor(const QColor &color)
 {
     m_styleColor = color;
+    invalidateCachedImage();
 }
 
 QPointF QSGSoftwareGlyphNode::baseLine() const
@@ -91,13 +212,78 @@ void QSGSoftwareGlyphNode::update()
 }
 
 void QSGSoftwareGlyphNode::paint(QPainter *painter)
+{
+    const qreal devicePixelRatio = painter->device()->devicePixelRatio();
+    QSGSoftwareGlyphImageCache *cache = qsgSoftwareGlyphImageCache();
+    if (!cache || m_bounding_rect.isEmpty()) {
+        paintGlyphRun(painter, devicePixelRatio);
+        return;
+    }
+
+    // The rasterized glyph run only depends on the fractional part of the
+    // translation, so it can be reused wherever the text is moved by whole
+    // device pixels.
+    const QTransform deviceTransform = painter->deviceTransform();
+    const qreal dx = qFloor(deviceTransform.dx());
+    const qreal dy = qFloor(deviceTransform.dy());
+    const QTransform imageTransform = deviceTransform * QTransform::fromTranslate(-dx, -dy);
+
+    QImage image;
+    QPoint imageOffset;
+    {
+        QMutexLocker locker(&cache->mutex);
+        if (!cache->budget) {
+            locker.unlock();
+            paintGlyphRun(painter, devicePixelRatio);
+            return;
+        }
+
+        if (m_cachedImage.isNull() || m_cachedTransform != imageTransform) {
+            cache->release(this);
+            locker.unlock();
+
+            // Leave room for the style offsets and antialiasing
+            const QRect imageRect = imageTransform.mapRect(m_bounding_rect).toAlignedRect().adjusted(-2, -2, 2, 2);
+            image = QImage(imageRect.size(), QImage::Format_ARGB32_Premultiplied);
+            image.fill(Qt::transparent);
+            QPainter imagePainter(&image);
+            imagePainter.setRenderHints(painter->renderHints());
+            imagePainter.setTransform(imageTransform * QTransform::fromTranslate(-imageRect.x(), -imageRect.y()));
+            paintGlyphRun(&imagePainter, devicePixelRatio);
+            imagePainter.end();
+
+            locker.relock();
+            cache->release(this);
+            m_cachedImage = image;
+            m_cachedImageOffset = imageRect.topLeft();
+            m_cachedTransform = imageTransform;
+            cache->size += image.sizeInBytes();
+        }
+
+        image = m_cachedImage;
+        imageOffset = m_cachedImageOffset;
+        cache->touch(this);
+        cache->evict();
+    }
+
+    // Blit the image to whole device pixels, by cancelling out the view and
+    // high-dpi scaling transforms.
+    const QTransform viewTransform = painter->worldTransform().inverted() * deviceTransform;
+    painter->save();
+    painter->setWorldTransform(QTransform::fromTranslate(dx + imageOffset.x(), dy + imageOffset.y())
+                               * viewTransform.inverted());
+    painter->drawImage(QPointF(0, 0), image);
+    painter->restore();
+}
+
+void QSGSoftwareGlyphNode::paintGlyphRun(QPainter *painter, qreal devicePixelRatio)
 {
     painter->setBrush(QBrush());
     QPointF pos = m_position - QPointF(0, m_glyphRun.rawFont().ascent());
 
     qreal offset = 1.0;
-    if (painter->device()->devicePixelRatio() > 0.0)
-        offset = 1.0 / painter->device()->devicePixelRatio();
+    if (devicePixelRatio > 0.0)
+        offset = 1.0 / devicePixelRatio;
 
     switch (m_style) {
     case QQuickText::Normal: break;
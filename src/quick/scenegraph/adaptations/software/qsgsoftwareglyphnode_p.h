@@ -19,10 +19,11 @@
 
 QT_BEGIN_NAMESPACE
 
-class QSGSoftwareGlyphNode : public QSGGlyphNode
+class Q_QUICK_PRIVATE_EXPORT QSGSoftwareGlyphNode : public QSGGlyphNode
 {
 public:
     QSGSoftwareGlyphNode();
+    ~QSGSoftwareGlyphNode() override;
 
     void setGlyphs(const QPointF &position, const QGlyphRun &glyphs) override;
     void setColor(const QColor &color) override;
@@ -34,13 +35,32 @@ public:
 
     void paint(QPainter *painter);
 
+    static qsizetype imageCacheBudget();
+    static void setImageCacheBudget(qsizetype bytes);
+    static qsizetype imageCacheSize();
+    bool hasCachedImage() const;
+
 private:
+    friend class QSGSoftwareGlyphImageCache;
+
+    void paintGlyphRun(QPainter *painter, qreal devicePixelRatio);
+    void invalidateCachedImage();
+
     QPointF m_position;
     QGlyphRun m_glyphRun;
     QColor m_color;
     QSGGeometry m_geometry;
     QQuickText::TextStyle m_style;
     QColor m_styleColor;
+
+    // The glyph run rasterized for the device transform in m_cachedTransform,
+    // with the integer part of its translation removed. Guarded by the mutex
+    // of the image cache, which also links the nodes in LRU order.
+    QImage m_cachedImage;
+    QPoint m_cachedImageOffset;
+    QTransform m_cachedTransform;
+    QSGSoftwareGlyphNode *m_lessRecentlyUsed = nullptr;
+    QSGSoftwareGlyphNode *m_moreRecentlyUsed = nullptr;
 };
 
 QT_END_NAMESPACE
@@ -238,14 +238,19 @@ void QSGSoftwareInternalRectangleNode::update()
     }
 }
 
-void QSGSoftwareInternalRectangleNode::paint(QPainter *painter)
+void QSGSoftwareInternalRectangleNode::updateCornerPixmap(qreal devicePixelRatio)
 {
     //We can only check for a device pixel ratio change when we know what
     //paint device is being used.
-    if (!qFuzzyCompare(painter->device()->devicePixelRatio(), m_devicePixelRatio)) {
-        m_devicePixelRatio = painter->device()->devicePixelRatio();
+    if (!qFuzzyCompare(devicePixelRatio, m_devicePixelRatio)) {
+        m_devicePixelRatio = devicePixelRatio;
         generateCornerPixmap();
     }
+}
+
+void QSGSoftwareInternalRectangleNode::paint(QPainter *painter)
+{
+    updateCornerPixmap(painter->device()->devicePixelRatio());
 
     if (painter->transform().isRotating()) {
         //Rotated rectangles lose the benefits of direct rendering, and have poor rendering
@@ -45,6 +45,7 @@ public:
     void update() override;
 
     void paint(QPainter *);
+    void updateCornerPixmap(qreal devicePixelRatio);
 
     bool isOpaque() const;
     QRectF rect() const;
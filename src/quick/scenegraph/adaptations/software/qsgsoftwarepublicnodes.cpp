@@ -60,8 +60,7 @@ void QSGSoftwareImageNode::setTextureCoordinatesTransform(QSGImageNode::TextureC
 
 void QSGSoftwareImageNode::paint(QPainter *painter)
 {
-    if (m_cachedMirroredPixmapIsDirty)
-        updateCachedMirroredPixmap();
+    updateCachedMirroredPixmap();
 
     painter->setRenderHint(QPainter::SmoothPixmapTransform, (m_filtering == QSGTexture::Linear));
     // Disable antialiased clipping. It causes transformed tiles to have gaps.
@@ -83,6 +82,9 @@ void QSGSoftwareImageNode::paint(QPainter *painter)
 
 void QSGSoftwareImageNode::updateCachedMirroredPixmap()
 {
+    if (!m_cachedMirroredPixmapIsDirty)
+        return;
+
     if (m_transformMode == NoTransform) {
         m_cachedPixmap = QPixmap();
     } else {
@@ -72,9 +72,9 @@ public:
     bool ownsTexture() const override { return m_owns; }
 
     void paint(QPainter *painter);
+    void updateCachedMirroredPixmap();
 
 private:
-    void updateCachedMirroredPixmap();
 
     QPixmap m_cachedPixmap;
     QSGTexture *m_texture;
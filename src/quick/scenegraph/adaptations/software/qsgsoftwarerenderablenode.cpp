@@ -211,14 +211,7 @@ QRegion QSGSoftwareRenderableNode::renderNode(QPainter *painter, bool forceOpaqu
 {
     Q_ASSERT(painter);
 
-    // Check for don't paint conditions
-    if (m_nodeType != RenderNode) {
-        if (!m_isDirty || qFuzzyIsNull(m_opacity) || m_dirtyRegion.isEmpty()) {
-            m_isDirty = false;
-            m_dirtyRegion = QRegion();
-            return QRegion();
-        }
-    } else {
+    if (m_nodeType == RenderNode) {
         if (!m_isDirty || qFuzzyIsNull(m_opacity)) {
             m_isDirty = false;
             m_dirtyRegion = QRegion();
@@ -250,12 +243,56 @@ QRegion QSGSoftwareRenderableNode::renderNode(QPainter *painter, bool forceOpaqu
         }
     }
 
+    // Check for don't paint conditions
+    if (needsPainting())
+        paint(painter, m_dirtyRegion, forceOpaquePainting);
+
+    return markAsPainted();
+}
+
+bool QSGSoftwareRenderableNode::needsPainting() const
+{
+    if (!m_isDirty || qFuzzyIsNull(m_opacity))
+        return false;
+    return m_nodeType == RenderNode || !m_dirtyRegion.isEmpty();
+}
+
+/*!
+    \internal
+
+    Updates the caches that some nodes generate lazily when painting, so that
+    paint() can afterwards be called from several threads at the same time.
+ */
+void QSGSoftwareRenderableNode::preparePaint(qreal devicePixelRatio)
+{
+    switch (m_nodeType) {
+    case QSGSoftwareRenderableNode::Rectangle:
+        m_handle.rectangleNode->updateCornerPixmap(devicePixelRatio);
+        break;
+    case QSGSoftwareRenderableNode::SimpleImage:
+        static_cast<QSGSoftwareImageNode *>(m_handle.simpleImageNode)->updateCachedMirroredPixmap();
+        break;
+    default:
+        break;
+    }
+}
+
+/*!
+    \internal
+
+    Paints the node with \a painter, clipped to \a clipRegion in world
+    coordinates, without touching the dirty state of the node.
+ */
+void QSGSoftwareRenderableNode::paint(QPainter *painter, const QRegion &clipRegion, bool forceOpaquePainting) const
+{
+    Q_ASSERT(m_nodeType != RenderNode);
+
     painter->save();
     painter->setOpacity(m_opacity);
 
-    // Set clipRegion to m_dirtyRegion (in world coordinates, so must be done before the setTransform below)
+    // Set clipRegion to the dirty region (in world coordinates, so must be done before the setTransform below)
     // as m_dirtyRegion already accounts for clipRegion
-    painter->setClipRegion(m_dirtyRegion, Qt::ReplaceClip);
+    painter->setClipRegion(clipRegion, Qt::ReplaceClip);
     if (m_clipRegion.rectCount() > 1)
         painter->setClipRegion(m_clipRegion, Qt::IntersectClip);
 
@@ -310,15 +347,41 @@ QRegion QSGSoftwareRenderableNode::renderNode(QPainter *painter, bool forceOpaqu
     }
 
     painter->restore();
+}
 
-    QRegion areaToBeFlushed = m_dirtyRegion;
-    m_previousDirtyRegion = QRegion(m_boundingRectMax);
+/*!
+    \internal
+
+    Marks the node as clean after it has been painted, and returns the area
+    that needs to be flushed for it.
+ */
+QRegion QSGSoftwareRenderableNode::markAsPainted()
+{
+    QRegion areaToBeFlushed;
+    if (needsPainting()) {
+        areaToBeFlushed = m_dirtyRegion;
+        m_previousDirtyRegion = QRegion(m_boundingRectMax);
+    }
     m_isDirty = false;
     m_dirtyRegion = QRegion();
 
     return areaToBeFlushed;
 }
 
+/*!
+    \internal
+
+    Marks the node as clean without painting it, because it is completely
+    covered by opaque nodes. None of its pixels are visible after this frame,
+    so nothing needs to be repainted when it moves, until it's painted again.
+ */
+void QSGSoftwareRenderableNode::markAsCulled()
+{
+    m_previousDirtyRegion = QRegion(m_boundingRectMax);
+    m_isDirty = false;
+    m_dirtyRegion = QRegion();
+}
+
 bool QSGSoftwareRenderableNode::isDirtyRegionEmpty() const
 {
     return m_dirtyRegion.isEmpty();
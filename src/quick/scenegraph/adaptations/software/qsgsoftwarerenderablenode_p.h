@@ -62,6 +62,13 @@ public:
     void update();
 
     QRegion renderNode(QPainter *painter, bool forceOpaquePainting = false);
+
+    bool needsPainting() const;
+    void preparePaint(qreal devicePixelRatio);
+    void paint(QPainter *painter, const QRegion &clipRegion, bool forceOpaquePainting = false) const;
+    QRegion markAsPainted();
+    void markAsCulled();
+
     QRect boundingRectMin() const { return m_boundingRectMin; }
     QRect boundingRectMax() const { return m_boundingRectMax; }
     NodeType type() const { return m_nodeType; }
@@ -8,12 +8,15 @@
 #include <qmath.h>
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThreadPool>
 #include <QtCore/QtNumeric>
 
 #include <QtGui/QGuiApplication>
 
 #include <private/qnumeric_p.h>
 #include "qsgmaterialshader_p.h"
+#include <QtQuick/qsgvertexcolormaterial.h>
 
 #include "qsgrhivisualizer_p.h"
 
@@ -30,6 +33,36 @@ int qt_sg_envInt(const char *name, int defaultValue);
 namespace QSGBatchRenderer
 {
 
+Q_GLOBAL_STATIC(QThreadPool, qsgBatchRendererThreadPool)
+
+// Calls work(i) for each i in [0, count) with up to threadCount threads, one
+// of them being the calling thread, and returns when all are done.
+template <typename Work>
+static void qsg_parallelFor(int threadCount, int count, Work work)
+{
+    QAtomicInt next = 0;
+    auto run = [&]() {
+        for (int i = next.fetchAndAddRelaxed(1); i < count; i = next.fetchAndAddRelaxed(1))
+            work(i);
+    };
+
+    const int helperCount = qMin(threadCount, count) - 1;
+    QSemaphore helpersDone;
+    if (helperCount > 0) {
+        QThreadPool *pool = qsgBatchRendererThreadPool();
+        if (pool->maxThreadCount() < helperCount)
+            pool->setMaxThreadCount(helperCount);
+        for (int i = 0; i < helperCount; ++i) {
+            pool->start([&]() {
+                run();
+                helpersDone.release();
+            });
+        }
+    }
+    run();
+    helpersDone.acquire(qMax(0, helperCount));
+}
+
 #define DECLARE_DEBUG_VAR(variable) \
     static bool debug_ ## variable() \
     { static bool value = qgetenv("QSG_RENDERER_DEBUG").contains(QT_STRINGIFY(variable)); return value; }
@@ -81,8 +114,17 @@ static bool is2DSafe(const QMatrix4x4 &m) { return m.flags() < QMatrix4x4::Rotat
 const float OPAQUE_LIMIT                = 0.999f;
 
 const uint DYNAMIC_VERTEX_INDEX_BUFFER_THRESHOLD = 4;
+// Below this, handing out the work costs more than it saves
+const int PARALLEL_UPLOAD_VERTEX_THRESHOLD = 8192;
+const int PARALLEL_BOUNDS_CHUNK_SIZE = 256;
+// Percentage of a merged batch's buffers left unused by shrunk elements before
+// the batch is compacted by a full upload
+const int PARTIAL_UPLOAD_FRAGMENTATION_THRESHOLD = 25;
+// Fewer identical elements than this are merged as usual
+const int INSTANCING_ELEMENT_THRESHOLD = 16;
 const int VERTEX_BUFFER_BINDING = 0;
 const int ZORDER_BUFFER_BINDING = VERTEX_BUFFER_BINDING + 1;
+const int INSTANCE_BUFFER_BINDING = VERTEX_BUFFER_BINDING + 1;
 
 const float VIEWPORT_MIN_DEPTH = 0.0f;
 const float VIEWPORT_MAX_DEPTH = 1.0f;
@@ -258,6 +300,111 @@ ShaderManager::Shader *ShaderManager::prepareMaterialNoRewrite(QSGMaterial *mate
     return shader;
 }
 
+/*
+    Instanced batches of vertex colored elements store the shape once, as
+    plain positions, and per element an InstanceData entry holding where the
+    shape goes, its render order and its color. The shader adds the offset
+    to the shape and takes the color from the instance, otherwise it is the
+    same as the one of QSGVertexColorMaterial.
+ */
+struct InstanceData
+{
+    float x;
+    float y;
+    float z;
+    uchar color[4];
+};
+
+class InstancedVertexColorShader : public QSGMaterialShader
+{
+public:
+    InstancedVertexColorShader()
+    {
+        setShaderFileName(VertexStage, QStringLiteral(":/qt-project.org/scenegraph/shaders_ng/vertexcolor_instanced.vert.qsb"));
+        setShaderFileName(FragmentStage, QStringLiteral(":/qt-project.org/scenegraph/shaders_ng/vertexcolor.frag.qsb"));
+    }
+
+    bool updateUniformData(RenderState &state, QSGMaterial *, QSGMaterial *) override
+    {
+        bool changed = false;
+        QByteArray *buf = state.uniformData();
+
+        if (state.isMatrixDirty()) {
+            const QMatrix4x4 m = state.combinedMatrix();
+            memcpy(buf->data(), m.constData(), 64);
+            changed = true;
+        }
+
+        if (state.isOpacityDirty()) {
+            const float opacity = state.opacity();
+            memcpy(buf->data() + 64, &opacity, 4);
+            changed = true;
+        }
+
+        return changed;
+    }
+};
+
+static QRhiVertexInputLayout calculateInstancedVertexInputLayout(const QSGMaterialShader *s, bool batchable)
+{
+    const QSGMaterialShaderPrivate *sd = QSGMaterialShaderPrivate::get(s);
+    if (!sd->vertexShader) {
+        qWarning("No vertex shader in QSGMaterialShader %p", s);
+        return QRhiVertexInputLayout();
+    }
+
+    QVarLengthArray<QRhiVertexInputAttribute, 4> inputAttributes;
+    inputAttributes.append(QRhiVertexInputAttribute(VERTEX_BUFFER_BINDING, 0, QRhiVertexInputAttribute::Float2, 0));
+    inputAttributes.append(QRhiVertexInputAttribute(INSTANCE_BUFFER_BINDING, 1, QRhiVertexInputAttribute::Float2,
+                                                    offsetof(InstanceData, x)));
+    inputAttributes.append(QRhiVertexInputAttribute(INSTANCE_BUFFER_BINDING, 2, QRhiVertexInputAttribute::UNormByte4,
+                                                    offsetof(InstanceData, color)));
+    if (batchable) {
+        inputAttributes.append(QRhiVertexInputAttribute(INSTANCE_BUFFER_BINDING, sd->vertexShader->qt_order_attrib_location,
+                                                        QRhiVertexInputAttribute::Float, offsetof(InstanceData, z)));
+    }
+
+    const QRhiVertexInputBinding inputBindings[] = {
+        QRhiVertexInputBinding(2 * sizeof(float)),
+        QRhiVertexInputBinding(sizeof(InstanceData), QRhiVertexInputBinding::PerInstance)
+    };
+
+    QRhiVertexInputLayout inputLayout;
+    inputLayout.setBindings(std::cbegin(inputBindings), std::cend(inputBindings));
+    inputLayout.setAttributes(inputAttributes.cbegin(), inputAttributes.cend());
+
+    return inputLayout;
+}
+
+ShaderManager::Shader *ShaderManager::prepareInstancedVertexColor(bool batchable)
+{
+    // Not a real material, only there to key the shader
+    static QSGMaterialType instancedVertexColorType;
+
+    ShaderKey key = qMakePair(&instancedVertexColorType, QSGRendererInterface::RenderMode2D);
+    QHash<ShaderKey, Shader *> &shaders = batchable ? rewrittenShaders : stockShaders;
+    Shader *shader = shaders.value(key, nullptr);
+    if (shader)
+        return shader;
+
+    shader = new Shader;
+    QSGMaterialShader *s = new InstancedVertexColorShader;
+    const QShader::Variant variant = batchable ? QShader::BatchableVertexShader : QShader::StandardShader;
+    context->initializeRhiShader(s, variant);
+    shader->materialShader = s;
+    shader->inputLayout = calculateInstancedVertexInputLayout(s, batchable);
+    QSGMaterialShaderPrivate *sD = QSGMaterialShaderPrivate::get(s);
+    shader->stages = {
+        { QRhiShaderStage::Vertex, sD->shader(QShader::VertexStage), variant },
+        { QRhiShaderStage::Fragment, sD->shader(QShader::FragmentStage) }
+    };
+
+    shader->lastOpacity = 0;
+
+    shaders[key] = shader;
+    return shader;
+}
+
 void ShaderManager::invalidated()
 {
     qDeleteAll(stockShaders);
@@ -774,6 +921,20 @@ bool Batch::isTranslateOnlyToRoot() const {
     return only;
 }
 
+bool Batch::canMerge() const
+{
+    QSGGeometryNode *gn = first->node;
+    QSGGeometry *g =  gn->geometry();
+    QSGMaterial::Flags flags = gn->activeMaterial()->flags();
+    return (g->drawingMode() == QSGGeometry::DrawTriangles || g->drawingMode() == QSGGeometry::DrawTriangleStrip ||
+            g->drawingMode() == QSGGeometry::DrawLines || g->drawingMode() == QSGGeometry::DrawPoints)
+            && positionAttribute >= 0
+            && (g->indexType() == QSGGeometry::UnsignedShortType && g->indexCount() > 0)
+            && (flags & (QSGMaterial::NoBatching | QSGMaterial_FullMatrix)) == 0
+            && ((flags & QSGMaterial::RequiresFullMatrixExceptTranslate) == 0 || isTranslateOnlyToRoot())
+            && isSafeToBatch();
+}
+
 /*
  * Iterates through all the nodes in the batch and returns true if the
  * nodes are all safe to batch. There are two separate criteria:
@@ -845,6 +1006,8 @@ Renderer::Renderer(QSGDefaultRenderContext *ctx, QSGRendererInterface::RenderMod
     , m_renderOrderRebuildLower(-1)
     , m_renderOrderRebuildUpper(-1)
 #endif
+    , m_uploadedBytes(0)
+    , m_partiallyUploadedBytes(0)
     , m_currentMaterial(nullptr)
     , m_currentShader(nullptr)
     , m_vertexUploadPool(256)
@@ -859,6 +1022,9 @@ Renderer::Renderer(QSGDefaultRenderContext *ctx, QSGRendererInterface::RenderMod
     if (qEnvironmentVariableIntValue("QSG_RHI_UINT32_INDEX"))
         m_uint32IndexForRhi = true;
 
+    m_partialUpdateEnabled = qEnvironmentVariableIntValue("QSG_PARTIAL_UPDATE");
+    m_instancingEnabled = qEnvironmentVariableIntValue("QSG_RENDERER_INSTANCING");
+
     m_visualizer = new RhiVisualizer(this);
 
     setNodeUpdater(new Updater(this));
@@ -877,10 +1043,11 @@ Renderer::Renderer(QSGDefaultRenderContext *ctx, QSGRendererInterface::RenderMod
     m_batchNodeThreshold = qt_sg_envInt("QSG_RENDERER_BATCH_NODE_THRESHOLD", 64);
     m_batchVertexThreshold = qt_sg_envInt("QSG_RENDERER_BATCH_VERTEX_THRESHOLD", 1024);
     m_srbPoolThreshold = qt_sg_envInt("QSG_RENDERER_SRB_POOL_THRESHOLD", 1024);
+    setUploadThreadCount(qt_sg_envInt("QSG_RENDERER_UPLOAD_THREADS", 1));
 
     if (Q_UNLIKELY(debug_build() || debug_render())) {
-        qDebug("Batch thresholds: nodes: %d vertices: %d Srb pool threshold: %d",
-               m_batchNodeThreshold, m_batchVertexThreshold, m_srbPoolThreshold);
+        qDebug("Batch thresholds: nodes: %d vertices: %d Srb pool threshold: %d Upload threads: %d",
+               m_batchNodeThreshold, m_batchVertexThreshold, m_srbPoolThreshold, m_uploadThreadCount);
     }
 }
 
@@ -945,6 +1112,7 @@ void Renderer::destroyGraphicsResources()
 
     qDeleteAll(m_samplers);
     m_stencilClipCommon.reset();
+    m_damageClear.reset();
     delete m_dummyTexture;
     m_visualizer->releaseResources();
 }
@@ -992,6 +1160,18 @@ void Renderer::map(Buffer *buffer, quint32 byteSize, bool isIndexBuf)
     buffer->size = byteSize;
 }
 
+void Renderer::updateBufferRange(Buffer *buffer, quint32 offset, quint32 size, const void *data)
+{
+    if (!size)
+        return;
+    if (buffer->buf->type() != QRhiBuffer::Dynamic)
+        m_resourceUpdates->uploadStaticBuffer(buffer->buf, offset, size, data);
+    else
+        m_resourceUpdates->updateDynamicBuffer(buffer->buf, offset, size, data);
+    m_uploadedBytes += size;
+    m_partiallyUploadedBytes += size;
+}
+
 void Renderer::unmap(Buffer *buffer, bool isIndexBuf)
 {
     // Batches are pooled and reused which means the QRhiBuffer will be
@@ -1036,6 +1216,7 @@ void Renderer::unmap(Buffer *buffer, bool isIndexBuf)
             m_resourceUpdates->updateDynamicBuffer(buffer->buf, 0, buffer->size,
                                                    buffer->data);
         }
+        m_uploadedBytes += buffer->size;
     }
     if (m_visualizer->mode() == Visualizer::VisualizeNothing)
         buffer->data = nullptr;
@@ -1128,6 +1309,7 @@ void Renderer::nodeWasTransformed(Node *node, int *vertexCount)
                     invalidateBatchAndOverlappingRenderOrders(e->batch);
                 } else if (e->batch->merged) {
                     e->batch->needsUpload = true;
+                    e->needsUpload = true;
                 }
             }
         }
@@ -1152,6 +1334,9 @@ void Renderer::nodeWasAdded(QSGNode *node, Node *shadowParent)
     if (node->type() == QSGNode::GeometryNodeType) {
         snode->data = m_elementAllocator.allocate();
         snode->element()->setNode(static_cast<QSGGeometryNode *>(node));
+        snode->element()->damageRect = QRect();
+        snode->element()->damaged = true;
+        snode->element()->needsUpload = false;
 
     } else if (node->type() == QSGNode::ClipNodeType) {
         snode->data = new ClipBatchRootInfo;
@@ -1194,6 +1379,8 @@ void Renderer::nodeWasRemoved(Node *node)
             e->removed = true;
             m_elementsToDelete.add(e);
             e->node = nullptr;
+            if (m_partialUpdateEnabled && !e->damageRect.isEmpty())
+                m_pendingDamage |= e->damageRect;
             if (e->root) {
                 BatchRootInfo *info = batchRootInfo(e->root);
                 info->availableOrders++;
@@ -1201,6 +1388,7 @@ void Renderer::nodeWasRemoved(Node *node)
             if (e->batch) {
                 e->batch->needsUpload = true;
                 e->batch->needsPurge = true;
+                e->batch->hasStableLayout = false;
             }
 
         }
@@ -1298,6 +1486,8 @@ void Renderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
 
         bool blocked = node->isSubtreeBlocked();
         if (blocked && sn) {
+            if (m_partialUpdateEnabled)
+                markSubtreeDamaged(sn);
             nodeChanged(node, QSGNode::DirtyNodeRemoved);
             Q_ASSERT(m_nodes.value(node) == 0);
         } else if (!blocked && !sn) {
@@ -1347,12 +1537,14 @@ void Renderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
         Element *e = shadowNode->element();
         if (e) {
             e->boundsComputed = false;
+            e->damaged = true;
             Batch *b = e->batch;
             if (b) {
                 if (!e->batch->geometryWasChanged(gn) || !e->batch->isOpaque) {
                     invalidateBatchAndOverlappingRenderOrders(e->batch);
                 } else {
                     b->needsUpload = true;
+                    e->needsUpload = true;
                 }
             }
         }
@@ -1361,6 +1553,7 @@ void Renderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
     if (state & QSGNode::DirtyMaterial && node->type() == QSGNode::GeometryNodeType) {
         Element *e = shadowNode->element();
         if (e) {
+            e->damaged = true;
             bool blended = hasMaterialWithBlending(static_cast<QSGGeometryNode *>(node));
             if (e->isMaterialBlended != blended) {
                 m_rebuild |= Renderer::FullRebuild;
@@ -1374,6 +1567,14 @@ void Renderer::nodeChanged(QSGNode *node, QSGNode::DirtyState state)
         }
     }
 
+    // Moving, fading or reclipping a subtree damages everything in it
+    if (m_partialUpdateEnabled) {
+        if (state & (QSGNode::DirtyMatrix | QSGNode::DirtyOpacity)
+                || (state & QSGNode::DirtyGeometry && node->type() == QSGNode::ClipNodeType)) {
+            markSubtreeDamaged(shadowNode);
+        }
+    }
+
     // Mark the shadow tree dirty all the way back to the root...
     QSGNode::DirtyState dirtyChain = state & (QSGNode::DirtyNodeAdded
                                               | QSGNode::DirtyOpacity
@@ -1723,12 +1924,24 @@ bool Renderer::checkOverlap(int first, int last, const Rect &bounds)
 
 void Renderer::prepareAlphaBatches()
 {
-    for (int i=0; i<m_alphaRenderList.size(); ++i) {
-        Element *e = m_alphaRenderList.at(i);
-        if (!e || e->isRenderNode)
-            continue;
-        Q_ASSERT(!e->removed);
-        e->ensureBoundsValid();
+    auto computeBounds = [this](int from, int to) {
+        for (int i = from; i < to; ++i) {
+            Element *e = m_alphaRenderList.at(i);
+            if (!e || e->isRenderNode)
+                continue;
+            Q_ASSERT(!e->removed);
+            e->ensureBoundsValid();
+        }
+    };
+    const int elementCount = m_alphaRenderList.size();
+    if (m_uploadThreadCount > 1 && elementCount > 2 * PARALLEL_BOUNDS_CHUNK_SIZE) {
+        const int chunkCount = (elementCount + PARALLEL_BOUNDS_CHUNK_SIZE - 1) / PARALLEL_BOUNDS_CHUNK_SIZE;
+        qsg_parallelFor(m_uploadThreadCount, chunkCount, [&](int chunk) {
+            const int from = chunk * PARALLEL_BOUNDS_CHUNK_SIZE;
+            computeBounds(from, qMin(from + PARALLEL_BOUNDS_CHUNK_SIZE, elementCount));
+        });
+    } else {
+        computeBounds(0, elementCount);
     }
 
     for (int i=0; i<m_alphaRenderList.size(); ++i) {
@@ -1969,39 +2182,128 @@ QMatrix4x4 qsg_matrixForRoot(Node *node)
 }
 
 void Renderer::uploadBatch(Batch *b)
+{
+    int vertexBufferSize;
+    int indexBufferSize;
+    if (!beginBatchUpload(b, &vertexBufferSize, &indexBufferSize))
+        return;
+
+    map(&b->ibo, indexBufferSize, true);
+    map(&b->vbo, vertexBufferSize);
+
+    fillBatch(b);
+    endBatchUpload(b);
+}
+
+/*
+    Uploads the batches that need it. With more than one upload thread, the
+    vertex and index data of the batches is merged in parallel, each batch
+    into its own part of the upload pools. Creating the buffers and queuing
+    the uploads stays on the calling thread, as QRhi is not thread safe.
+ */
+void Renderer::uploadBatches(const QDataBuffer<Batch *> &batches)
+{
+    if (m_uploadThreadCount <= 1 || m_visualizer->mode() != Visualizer::VisualizeNothing
+            || Q_UNLIKELY(debug_upload())) {
+        for (int i = 0; i < batches.size(); ++i)
+            uploadBatch(batches.at(i));
+        return;
+    }
+
+    struct PendingUpload {
+        Batch *batch;
+        int vertexBufferSize;
+        int indexBufferSize;
+        int vertexPoolOffset;
+        int indexPoolOffset;
+    };
+    QVarLengthArray<PendingUpload, 64> pending;
+    int vertexPoolSize = 0;
+    int indexPoolSize = 0;
+    int vertexCount = 0;
+    for (int i = 0; i < batches.size(); ++i) {
+        PendingUpload upload;
+        upload.batch = batches.at(i);
+        if (!beginBatchUpload(upload.batch, &upload.vertexBufferSize, &upload.indexBufferSize))
+            continue;
+        // Keep every batch's data aligned for the float and index writes
+        upload.vertexPoolOffset = vertexPoolSize;
+        upload.indexPoolOffset = indexPoolSize;
+        vertexPoolSize += (upload.vertexBufferSize + 15) & ~15;
+        indexPoolSize += (upload.indexBufferSize + 15) & ~15;
+        vertexCount += upload.batch->vertexCount;
+        pending.append(upload);
+    }
+
+    if (pending.size() < 2 || vertexCount < PARALLEL_UPLOAD_VERTEX_THRESHOLD) {
+        for (const PendingUpload &upload : std::as_const(pending)) {
+            map(&upload.batch->ibo, upload.indexBufferSize, true);
+            map(&upload.batch->vbo, upload.vertexBufferSize);
+            fillBatch(upload.batch);
+            endBatchUpload(upload.batch);
+        }
+        return;
+    }
+
+    if (vertexPoolSize > m_vertexUploadPool.size())
+        m_vertexUploadPool.resize(vertexPoolSize);
+    if (indexPoolSize > m_indexUploadPool.size())
+        m_indexUploadPool.resize(indexPoolSize);
+    for (const PendingUpload &upload : std::as_const(pending)) {
+        upload.batch->vbo.data = m_vertexUploadPool.data() + upload.vertexPoolOffset;
+        upload.batch->vbo.size = upload.vertexBufferSize;
+        upload.batch->ibo.data = m_indexUploadPool.data() + upload.indexPoolOffset;
+        upload.batch->ibo.size = upload.indexBufferSize;
+    }
+
+    qsg_parallelFor(m_uploadThreadCount, pending.size(), [&](int i) {
+        fillBatch(pending.at(i).batch);
+    });
+
+    for (const PendingUpload &upload : std::as_const(pending))
+        endBatchUpload(upload.batch);
+}
+
+bool Renderer::beginBatchUpload(Batch *b, int *vertexBufferSize, int *indexBufferSize)
 {
     // Early out if nothing has changed in this batch..
     if (!b->needsUpload) {
         if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "already uploaded...";
-        return;
+        return false;
     }
 
     if (!b->first) {
         if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "is invalid...";
-        return;
+        return false;
     }
 
     if (b->isRenderNode) {
         if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch: " << b << "is a render node...";
-        return;
+        return false;
     }
 
+    // Nothing left to fill when the changes could be applied in place
+    if (uploadBatchPartially(b))
+        return false;
+
     // Figure out if we can merge or not, if not, then just render the batch as is..
     Q_ASSERT(b->first);
     Q_ASSERT(b->first->node);
 
-    QSGGeometryNode *gn = b->first->node;
-    QSGGeometry *g =  gn->geometry();
-    QSGMaterial::Flags flags = gn->activeMaterial()->flags();
-    bool canMerge = (g->drawingMode() == QSGGeometry::DrawTriangles || g->drawingMode() == QSGGeometry::DrawTriangleStrip ||
-                     g->drawingMode() == QSGGeometry::DrawLines || g->drawingMode() == QSGGeometry::DrawPoints)
-            && b->positionAttribute >= 0
-            && (g->indexType() == QSGGeometry::UnsignedShortType && g->indexCount() > 0)
-            && (flags & (QSGMaterial::NoBatching | QSGMaterial_FullMatrix)) == 0
-            && ((flags & QSGMaterial::RequiresFullMatrixExceptTranslate) == 0 || b->isTranslateOnlyToRoot())
-            && b->isSafeToBatch();
-
-    b->merged = canMerge;
+    QSGGeometry *g = b->first->node->geometry();
+    b->merged = b->canMerge();
+    b->instanced = b->merged && canInstance(b);
+
+    if (b->instanced) {
+        b->instanceCount = 0;
+        for (Element *e = b->first; e; e = e->nextInBatch)
+            ++b->instanceCount;
+        b->vertexCount = g->vertexCount();
+        b->indexCount = g->indexCount();
+        *vertexBufferSize = b->vertexCount * 2 * sizeof(float) + b->instanceCount * sizeof(InstanceData);
+        *indexBufferSize = b->indexCount * mergedIndexElemSize();
+        return true;
+    }
 
     // Figure out how much memory we need...
     b->vertexCount = 0;
@@ -2028,7 +2330,7 @@ void Renderer::uploadBatch(Batch *b)
     // Abort if there are no vertices in this batch.. We abort this late as
     // this is a broken usecase which we do not care to optimize for...
     if (b->vertexCount == 0 || (b->merged && b->indexCount == 0))
-        return;
+        return false;
 
     /* Allocate memory for this batch. Merged batches are divided into three separate blocks
            1. Vertex data for all elements, as they were in the QSGGeometry object, but
@@ -2052,13 +2354,28 @@ void Renderer::uploadBatch(Batch *b)
         ibufferSize = unmergedIndexSize;
     }
 
-    map(&b->ibo, ibufferSize, true);
-    map(&b->vbo, bufferSize);
+    *vertexBufferSize = bufferSize;
+    *indexBufferSize = ibufferSize;
+    return true;
+}
+
+// Merges the vertex and index data of the batch into its mapped buffers. Only
+// touches the batch itself and reads the geometry, so batches can be filled
+// in parallel.
+void Renderer::fillBatch(Batch *b)
+{
+    QSGGeometryNode *gn = b->first->node;
+    QSGGeometry *g =  gn->geometry();
 
     if (Q_UNLIKELY(debug_upload())) qDebug() << " - batch" << b << " first:" << b->first << " root:"
                                              << b->root << " merged:" << b->merged << " positionAttribute" << b->positionAttribute
                                              << " vbo:" << b->vbo.buf << ":" << b->vbo.size;
 
+    if (b->instanced) {
+        fillInstancedBatch(b);
+        return;
+    }
+
     if (b->merged) {
         char *vertexData = b->vbo.data;
         char *zData = vertexData + b->vertexCount * g->sizeOfVertex();
@@ -2066,7 +2383,7 @@ void Renderer::uploadBatch(Batch *b)
 
         quint16 iOffset16 = 0;
         quint32 iOffset32 = 0;
-        e = b->first;
+        Element *e = b->first;
         uint verticesInSet = 0;
         // Start a new set already after 65534 vertices because 0xFFFF may be
         // used for an always-on primitive restart with some apis (adapt for
@@ -2097,7 +2414,16 @@ void Renderer::uploadBatch(Batch *b)
             void *iBasePtr = &iOffset16;
             if (m_uint32IndexForRhi)
                 iBasePtr = &iOffset32;
+            // Remember where the element went, so that it can later be
+            // updated without touching the rest of the batch
+            e->vertexOffset = vertexData - b->vbo.data;
+            e->zOffset = zData - b->vbo.data;
+            e->indexOffset = indexData - indexBase;
+            e->vertexBase = m_uint32IndexForRhi ? iOffset32 : iOffset16;
             uploadMergedElement(e, b->positionAttribute, &vertexData, &zData, &indexData, iBasePtr, &indicesInSet);
+            e->vertexCapacity = e->node->geometry()->vertexCount();
+            e->indexCapacity = (indexData - indexBase - e->indexOffset) / mergedIndexElemSize();
+            e->needsUpload = false;
             e = e->nextInBatch;
         }
         b->drawSets.last().indexCount = indicesInSet;
@@ -2134,6 +2460,7 @@ void Renderer::uploadBatch(Batch *b)
                 }
                 iboData += ibs;
             }
+            e->needsUpload = false;
             e = e->nextInBatch;
         }
     }
@@ -2201,18 +2528,216 @@ void Renderer::uploadBatch(Batch *b)
         }
     }
 #endif // QT_NO_DEBUG_OUTPUT
+}
 
+void Renderer::endBatchUpload(Batch *b)
+{
     unmap(&b->vbo);
     unmap(&b->ibo, true);
 
     if (Q_UNLIKELY(debug_upload())) qDebug() << "  --- vertex/index buffers unmapped, batch upload completed...";
 
     b->needsUpload = false;
+    b->hasStableLayout = b->merged && !b->instanced && b->vbo.buf && b->ibo.buf;
+    b->layoutZRange = m_zRange;
 
     if (Q_UNLIKELY(debug_render()))
         b->uploadedThisFrame = true;
 }
 
+/*
+    Batches of many elements whose geometry is identical up to a translation,
+    with one color per element, are drawn with instancing rather than merged.
+    This is limited to QSGVertexColorMaterial, which is what plain, non
+    antialiased rectangles use, as the shader must know about the instance
+    data.
+ */
+bool Renderer::canInstance(const Batch *b) const
+{
+    static QSGMaterialType *vertexColorType = QSGVertexColorMaterial().type();
+
+    if (!m_instancingEnabled || m_renderMode == QSGRendererInterface::RenderMode3D
+            || m_visualizer->mode() != Visualizer::VisualizeNothing
+            || !m_rhi->isFeatureSupported(QRhi::Instancing)) {
+        return false;
+    }
+
+    const QSGGeometryNode *gn = b->first->node;
+    const QSGGeometry *sg = gn->geometry();
+    if (gn->activeMaterial()->type() != vertexColorType
+            || sg->attributes() != QSGGeometry::defaultAttributes_ColoredPoint2D().attributes
+            || sg->indexType() != QSGGeometry::UnsignedShortType || sg->indexCount() == 0) {
+        return false;
+    }
+
+    const int vCount = sg->vertexCount();
+    const int iCount = sg->indexCount();
+    const QSGGeometry::ColoredPoint2D *sv = sg->vertexDataAsColoredPoint2D();
+    int count = 0;
+    for (const Element *e = b->first; e; e = e->nextInBatch) {
+        const QSGGeometry *g = e->node->geometry();
+        if (g->attributes() != sg->attributes() || g->drawingMode() != sg->drawingMode()
+                || g->vertexCount() != vCount || g->indexCount() != iCount
+                || g->indexType() != QSGGeometry::UnsignedShortType
+                || !isTranslate(*e->node->matrix())) {
+            return false;
+        }
+        const QSGGeometry::ColoredPoint2D *v = g->vertexDataAsColoredPoint2D();
+        for (int i = 0; i < vCount; ++i) {
+            if (memcmp(&v[i].r, &v[0].r, 4) != 0
+                    || v[i].x - v[0].x != sv[i].x - sv[0].x
+                    || v[i].y - v[0].y != sv[i].y - sv[0].y) {
+                return false;
+            }
+        }
+        if (g != sg && memcmp(g->indexData(), sg->indexData(), iCount * sizeof(quint16)) != 0)
+            return false;
+        ++count;
+    }
+
+    return count >= INSTANCING_ELEMENT_THRESHOLD;
+}
+
+void Renderer::fillInstancedBatch(Batch *b)
+{
+    const QSGGeometry *sg = b->first->node->geometry();
+    const QSGGeometry::ColoredPoint2D *sv = sg->vertexDataAsColoredPoint2D();
+
+    float *shape = (float *) b->vbo.data;
+    for (int i = 0; i < b->vertexCount; ++i) {
+        shape[2 * i] = sv[i].x - sv[0].x;
+        shape[2 * i + 1] = sv[i].y - sv[0].y;
+    }
+
+    const int instanceOffset = b->vertexCount * 2 * sizeof(float);
+    InstanceData *instance = (InstanceData *) (b->vbo.data + instanceOffset);
+    for (Element *e = b->first; e; e = e->nextInBatch) {
+        const QSGGeometry::ColoredPoint2D *v = e->node->geometry()->vertexDataAsColoredPoint2D();
+        const float *localxdata = e->node->matrix()->constData();
+        instance->x = v[0].x + localxdata[12];
+        instance->y = v[0].y + localxdata[13];
+        instance->z = useDepthBuffer() ? calculateElementZOrder(e, m_zRange) : 0.0f;
+        memcpy(instance->color, &v[0].r, 4);
+        e->needsUpload = false;
+        ++instance;
+    }
+
+    const quint16 *srcIndices = sg->indexDataAsUShort();
+    if (m_uint32IndexForRhi) {
+        quint32 *indices = (quint32 *) b->ibo.data;
+        for (int i = 0; i < b->indexCount; ++i)
+            indices[i] = srcIndices[i];
+    } else {
+        memcpy(b->ibo.data, srcIndices, b->indexCount * sizeof(quint16));
+    }
+
+    b->drawSets.reset();
+    b->drawSets << DrawSet(0, instanceOffset, 0);
+    b->drawSets.last().indexCount = b->indexCount;
+}
+
+/*
+    Merged batches keep their buffers between frames, with every element at a
+    fixed range of them. When only some elements changed, and each still fits
+    in its range, only those ranges are rewritten instead of the whole batch.
+    Elements that shrink leave part of their range unused, their remaining
+    triangles made degenerate. Once that wastes too much of the buffers, or an
+    element grows beyond its range, the batch is compacted by a full upload.
+ */
+bool Renderer::uploadBatchPartially(Batch *b)
+{
+    if (!b->hasStableLayout || b->needsPurge || !b->first || b->layoutZRange != m_zRange
+            || m_visualizer->mode() != Visualizer::VisualizeNothing
+            || !b->canMerge()) {
+        return false;
+    }
+
+    QSGGeometry *g = b->first->node->geometry();
+    const int drawingMode = g->drawingMode();
+    const int vSize = g->sizeOfVertex() + (useDepthBuffer() ? sizeof(float) : 0);
+    const int iSize = mergedIndexElemSize();
+    int dirtyElements = 0;
+    int dirtyBytes = 0;
+    int unusedBytes = 0;
+    for (Element *e = b->first; e; e = e->nextInBatch) {
+        QSGGeometry *eg = e->node->geometry();
+        const int vCount = eg->vertexCount();
+        const int iCount = qsg_fixIndexCount(eg->indexCount() ? eg->indexCount() : vCount, drawingMode);
+        if (vCount > e->vertexCapacity || iCount > e->indexCapacity)
+            return false;
+        if (drawingMode != QSGGeometry::DrawTriangles
+                && (vCount != e->vertexCapacity || iCount != e->indexCapacity)) {
+            return false;
+        }
+        unusedBytes += (e->vertexCapacity - vCount) * vSize + (e->indexCapacity - iCount) * iSize;
+        if (e->needsUpload) {
+            ++dirtyElements;
+            dirtyBytes += e->vertexCapacity * vSize + e->indexCapacity * iSize;
+        }
+    }
+
+    const int totalBytes = b->vbo.size + b->ibo.size;
+    // Nothing to go by, or not worth the many small uploads
+    if (!dirtyElements || 2 * dirtyBytes > totalBytes)
+        return false;
+    if (100 * unusedBytes > PARTIAL_UPLOAD_FRAGMENTATION_THRESHOLD * totalBytes) {
+        if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "is fragmented, compacting...";
+        return false;
+    }
+
+    if (Q_UNLIKELY(debug_upload())) qDebug() << " Batch:" << b << "updating" << dirtyElements << "elements in place...";
+
+    // The vertex and index data is accessed as floats, quint16 and quint32,
+    // so the scratch buffers are quint32 arrays to be suitably aligned.
+    QVarLengthArray<quint32, 1024> vertices;
+    QVarLengthArray<quint32, 256> indices;
+    for (Element *e = b->first; e; e = e->nextInBatch) {
+        if (!e->needsUpload)
+            continue;
+        const int vCount = e->node->geometry()->vertexCount();
+        vertices.resize((e->vertexCapacity * vSize + 3) / 4);
+        indices.resize((e->indexCapacity * iSize + 3) / 4);
+        char *vertexData = reinterpret_cast<char *>(vertices.data());
+        char *zData = vertexData + vCount * g->sizeOfVertex();
+        char *indexData = reinterpret_cast<char *>(indices.data());
+        int iCount = 0;
+        quint16 iOffset16 = quint16(e->vertexBase);
+        quint32 iOffset32 = e->vertexBase;
+        void *iBasePtr = &iOffset16;
+        if (m_uint32IndexForRhi)
+            iBasePtr = &iOffset32;
+        uploadMergedElement(e, b->positionAttribute, &vertexData, &zData, &indexData, iBasePtr, &iCount);
+
+        // Pad a shrunk element with degenerate triangles
+        if (iCount < e->indexCapacity) {
+            if (m_uint32IndexForRhi) {
+                quint32 *id = indices.data();
+                std::fill(id + iCount, id + e->indexCapacity, iCount ? id[iCount - 1] : e->vertexBase);
+            } else {
+                quint16 *id = reinterpret_cast<quint16 *>(indices.data());
+                std::fill(id + iCount, id + e->indexCapacity, iCount ? id[iCount - 1] : quint16(e->vertexBase));
+            }
+        }
+
+        const char *vertexBase = reinterpret_cast<const char *>(vertices.constData());
+        updateBufferRange(&b->vbo, e->vertexOffset, vCount * g->sizeOfVertex(), vertexBase);
+        if (useDepthBuffer())
+            updateBufferRange(&b->vbo, e->zOffset, vCount * sizeof(float), vertexBase + vCount * g->sizeOfVertex());
+        updateBufferRange(&b->ibo, e->indexOffset, e->indexCapacity * iSize, indices.constData());
+        e->needsUpload = false;
+    }
+
+    for (Buffer *buffer : { &b->vbo, &b->ibo }) {
+        if (buffer->buf->type() != QRhiBuffer::Dynamic)
+            buffer->nonDynamicChangeCount += 1;
+    }
+
+    b->needsUpload = false;
+    if (Q_UNLIKELY(debug_render()))
+        b->uploadedThisFrame = true;
+    return true;
+}
+
 void Renderer::applyClipStateToGraphicsState()
 {
     m_gstate.usesScissor = (m_currentClipState.type & ClipState::ScissorClip);
@@ -2501,6 +3026,14 @@ void Renderer::updateClipState(const QSGClipNode *clipList, Batch *batch)
         batch->stencilClipState.updateStencilBuffer = true;
     }
 
+    if (m_partialUpdate) {
+        if (clipType & ClipState::ScissorClip)
+            scissorRect &= m_damage;
+        else
+            scissorRect = m_damage;
+        clipType |= ClipState::ScissorClip;
+    }
+
     m_currentClipState.clipList = clipList;
     m_currentClipState.type = clipType;
     m_currentClipState.scissor = QRhiScissor(scissorRect.x(), scissorRect.y(),
@@ -3066,6 +3599,8 @@ bool Renderer::prepareRenderMergedBatch(Batch *batch, PreparedRenderBatch *rende
               << " root:" << batch->root;
         if (batch->drawSets.size() > 1)
             debug << "sets:" << batch->drawSets.size();
+        if (batch->instanced)
+            debug << "instances:" << batch->instanceCount;
         if (!batch->isOpaque)
             debug << "opacity:" << e->node->inheritedOpacity();
         batch->uploadedThisFrame = false;
@@ -3089,8 +3624,13 @@ bool Renderer::prepareRenderMergedBatch(Batch *batch, PreparedRenderBatch *rende
         updateClipState(gn->clipList(), batch);
 
     const QSGGeometry *g = gn->geometry();
-    ShaderManager::Shader *sms = useDepthBuffer() ? m_shaderManager->prepareMaterial(material, g, m_renderMode)
-                                                  : m_shaderManager->prepareMaterialNoRewrite(material, g, m_renderMode);
+    ShaderManager::Shader *sms;
+    if (batch->instanced)
+        sms = m_shaderManager->prepareInstancedVertexColor(useDepthBuffer());
+    else if (useDepthBuffer())
+        sms = m_shaderManager->prepareMaterial(material, g, m_renderMode);
+    else
+        sms = m_shaderManager->prepareMaterialNoRewrite(material, g, m_renderMode);
     if (!sms)
         return false;
 
@@ -3218,6 +3758,19 @@ void Renderer::renderMergedBatch(PreparedRenderBatch *renderBatch, bool depthPos
     QRhiCommandBuffer *cb = renderTarget().cb;
     setGraphicsPipeline(cb, batch, e, depthPostPass);
 
+    if (batch->instanced) {
+        const DrawSet &draw = batch->drawSets.first();
+        const QRhiCommandBuffer::VertexInput vbufBindings[] = {
+            { batch->vbo.buf, quint32(draw.vertices) },
+            { batch->vbo.buf, quint32(draw.zorders) }
+        };
+        cb->setVertexInput(VERTEX_BUFFER_BINDING, 2, vbufBindings,
+                           batch->ibo.buf, draw.indices,
+                           m_uint32IndexForRhi ? QRhiCommandBuffer::IndexUInt32 : QRhiCommandBuffer::IndexUInt16);
+        cb->drawIndexed(draw.indexCount, batch->instanceCount);
+        return;
+    }
+
     for (int i = 0, ie = batch->drawSets.size(); i != ie; ++i) {
         const DrawSet &draw = batch->drawSets.at(i);
         const QRhiCommandBuffer::VertexInput vbufBindings[] = {
@@ -3517,6 +4070,251 @@ void Renderer::deleteRemovedElements()
     m_elementsToDelete.reset();
 }
 
+void Renderer::setUploadThreadCount(int count)
+{
+    m_uploadThreadCount = count > 0 ? count : QThread::idealThreadCount();
+}
+
+void Renderer::setPartialUpdateEnabled(bool enabled)
+{
+    if (m_partialUpdateEnabled == enabled)
+        return;
+
+    m_partialUpdateEnabled = enabled;
+
+    // Damage was not tracked while disabled, so start over with a full update
+    m_damageBase = DamageBase();
+    m_pendingDamage = QRect();
+}
+
+bool Renderer::canUpdatePartially() const
+{
+    if (!m_partialUpdateEnabled)
+        return false;
+
+    // Render nodes draw whatever they like, and the visualizer draws on top of
+    // everything. Neither can be limited to the damage.
+    if (!m_renderNodeElements.isEmpty() || m_visualizer->mode() != Visualizer::VisualizeNothing)
+        return false;
+
+    if (m_renderMode == QSGRendererInterface::RenderMode3D || viewportRect() != deviceRect())
+        return false;
+
+    // There is nothing to preserve with the Null backend, but it is handy for
+    // testing the damage tracking.
+    if (m_rhi->backend() == QRhi::Null)
+        return true;
+
+    QRhiRenderTarget *rt = renderTarget().rt;
+    if (rt->resourceType() != QRhiResource::TextureRenderTarget || rt->sampleCount() > 1)
+        return false;
+
+    return static_cast<QRhiTextureRenderTarget *>(rt)->flags().testFlag(QRhiTextureRenderTarget::PreserveColorContents);
+}
+
+void Renderer::markSubtreeDamaged(Node *node)
+{
+    if (node->type() == QSGNode::GeometryNodeType) {
+        if (Element *e = node->element()) {
+            e->damaged = true;
+            // Elements of blocked subtrees are left out of the render lists,
+            // so where they were drawn must be damaged right away.
+            if (!e->damageRect.isEmpty())
+                m_pendingDamage |= e->damageRect;
+        }
+    }
+
+    SHADOWNODE_TRAVERSE(node)
+        markSubtreeDamaged(child);
+}
+
+QRect Renderer::elementDamageRect(Element *e, const QMatrix4x4 &projection, const QRect &targetRect)
+{
+    e->ensureBoundsValid();
+    if (e->boundsOutsideFloatRange)
+        return targetRect;
+
+    QMatrix4x4 m = projection;
+    if (e->root)
+        m *= qsg_matrixForRoot(e->root);
+
+    const QRectF bounds(QPointF(e->bounds.tl.x, e->bounds.tl.y), QPointF(e->bounds.br.x, e->bounds.br.y));
+    const QRectF ndc = m.mapRect(bounds);
+
+    // Same mapping as for scissor clips, plus some room for antialiasing
+    // that the vertex shaders of smooth materials add
+    const qreal halfWidth = targetRect.width() * qreal(0.5);
+    const qreal halfHeight = targetRect.height() * qreal(0.5);
+    const int x1 = qFloor((ndc.left() + 1) * halfWidth) - 2;
+    const int y1 = qFloor((ndc.top() + 1) * halfHeight) - 2;
+    const int x2 = qCeil((ndc.right() + 1) * halfWidth) + 2;
+    const int y2 = qCeil((ndc.bottom() + 1) * halfHeight) + 2;
+
+    return QRect(x1, y1, x2 - x1, y2 - y1) & targetRect;
+}
+
+void Renderer::updateDamage(RenderPassContext *ctx)
+{
+    const QSGRenderTarget &rt(renderTarget());
+    const QRect targetRect(QPoint(0, 0), deviceRect().size());
+
+    m_partialUpdate = ctx->allowPartialUpdate && canUpdatePartially();
+    if (!m_partialUpdate) {
+        m_damageBase.rt = nullptr;
+        m_pendingDamage = QRect();
+        m_damage = targetRect;
+        return;
+    }
+
+    // Anything that changes where or how the whole scene ends up in the render
+    // target invalidates its contents.
+    const QMatrix4x4 projection = projectionMatrixWithNativeNDC();
+    const bool fullDamage = m_damageBase.rt != rt.rt
+            || m_damageBase.pixelSize != rt.rt->pixelSize()
+            || m_damageBase.deviceRect != deviceRect()
+            || m_damageBase.projection != projection
+            || m_damageBase.clearColor != clearColor();
+    if (fullDamage) {
+        m_damageBase.rt = rt.rt;
+        m_damageBase.pixelSize = rt.rt->pixelSize();
+        m_damageBase.deviceRect = deviceRect();
+        m_damageBase.projection = projection;
+        m_damageBase.clearColor = clearColor();
+    }
+
+    QRect damage = fullDamage ? targetRect : m_pendingDamage;
+    m_pendingDamage = QRect();
+
+    // An element damages both where it was and where it is now
+    auto collect = [&](const QDataBuffer<Element *> &renderList) {
+        for (int i = 0; i < renderList.size(); ++i) {
+            Element *e = renderList.at(i);
+            if (!e || e->removed || e->isRenderNode || (!e->damaged && !fullDamage))
+                continue;
+            const QRect rect = elementDamageRect(e, projection, targetRect);
+            if (!e->damageRect.isEmpty())
+                damage |= e->damageRect;
+            if (!rect.isEmpty())
+                damage |= rect;
+            e->damageRect = rect;
+            e->damaged = false;
+        }
+    };
+    collect(m_opaqueRenderList);
+    collect(m_alphaRenderList);
+
+    m_damage = damage & targetRect;
+
+    // Report in the top-left based coordinates of the device rect
+    m_damage_rect = m_damage.isEmpty()
+            ? QRect()
+            : QRect(m_damage.x(), targetRect.height() - m_damage.y() - m_damage.height(),
+                    m_damage.width(), m_damage.height());
+
+    if (Q_UNLIKELY(debug_render()))
+        qDebug() << "Partial update, damage:" << m_damage_rect << "of" << targetRect.size();
+}
+
+bool Renderer::intersectsDamage(const Batch *batch) const
+{
+    for (Element *e = batch->first; e; e = e->nextInBatch) {
+        if (!e->removed && e->damageRect.intersects(m_damage))
+            return true;
+    }
+    return false;
+}
+
+void Renderer::prepareDamageClear()
+{
+    QRhiRenderPassDescriptor *rpDesc = renderTarget().rpDesc;
+
+    if (!m_damageClear.vs.isValid()) {
+        m_damageClear.vs = QSGMaterialShaderPrivate::loadShader(
+                    QLatin1String(":/qt-project.org/scenegraph/shaders_ng/visualization.vert.qsb"));
+        m_damageClear.fs = QSGMaterialShaderPrivate::loadShader(
+                    QLatin1String(":/qt-project.org/scenegraph/shaders_ng/visualization.frag.qsb"));
+    }
+
+    if (!m_damageClear.vbuf) {
+        static const float v[] = { -1, 1,   1, 1,   -1, -1,   1, -1 };
+        m_damageClear.vbuf = m_rhi->newBuffer(QRhiBuffer::Immutable, QRhiBuffer::VertexBuffer, sizeof(v));
+        if (!m_damageClear.vbuf->create())
+            return;
+        m_resourceUpdates->uploadStaticBuffer(m_damageClear.vbuf, v);
+    }
+
+    // matrix, rotation, color, pattern, projection, see visualization.vert
+    if (!m_damageClear.ubuf) {
+        m_damageClear.ubuf = m_rhi->newBuffer(QRhiBuffer::Dynamic, QRhiBuffer::UniformBuffer, 160);
+        if (!m_damageClear.ubuf->create())
+            return;
+        QMatrix4x4 ident;
+        m_resourceUpdates->updateDynamicBuffer(m_damageClear.ubuf, 0, 64, ident.constData());
+        m_resourceUpdates->updateDynamicBuffer(m_damageClear.ubuf, 64, 64, ident.constData());
+        const float pattern = 0.0f;
+        m_resourceUpdates->updateDynamicBuffer(m_damageClear.ubuf, 144, 4, &pattern);
+        const qint32 projection = 0;
+        m_resourceUpdates->updateDynamicBuffer(m_damageClear.ubuf, 148, 4, &projection);
+    }
+    const QColor c = clearColor();
+    const float color[4] = { float(c.redF()), float(c.greenF()), float(c.blueF()), float(c.alphaF()) };
+    m_resourceUpdates->updateDynamicBuffer(m_damageClear.ubuf, 128, 16, color);
+
+    if (!m_damageClear.srb) {
+        m_damageClear.srb = m_rhi->newShaderResourceBindings();
+        m_damageClear.srb->setBindings({
+            QRhiShaderResourceBinding::uniformBuffer(0, QRhiShaderResourceBinding::VertexStage
+                                                            | QRhiShaderResourceBinding::FragmentStage,
+                                                     m_damageClear.ubuf)
+        });
+        if (!m_damageClear.srb->create())
+            return;
+    }
+
+    const QVector<quint32> rpFormat = rpDesc->serializedFormat();
+    if (m_damageClear.ps && m_damageClear.rpFormat != rpFormat) {
+        delete m_damageClear.ps;
+        m_damageClear.ps = nullptr;
+    }
+    if (!m_damageClear.ps) {
+        // Replaces the contents, like a clear would
+        QRhiGraphicsPipeline *ps = m_rhi->newGraphicsPipeline();
+        ps->setFlags(QRhiGraphicsPipeline::UsesScissor);
+        ps->setTopology(QRhiGraphicsPipeline::TriangleStrip);
+        ps->setShaderStages({ { QRhiShaderStage::Vertex, m_damageClear.vs },
+                              { QRhiShaderStage::Fragment, m_damageClear.fs } });
+        QRhiVertexInputLayout inputLayout;
+        inputLayout.setBindings({ { 2 * sizeof(float) } });
+        inputLayout.setAttributes({ { 0, 0, QRhiVertexInputAttribute::Float2, 0 } });
+        ps->setVertexInputLayout(inputLayout);
+        ps->setShaderResourceBindings(m_damageClear.srb);
+        ps->setRenderPassDescriptor(rpDesc);
+        ps->setSampleCount(renderTarget().rt->sampleCount());
+        if (!ps->create()) {
+            delete ps;
+            return;
+        }
+        m_damageClear.ps = ps;
+        m_damageClear.rpFormat = rpFormat;
+    }
+}
+
+void Renderer::recordDamageClear(QRhiCommandBuffer *cb)
+{
+    if (!m_damageClear.ps)
+        return;
+
+    cb->setGraphicsPipeline(m_damageClear.ps);
+    cb->setViewport(m_pstate.viewport);
+    cb->setScissor(QRhiScissor(m_damage.x(), m_damage.y(), m_damage.width(), m_damage.height()));
+    m_pstate.viewportSet = true;
+    m_pstate.scissorSet = true;
+    cb->setShaderResources(m_damageClear.srb);
+    QRhiCommandBuffer::VertexInput vb(m_damageClear.vbuf, 0);
+    cb->setVertexInput(0, 1, &vb);
+    cb->draw(4);
+}
+
 void Renderer::render()
 {
     // Gracefully handle the lack of a render target - some autotests may rely
@@ -3524,6 +4322,7 @@ void Renderer::render()
     if (!renderTarget().rt)
         return;
 
+    m_mainRenderPassContext.allowPartialUpdate = true;
     prepareRenderPass(&m_mainRenderPassContext);
     beginRenderPass(&m_mainRenderPassContext);
     recordRenderPass(&m_mainRenderPassContext);
@@ -3538,6 +4337,8 @@ void Renderer::render()
 
 void Renderer::prepareInline()
 {
+    // The render pass is begun by someone else, who may well clear it
+    m_mainRenderPassContext.allowPartialUpdate = false;
     prepareRenderPass(&m_mainRenderPassContext);
 }
 
@@ -3564,6 +4365,8 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
     ctx->timeSorting = 0;
     ctx->timeUploadOpaque = 0;
     ctx->timeUploadAlpha = 0;
+    m_uploadedBytes = 0;
+    m_partiallyUploadedBytes = 0;
 
     if (Q_UNLIKELY(debug_render() || debug_build())) {
         QByteArray type("rebuild:");
@@ -3672,17 +4475,11 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
     m_indexUploadPool.reset();
 
     if (Q_UNLIKELY(debug_upload())) qDebug("Uploading Opaque Batches:");
-    for (int i=0; i<m_opaqueBatches.size(); ++i) {
-        Batch *b = m_opaqueBatches.at(i);
-        uploadBatch(b);
-    }
+    uploadBatches(m_opaqueBatches);
     if (Q_UNLIKELY(debug_render())) ctx->timeUploadOpaque = ctx->timer.restart();
 
     if (Q_UNLIKELY(debug_upload())) qDebug("Uploading Alpha Batches:");
-    for (int i=0; i<m_alphaBatches.size(); ++i) {
-        Batch *b = m_alphaBatches.at(i);
-        uploadBatch(b);
-    }
+    uploadBatches(m_alphaBatches);
     if (Q_UNLIKELY(debug_render())) ctx->timeUploadAlpha = ctx->timer.restart();
 
     if (Q_UNLIKELY(debug_render())) {
@@ -3691,11 +4488,19 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
                            << " -> Alpha: " << qsg_countNodesInBatches(m_alphaBatches) << " nodes in " << m_alphaBatches.size() << " batches...";
     }
 
+    updateDamage(ctx);
+
     m_current_opacity = 1;
     m_currentMaterial = nullptr;
     m_currentShader = nullptr;
     m_currentProgram = nullptr;
     m_currentClipState.reset();
+    if (m_partialUpdate) {
+        // Everything is scissored to the damage, as if it was clipped to it
+        m_currentClipState.type = ClipState::ScissorClip;
+        m_currentClipState.scissor = QRhiScissor(m_damage.x(), m_damage.y(),
+                                                 m_damage.width(), m_damage.height());
+    }
 
     const QRect viewport = viewportRect();
 
@@ -3721,7 +4526,7 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
             | QRhiGraphicsPipeline::G
             | QRhiGraphicsPipeline::B
             | QRhiGraphicsPipeline::A;
-    m_gstate.usesScissor = false;
+    m_gstate.usesScissor = m_partialUpdate;
     m_gstate.stencilTest = false;
 
     m_gstate.sampleCount = renderTarget().rt->sampleCount();
@@ -3730,6 +4535,8 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
     if (Q_LIKELY(renderOpaque)) {
         for (int i = 0, ie = m_opaqueBatches.size(); i != ie; ++i) {
             Batch *b = m_opaqueBatches.at(i);
+            if (m_partialUpdate && !intersectsDamage(b))
+                continue;
             PreparedRenderBatch renderBatch;
             bool ok;
             if (b->merged)
@@ -3760,6 +4567,8 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
     if (Q_LIKELY(renderAlpha)) {
         for (int i = 0, ie = m_alphaBatches.size(); i != ie; ++i) {
             Batch *b = m_alphaBatches.at(i);
+            if (m_partialUpdate && !intersectsDamage(b))
+                continue;
             PreparedRenderBatch renderBatch;
             bool ok;
             if (b->merged)
@@ -3783,6 +4592,9 @@ void Renderer::prepareRenderPass(RenderPassContext *ctx)
     if (m_visualizer->mode() != Visualizer::VisualizeNothing)
         m_visualizer->prepareVisualize();
 
+    if (m_partialUpdate && !m_damage.isEmpty())
+        prepareDamageClear();
+
     renderTarget().cb->resourceUpdate(m_resourceUpdates);
     m_resourceUpdates = nullptr;
 }
@@ -3821,6 +4633,10 @@ void Renderer::recordRenderPass(RenderPassContext *ctx)
     QRhiCommandBuffer *cb = renderTarget().cb;
     cb->debugMarkBegin(QByteArrayLiteral("Qt Quick scene render"));
 
+    // The render target preserves its contents, so clear only what is redrawn
+    if (m_partialUpdate && !m_damage.isEmpty())
+        recordDamageClear(cb);
+
     for (int i = 0, ie = ctx->opaqueRenderBatches.size(); i != ie; ++i) {
         if (i == 0)
             cb->debugMarkMsg(QByteArrayLiteral("Qt Quick opaque batches"));
@@ -3877,6 +4693,8 @@ void Renderer::recordRenderPass(RenderPassContext *ctx)
                (int) ctx->timeSorting,
                (int) ctx->timeUploadOpaque, (int) ctx->timeUploadAlpha,
                (int) ctx->timer.elapsed());
+        qDebug(" -> uploaded: %llu bytes, %llu of them in place",
+               m_uploadedBytes, m_partiallyUploadedBytes);
     }
 }
 
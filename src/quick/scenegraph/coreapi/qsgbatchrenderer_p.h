@@ -276,6 +276,8 @@ struct Element {
         , orphaned(false)
         , isRenderNode(false)
         , isMaterialBlended(false)
+        , damaged(false)
+        , needsUpload(false)
     {
     }
 
@@ -296,6 +298,16 @@ struct Element {
     Node *root = nullptr;
 
     Rect bounds; // in device coordinates
+    QRect damageRect; // in render target pixels, as of the last partially updated frame
+
+    // Where the element's data lives in the buffers of its merged batch, so
+    // that it can be updated in place. See Renderer::uploadBatchPartially().
+    int vertexOffset = 0;
+    int zOffset = 0;
+    int indexOffset = 0;
+    int vertexCapacity = 0;
+    int indexCapacity = 0;
+    quint32 vertexBase = 0;
 
     int order = 0;
     QRhiShaderResourceBindings *srb = nullptr;
@@ -309,6 +321,8 @@ struct Element {
     uint orphaned : 1;
     uint isRenderNode : 1;
     uint isMaterialBlended : 1;
+    uint damaged : 1;
+    uint needsUpload : 1;
 };
 
 struct RenderNodeElement : public Element {
@@ -409,6 +423,7 @@ struct Batch
 
     bool isTranslateOnlyToRoot() const;
     bool isSafeToBatch() const;
+    bool canMerge() const;
 
     // pseudo-constructor...
     void init() {
@@ -425,6 +440,10 @@ struct Batch
         isRenderNode = false;
         ubufDataValid = false;
         needsPurge = false;
+        hasStableLayout = false;
+        layoutZRange = 0;
+        instanced = false;
+        instanceCount = 0;
         clipState.reset();
         blendConstant = QColor();
     }
@@ -439,12 +458,17 @@ struct Batch
 
     int lastOrderInBatch;
 
+    qreal layoutZRange;
+    int instanceCount;
+
     uint isOpaque : 1;
     uint needsUpload : 1;
     uint merged : 1;
     uint isRenderNode : 1;
     uint ubufDataValid : 1;
     uint needsPurge : 1;
+    uint hasStableLayout : 1; // element ranges in vbo/ibo are valid
+    uint instanced : 1; // one shape in vbo/ibo, drawn once per element
 
     mutable uint uploadedThisFrame : 1; // solely for debugging purposes
 
@@ -676,6 +700,7 @@ public Q_SLOTS:
 public:
     Shader *prepareMaterial(QSGMaterial *material, const QSGGeometry *geometry = nullptr, QSGRendererInterface::RenderMode renderMode = QSGRendererInterface::RenderMode2D);
     Shader *prepareMaterialNoRewrite(QSGMaterial *material, const QSGGeometry *geometry = nullptr, QSGRendererInterface::RenderMode renderMode = QSGRendererInterface::RenderMode2D);
+    Shader *prepareInstancedVertexColor(bool batchable);
 
 private:
     typedef QPair<QSGMaterialType *, QSGRendererInterface::RenderMode> ShaderKey;
@@ -729,6 +754,19 @@ public:
     Renderer(QSGDefaultRenderContext *ctx, QSGRendererInterface::RenderMode renderMode = QSGRendererInterface::RenderMode2D);
     ~Renderer();
 
+    bool isPartialUpdateEnabled() const { return m_partialUpdateEnabled; }
+    void setPartialUpdateEnabled(bool enabled);
+
+    bool isInstancingEnabled() const { return m_instancingEnabled; }
+    void setInstancingEnabled(bool enabled) { m_instancingEnabled = enabled; }
+
+    int uploadThreadCount() const { return m_uploadThreadCount; }
+    void setUploadThreadCount(int count);
+
+    // Vertex and index data queued for upload by the last prepared frame
+    quint64 uploadedBytes() const { return m_uploadedBytes; }
+    quint64 partiallyUploadedBytes() const { return m_partiallyUploadedBytes; }
+
 protected:
     void nodeChanged(QSGNode *node, QSGNode::DirtyState state) override;
     void render() override;
@@ -743,6 +781,7 @@ protected:
 
     struct RenderPassContext {
         bool valid = false;
+        bool allowPartialUpdate = false;
         QVarLengthArray<PreparedRenderBatch, 64> opaqueRenderBatches;
         QVarLengthArray<PreparedRenderBatch, 64> alphaRenderBatches;
         QElapsedTimer timer;
@@ -793,6 +832,14 @@ private:
     void invalidateBatchAndOverlappingRenderOrders(Batch *batch);
 
     void uploadBatch(Batch *b);
+    void uploadBatches(const QDataBuffer<Batch *> &batches);
+    bool beginBatchUpload(Batch *b, int *vertexBufferSize, int *indexBufferSize);
+    void fillBatch(Batch *b);
+    void endBatchUpload(Batch *b);
+    bool uploadBatchPartially(Batch *b);
+    bool canInstance(const Batch *b) const;
+    void fillInstancedBatch(Batch *b);
+    void updateBufferRange(Buffer *buffer, quint32 offset, quint32 size, const void *data);
     void uploadMergedElement(Element *e, int vaOffset, char **vertexData, char **zData, char **indexData, void *iBasePtr, int *indexCount);
 
     bool ensurePipelineState(Element *e, const ShaderManager::Shader *sms, bool depthPostPass = false);
@@ -835,6 +882,14 @@ private:
     void invalidateAndRecycleBatch(Batch *b);
     void releaseElement(Element *e, bool inDestructor = false);
 
+    bool canUpdatePartially() const;
+    void markSubtreeDamaged(Node *node);
+    QRect elementDamageRect(Element *e, const QMatrix4x4 &projection, const QRect &targetRect);
+    void updateDamage(RenderPassContext *ctx);
+    bool intersectsDamage(const Batch *batch) const;
+    void prepareDamageClear();
+    void recordDamageClear(QRhiCommandBuffer *cb);
+
     void setVisualizationMode(const QByteArray &mode) override;
     bool hasVisualizationModeWithContinuousUpdate() const override;
 
@@ -868,6 +923,9 @@ private:
     int m_batchNodeThreshold;
     int m_batchVertexThreshold;
     int m_srbPoolThreshold;
+    int m_uploadThreadCount;
+    quint64 m_uploadedBytes;
+    quint64 m_partiallyUploadedBytes;
 
     Visualizer *m_visualizer;
 
@@ -903,6 +961,33 @@ private:
         inline void reset();
     } m_stencilClipCommon;
 
+    // Partial updates redraw only the part of a render target with preserved
+    // contents that changed since the previous frame. m_damage is in QRhi
+    // scissor coordinates, with the origin in the bottom-left corner.
+    bool m_partialUpdateEnabled;
+    bool m_instancingEnabled;
+    bool m_partialUpdate = false;
+    QRect m_damage;
+    QRect m_pendingDamage;
+    struct DamageBase {
+        QRhiRenderTarget *rt = nullptr;
+        QSize pixelSize;
+        QRect deviceRect;
+        QMatrix4x4 projection;
+        QColor clearColor;
+    } m_damageBase;
+
+    struct DamageClear {
+        QShader vs;
+        QShader fs;
+        QRhiBuffer *vbuf = nullptr;
+        QRhiBuffer *ubuf = nullptr;
+        QRhiShaderResourceBindings *srb = nullptr;
+        QRhiGraphicsPipeline *ps = nullptr;
+        QVector<quint32> rpFormat;
+        inline void reset();
+    } m_damageClear;
+
     inline int mergedIndexElemSize() const;
     inline bool useDepthBuffer() const;
     inline void setStateForDepthPostPass();
@@ -964,6 +1049,23 @@ void Renderer::StencilClipCommonData::reset()
     fs = QShader();
 }
 
+void Renderer::DamageClear::reset()
+{
+    delete ps;
+    ps = nullptr;
+
+    delete srb;
+    srb = nullptr;
+
+    delete ubuf;
+    ubuf = nullptr;
+
+    delete vbuf;
+    vbuf = nullptr;
+
+    rpFormat.clear();
+}
+
 void ClipState::reset()
 {
     clipList = nullptr;
@@ -139,6 +139,9 @@ void QSGRenderer::renderScene()
 
     preprocess();
 
+    // Renderers that track damage narrow this down in render()
+    m_damage_rect = deviceRect();
+
     Q_TRACE(QSG_render_entry);
     render();
     if (profileFrames)
@@ -168,6 +171,8 @@ void QSGRenderer::prepareSceneInline()
 
     preprocess();
 
+    m_damage_rect = deviceRect();
+
     prepareInline();
 }
 
@@ -95,6 +95,10 @@ public:
     void setRenderTarget(const QSGRenderTarget &rt) { m_rt = rt; }
     const QSGRenderTarget &renderTarget() const { return m_rt; }
 
+    // The part of the device rect, in pixels with the origin in the top-left
+    // corner, that the last frame repainted. Empty when nothing changed.
+    QRect damageRect() const { return m_damage_rect; }
+
     void setRenderPassRecordingCallbacks(QSGRenderContext::RenderPassCallback start,
                                          QSGRenderContext::RenderPassCallback end,
                                          void *userData)
@@ -128,6 +132,7 @@ protected:
     QRhiResourceUpdateBatch *m_current_resource_update_batch;
     QRhi *m_rhi;
     QSGRenderTarget m_rt;
+    QRect m_damage_rect;
     struct {
         QSGRenderContext::RenderPassCallback start = nullptr;
         QSGRenderContext::RenderPassCallback end = nullptr;
@@ -442,7 +442,8 @@ void RhiVisualizer::ChangeVis::render(QRhiCommandBuffer *cb)
 
 void RhiVisualizer::BatchVis::gather(Batch *b)
 {
-    if (b->positionAttribute != 0)
+    // The buffers of instanced batches hold a single shape
+    if (b->positionAttribute != 0 || b->instanced)
         return;
 
     QMatrix4x4 matrix(visualizer->m_renderer->m_current_projection_matrix);
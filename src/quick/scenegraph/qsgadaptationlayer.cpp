@@ -13,6 +13,10 @@
 
 #include <private/qquickprofiler_p.h>
 #include <QElapsedTimer>
+#include <QtCore/qmutex.h>
+#include <QtCore/qthreadpool.h>
+#include <QtGui/qpainter.h>
+#include <QtQml/private/qqmlglobal_p.h>
 
 #include <qtquick_tracepoints_p.h>
 
@@ -27,8 +31,77 @@ Q_TRACE_POINT(qtquick, QSGDistanceFieldGlyphCache_glyphStore_exit)
 
 static QElapsedTimer qsg_render_timer;
 
+static bool &qsg_asyncDistanceFields()
+{
+    static bool async = qEnvironmentVariableIntValue("QSG_DISTANCEFIELD_ASYNC");
+    return async;
+}
+
+// With QSG_DISTANCEFIELD_ASYNC, the time a frame may spend generating
+// distance fields before the rest is handed to worker threads
+static qint64 &qsg_asyncGlyphFrameBudget()
+{
+    static qint64 budget = 2000000;
+    return budget;
+}
+
+static const int ASYNC_GLYPHS_PER_JOB = 32;
+
+// Prefetched distance fields are kept on the CPU until their glyph is
+// requested, this many at most, including the ones still being generated.
+// The painter paths of the glyphs to prefetch are extracted on the render
+// thread, a limited number per frame.
+static const int MAX_PREFETCHED_GLYPHS = 2048;
+static const int PREFETCH_PATHS_PER_FRAME = 2 * ASYNC_GLYPHS_PER_JOB;
+
+struct QSGDistanceFieldGlyphJobs
+{
+    QMutex mutex;
+    QList<QDistanceField> generated;
+    QHash<glyph_t, QDistanceField> prefetched;
+    // Glyphs being prefetched whose result is still wanted
+    QSet<glyph_t> prefetching;
+    // More glyphs are waiting for their painter path to be extracted
+    bool prefetchQueued = false;
+    std::function<void()> glyphsReady;
+};
+
 QSGDistanceFieldGlyphCache::Texture QSGDistanceFieldGlyphCache::s_emptyTexture;
 
+// The antialiased coverage of a glyph, stored in place of its distance field
+// while the real one is generated on a worker thread. Rasterizing is much
+// cheaper than computing distances, and the shape is close enough for the
+// shader to draw the glyph until the real distance field replaces it.
+static QDistanceField placeholderDistanceField(const QPainterPath &path, glyph_t glyph,
+                                               bool doubleResolution)
+{
+    // A path with the glyph's bounds gives a distance field of the same size
+    // as the real one, and thus the same place in the texture, cheaply.
+    const QRectF bounds = path.boundingRect();
+    QPainterPath boundsPath;
+    boundsPath.addRect(bounds);
+    QDistanceField distanceField(boundsPath, glyph, doubleResolution);
+
+    const int scale = QT_DISTANCEFIELD_SCALE(doubleResolution);
+    const int margin = QT_DISTANCEFIELD_RADIUS(doubleResolution) / scale;
+    QImage coverage(distanceField.width(), distanceField.height(), QImage::Format_Alpha8);
+    coverage.fill(Qt::transparent);
+    {
+        QPainter painter(&coverage);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.translate(margin, margin);
+        painter.scale(1 / qreal(scale), 1 / qreal(scale));
+        painter.translate(-bounds.topLeft());
+        QPainterPath windingPath = path;
+        windingPath.setFillRule(Qt::WindingFill);
+        painter.fillPath(windingPath, Qt::black);
+    }
+
+    for (int y = 0; y < distanceField.height(); ++y)
+        memcpy(distanceField.scanLine(y), coverage.constScanLine(y), distanceField.width());
+    return distanceField;
+}
+
 QSGDistanceFieldGlyphCache::QSGDistanceFieldGlyphCache(const QRawFont &font, int renderTypeQuality)
     : m_renderTypeQuality(renderTypeQuality)
     , m_pendingGlyphs(64)
@@ -49,6 +122,8 @@ QSGDistanceFieldGlyphCache::QSGDistanceFieldGlyphCache(const QRawFont &font, int
 
 QSGDistanceFieldGlyphCache::~QSGDistanceFieldGlyphCache()
 {
+    // Jobs still running finish into the void
+    setGlyphsReadyCallback(nullptr);
 }
 
 int QSGDistanceFieldGlyphCache::baseFontSize() const
@@ -150,6 +225,12 @@ void QSGDistanceFieldGlyphCache::update()
 {
     m_populatingGlyphs.clear();
 
+    if (m_jobs) {
+        storeGeneratedGlyphs();
+        if (!m_prefetchQueue.isEmpty())
+            startPrefetching();
+    }
+
     if (m_pendingGlyphs.isEmpty())
         return;
 
@@ -161,17 +242,65 @@ void QSGDistanceFieldGlyphCache::update()
     Q_QUICK_SG_PROFILE_START(QQuickProfiler::SceneGraphAdaptationLayerFrame);
     Q_TRACE(QSGDistanceFieldGlyphCache_glyphRender_entry);
 
+    // Take the prefetched distance fields of the glyphs needed now. The ones
+    // still being prefetched are generated here instead, and their results
+    // are dropped when they arrive.
+    QHash<glyph_t, QDistanceField> prefetched;
+    if (m_jobs) {
+        QMutexLocker locker(&m_jobs->mutex);
+        if (!m_jobs->prefetched.isEmpty() || !m_jobs->prefetching.isEmpty()) {
+            for (int i = 0; i < m_pendingGlyphs.size(); ++i) {
+                const glyph_t glyph = m_pendingGlyphs.at(i);
+                const auto it = m_jobs->prefetched.constFind(glyph);
+                if (it != m_jobs->prefetched.cend()) {
+                    prefetched.insert(it.key(), it.value());
+                    m_jobs->prefetched.erase(it);
+                } else {
+                    m_jobs->prefetching.remove(glyph);
+                }
+            }
+        }
+    }
+
+    // When generating everything would take too long, the rest of the glyphs
+    // is generated on worker threads. Until their distance fields replace
+    // them in a later frame, the glyphs are drawn from their coverage.
+    const bool async = qsg_asyncDistanceFields();
+    QElapsedTimer budgetTimer;
+    if (async)
+        budgetTimer.start();
+    QList<PendingGlyph> asyncGlyphs;
+
     QList<QDistanceField> distanceFields;
     const int pendingGlyphsSize = m_pendingGlyphs.size();
     distanceFields.reserve(pendingGlyphsSize);
     for (int i = 0; i < pendingGlyphsSize; ++i) {
-        GlyphData &gd = glyphData(m_pendingGlyphs.at(i));
-        distanceFields.append(QDistanceField(gd.path,
-                                             m_pendingGlyphs.at(i),
-                                             m_doubleGlyphResolution));
+        const glyph_t glyph = m_pendingGlyphs.at(i);
+        GlyphData &gd = glyphData(glyph);
+        const auto it = prefetched.constFind(glyph);
+        // The path was released when the glyph was generated before, and it
+        // is requested again after having been evicted
+        if (it == prefetched.cend() && gd.path.isEmpty())
+            gd.path = m_referenceFont.pathForGlyph(glyph);
+        if (it != prefetched.cend()) {
+            distanceFields.append(it.value());
+        } else if (async && budgetTimer.nsecsElapsed() > qsg_asyncGlyphFrameBudget()) {
+            distanceFields.append(placeholderDistanceField(gd.path, glyph, m_doubleGlyphResolution));
+            asyncGlyphs.append({ glyph, gd.path });
+        } else {
+            distanceFields.append(QDistanceField(gd.path,
+                                                 glyph,
+                                                 m_doubleGlyphResolution));
+        }
         gd.path = QPainterPath(); // no longer needed, so release memory used by the painter path
     }
 
+    if (!asyncGlyphs.isEmpty()) {
+        qCDebug(QSG_LOG_TIME_GLYPH, "distancefield: %d glyphs deferred to worker threads",
+                int(asyncGlyphs.size()));
+        generateGlyphs(std::move(asyncGlyphs), false);
+    }
+
     qint64 renderTime = 0;
     int count = m_pendingGlyphs.size();
     if (profileFrames)
@@ -206,6 +335,173 @@ void QSGDistanceFieldGlyphCache::update()
                                         (qint64)count);
 }
 
+/*!
+    Queues \a glyphs for having their distance fields generated on worker
+    threads, so that they are ready when text using them shows up later,
+    instead of being generated in the frame that needs them first.
+
+    The painter paths of the glyphs are extracted in update(), a chunk per
+    frame, and at most MAX_PREFETCHED_GLYPHS distance fields are kept
+    waiting for their glyphs to be requested.
+ */
+void QSGDistanceFieldGlyphCache::prefetchGlyphs(const QVector<glyph_t> &glyphs)
+{
+    if (glyphs.isEmpty())
+        return;
+
+    if (!m_jobs)
+        m_jobs.reset(new QSGDistanceFieldGlyphJobs);
+
+    m_prefetchQueue += glyphs;
+
+    QMutexLocker locker(&m_jobs->mutex);
+    m_jobs->prefetchQueued = true;
+}
+
+void QSGDistanceFieldGlyphCache::startPrefetching()
+{
+    QList<PendingGlyph> toGenerate;
+    {
+        QMutexLocker locker(&m_jobs->mutex);
+        const qsizetype room = qMin(qsizetype(PREFETCH_PATHS_PER_FRAME),
+                                    MAX_PREFETCHED_GLYPHS - m_jobs->prefetching.size() - m_jobs->prefetched.size());
+        qsizetype i = 0;
+        for (; i < m_prefetchQueue.size() && toGenerate.size() < room; ++i) {
+            const glyph_t glyph = m_prefetchQueue.at(i);
+            if ((int(glyph) >= glyphCount() && glyphCount() > 0)
+                    || m_jobs->prefetching.contains(glyph) || m_jobs->prefetched.contains(glyph)) {
+                continue;
+            }
+            const GlyphData &gd = glyphData(glyph);
+            if (gd.texCoord.isValid() || gd.boundingRect.isEmpty())
+                continue;
+            m_jobs->prefetching.insert(glyph);
+            toGenerate.append({ glyph, gd.path });
+        }
+        m_prefetchQueue.remove(0, i);
+        m_jobs->prefetchQueued = !m_prefetchQueue.isEmpty();
+    }
+
+    if (!toGenerate.isEmpty())
+        generateGlyphs(std::move(toGenerate), true);
+}
+
+// For autotests
+int QSGDistanceFieldGlyphCache::prefetchedGlyphCount() const
+{
+    if (!m_jobs)
+        return 0;
+    QMutexLocker locker(&m_jobs->mutex);
+    return int(m_jobs->prefetched.size());
+}
+
+// For autotests
+bool QSGDistanceFieldGlyphCache::isAsyncGenerationEnabled()
+{
+    return qsg_asyncDistanceFields();
+}
+
+// For autotests
+void QSGDistanceFieldGlyphCache::setAsyncGenerationEnabled(bool enabled)
+{
+    qsg_asyncDistanceFields() = enabled;
+}
+
+// For autotests
+qint64 QSGDistanceFieldGlyphCache::asyncGenerationFrameBudget()
+{
+    return qsg_asyncGlyphFrameBudget();
+}
+
+// For autotests
+void QSGDistanceFieldGlyphCache::setAsyncGenerationFrameBudget(qint64 nsecs)
+{
+    qsg_asyncGlyphFrameBudget() = nsecs;
+}
+
+/*!
+    Sets the \a callback to call when distance fields generated on a worker
+    thread are ready to be stored, so that a new frame can be scheduled. The
+    callback is called on the worker thread.
+ */
+void QSGDistanceFieldGlyphCache::setGlyphsReadyCallback(std::function<void()> callback)
+{
+    if (!m_jobs) {
+        if (!callback)
+            return;
+        m_jobs.reset(new QSGDistanceFieldGlyphJobs);
+    }
+
+    QMutexLocker locker(&m_jobs->mutex);
+    m_jobs->glyphsReady = std::move(callback);
+}
+
+void QSGDistanceFieldGlyphCache::generateGlyphs(QList<PendingGlyph> &&glyphs, bool prefetch)
+{
+    if (!m_jobs)
+        m_jobs.reset(new QSGDistanceFieldGlyphJobs);
+
+    const bool doubleGlyphResolution = m_doubleGlyphResolution;
+    for (qsizetype i = 0; i < glyphs.size(); i += ASYNC_GLYPHS_PER_JOB) {
+        QList<PendingGlyph> chunk = glyphs.mid(i, ASYNC_GLYPHS_PER_JOB);
+        QThreadPool::globalInstance()->start([jobs = m_jobs, chunk = std::move(chunk), doubleGlyphResolution, prefetch] {
+            QList<QDistanceField> distanceFields;
+            distanceFields.reserve(chunk.size());
+            for (const PendingGlyph &glyph : chunk)
+                distanceFields.append(QDistanceField(glyph.path, glyph.glyph, doubleGlyphResolution));
+
+            QMutexLocker locker(&jobs->mutex);
+            if (prefetch) {
+                // Glyphs that were generated on the render thread meanwhile
+                // are no longer in prefetching, drop their results
+                for (const QDistanceField &distanceField : std::as_const(distanceFields)) {
+                    if (jobs->prefetching.remove(distanceField.glyph()))
+                        jobs->prefetched.insert(distanceField.glyph(), distanceField);
+                }
+                // Get a frame to extract the next paths in
+                if (jobs->prefetchQueued && jobs->glyphsReady)
+                    jobs->glyphsReady();
+            } else {
+                jobs->generated += distanceFields;
+                if (jobs->glyphsReady)
+                    jobs->glyphsReady();
+            }
+        });
+    }
+}
+
+void QSGDistanceFieldGlyphCache::storeGeneratedGlyphs()
+{
+    QList<QDistanceField> generated;
+    {
+        QMutexLocker locker(&m_jobs->mutex);
+        generated.swap(m_jobs->generated);
+    }
+    if (generated.isEmpty())
+        return;
+
+    // Replace the placeholders. Glyphs that were evicted from the cache while
+    // being generated have lost their place, they are generated again if
+    // requested again.
+    QList<QDistanceField> distanceFields;
+    QVector<quint32> readyGlyphs;
+    distanceFields.reserve(generated.size());
+    readyGlyphs.reserve(generated.size());
+    for (const QDistanceField &distanceField : std::as_const(generated)) {
+        if (glyphData(distanceField.glyph()).texCoord.isNull())
+            continue;
+        distanceFields.append(distanceField);
+        readyGlyphs.append(distanceField.glyph());
+    }
+    if (distanceFields.isEmpty())
+        return;
+
+    storeGlyphs(distanceFields);
+
+    for (QSGDistanceFieldGlyphConsumerList::iterator iter = m_registeredNodes.begin(); iter != m_registeredNodes.end(); ++iter)
+        iter->invalidateGlyphs(readyGlyphs);
+}
+
 void QSGDistanceFieldGlyphCache::setGlyphsPosition(const QList<GlyphPosition> &glyphs)
 {
     QVector<quint32> invalidatedGlyphs;
@@ -32,6 +32,7 @@
 #include <private/qdistancefield_p.h>
 #include <private/qintrusivelist_p.h>
 #include <rhi/qshader.h>
+#include <functional>
 
 // ### remove
 #include <QtQuick/private/qquicktext_p.h>
@@ -403,6 +404,8 @@ public:
 };
 typedef QIntrusiveList<QSGDistanceFieldGlyphConsumer, &QSGDistanceFieldGlyphConsumer::node> QSGDistanceFieldGlyphConsumerList;
 
+struct QSGDistanceFieldGlyphJobs;
+
 class Q_QUICK_PRIVATE_EXPORT QSGDistanceFieldGlyphCache
 {
 public:
@@ -468,6 +471,15 @@ public:
     void registerGlyphNode(QSGDistanceFieldGlyphConsumer *node) { m_registeredNodes.insert(node); }
     void unregisterGlyphNode(QSGDistanceFieldGlyphConsumer *node) { m_registeredNodes.remove(node); }
 
+    void prefetchGlyphs(const QVector<glyph_t> &glyphs);
+
+    // For autotests
+    int prefetchedGlyphCount() const;
+    static bool isAsyncGenerationEnabled();
+    static void setAsyncGenerationEnabled(bool enabled);
+    static qint64 asyncGenerationFrameBudget();
+    static void setAsyncGenerationFrameBudget(qint64 nsecs);
+
     virtual void processPendingGlyphs();
 
     virtual bool eightBitFormatIsAlphaSwizzled() const = 0;
@@ -502,6 +514,8 @@ protected:
 
     void updateRhiTexture(QRhiTexture *oldTex, QRhiTexture *newTex, const QSize &newTexSize);
 
+    void setGlyphsReadyCallback(std::function<void()> callback);
+
     inline bool containsGlyph(glyph_t glyph);
 
     GlyphData &glyphData(glyph_t glyph);
@@ -520,6 +534,15 @@ protected:
     QRawFont m_referenceFont;
 
 private:
+    struct PendingGlyph {
+        glyph_t glyph;
+        QPainterPath path;
+    };
+
+    void generateGlyphs(QList<PendingGlyph> &&glyphs, bool prefetch);
+    void startPrefetching();
+    void storeGeneratedGlyphs();
+
     int m_glyphCount;
     QList<Texture> m_textures;
     QHash<glyph_t, GlyphData> m_glyphsData;
@@ -527,6 +550,10 @@ private:
     QSet<glyph_t> m_populatingGlyphs;
     QSGDistanceFieldGlyphConsumerList m_registeredNodes;
 
+    // distance fields generated on worker threads, see update()
+    QSharedPointer<QSGDistanceFieldGlyphJobs> m_jobs;
+    QList<glyph_t> m_prefetchQueue;
+
     static Texture s_emptyTexture;
 };
 
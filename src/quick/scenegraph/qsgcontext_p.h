@@ -180,6 +180,8 @@ Q_SIGNALS:
     void initialized();
     void invalidated();
     void releaseCachedResourcesRequested();
+    // emitted from a worker thread when distance fields generated there are ready
+    void glyphsReady();
 
 public Q_SLOTS:
     void textureFactoryDestroyed(QObject *o);
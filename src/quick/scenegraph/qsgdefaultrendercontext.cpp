@@ -16,8 +16,73 @@
 #include <QtQuick/qsgrendererinterface.h>
 #include <QtQuick/qquickgraphicsconfiguration.h>
 
+#include <QtQml/private/qqmlglobal_p.h>
+
+#include <QtCore/qfile.h>
+
 QT_BEGIN_NAMESPACE
 
+namespace {
+
+// Distance field glyph caches shared by all render contexts using the same
+// QRhi, for example multiple windows on the basic render loop created with
+// QQuickGraphicsDevice::fromRhi(). The glyphs are generated and uploaded
+// once and referenced by the glyph nodes of all windows. A shared cache
+// collects its resource updates itself, whichever window renders the text
+// first commits them.
+struct SharedGlyphCache
+{
+    QSGRhiDistanceFieldGlyphCache *cache = nullptr;
+    QVarLengthArray<QSGDefaultRenderContext *, 4> users;
+};
+
+struct SharedGlyphCaches
+{
+    QMutex mutex;
+    QHash<std::pair<QRhi *, QString>, SharedGlyphCache> caches;
+};
+
+}
+
+Q_GLOBAL_STATIC(SharedGlyphCaches, qsg_sharedGlyphCaches)
+
+static bool &qsg_shareGlyphCaches()
+{
+    static bool share = qEnvironmentVariableIntValue("QSG_SHARE_GLYPH_CACHES");
+    return share;
+}
+
+// The glyphs for the text in the file named by QSG_DISTANCEFIELD_PREFETCH
+// are generated in the background for every new distance field glyph cache,
+// so that they do not have to be generated when they are first shown.
+static const QString &qsg_prefetchText()
+{
+    static const QString text = [] {
+        const QString fileName = qEnvironmentVariable("QSG_DISTANCEFIELD_PREFETCH");
+        if (fileName.isEmpty())
+            return QString();
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            qWarning("QSG_DISTANCEFIELD_PREFETCH: Failed to open %s", qPrintable(fileName));
+            return QString();
+        }
+        return QString::fromUtf8(file.readAll());
+    }();
+    return text;
+}
+
+static QSGRhiDistanceFieldGlyphCache *createDistanceFieldGlyphCache(QSGDefaultRenderContext *rc,
+                                                                    const QRawFont &font,
+                                                                    int renderTypeQuality,
+                                                                    bool shared)
+{
+    QSGRhiDistanceFieldGlyphCache *cache = new QSGRhiDistanceFieldGlyphCache(rc, font, renderTypeQuality, shared);
+    const QString &prefetchText = qsg_prefetchText();
+    if (!prefetchText.isEmpty())
+        cache->prefetchGlyphs(cache->referenceFont().glyphIndexesForString(prefetchText));
+    return cache;
+}
+
 QSGDefaultRenderContext::QSGDefaultRenderContext(QSGContext *context)
     : QSGRenderContext(context)
     , m_rhi(nullptr)
@@ -63,7 +128,7 @@ void QSGDefaultRenderContext::invalidateGlyphCaches()
         auto it = m_glyphCaches.begin();
         while (it != m_glyphCaches.end()) {
             if (!(*it)->isActive()) {
-                delete *it;
+                releaseGlyphCache(it.key(), *it);
                 it = m_glyphCaches.erase(it);
             } else {
                 ++it;
@@ -131,7 +196,12 @@ void QSGDefaultRenderContext::invalidate()
     }
     m_fontEnginesToClean.clear();
 
-    qDeleteAll(m_glyphCaches);
+    if (!m_glyphCaches.isEmpty()) {
+        qCDebug(QSG_LOG_INFO, "distancefield: %lld KB of glyph cache textures in use by render context %p",
+                glyphCacheTextureMemory() / 1024, this);
+    }
+    for (auto it = m_glyphCaches.cbegin(); it != m_glyphCaches.cend(); ++it)
+        releaseGlyphCache(it.key(), it.value());
     m_glyphCaches.clear();
 
     resetGlyphCacheResources();
@@ -179,6 +249,9 @@ void QSGDefaultRenderContext::endNextFrame(QSGRenderer *renderer)
     Q_UNUSED(renderer);
     m_currentFrameCommandBuffer = nullptr;
     m_currentFrameRenderPass = nullptr;
+
+    if (m_rhiAtlasManager)
+        m_rhiAtlasManager->releaseRetiredAtlas();
 }
 
 QSGTexture *QSGDefaultRenderContext::createTexture(const QImage &image, uint flags) const
@@ -258,14 +331,104 @@ QSGDistanceFieldGlyphCache *QSGDefaultRenderContext::distanceFieldGlyphCache(con
 {
     QString key = fontKey(font, renderTypeQuality);
     QSGDistanceFieldGlyphCache *cache = m_glyphCaches.value(key, 0);
-    if (!cache) {
-        cache = new QSGRhiDistanceFieldGlyphCache(this, font, renderTypeQuality);
-        m_glyphCaches.insert(key, cache);
+    if (cache)
+        return cache;
+
+    if (qsg_shareGlyphCaches()) {
+        SharedGlyphCaches *shared = qsg_sharedGlyphCaches();
+        QMutexLocker locker(&shared->mutex);
+        SharedGlyphCache &entry = shared->caches[{ m_rhi, key }];
+        if (!entry.cache) {
+            entry.cache = createDistanceFieldGlyphCache(this, font, renderTypeQuality, true);
+        } else {
+            qCDebug(QSG_LOG_INFO, "distancefield: sharing glyph cache for %s with %d other render contexts",
+                    qPrintable(key), int(entry.users.size()));
+            entry.cache->addUser(this);
+        }
+        entry.users.append(this);
+        cache = entry.cache;
+    } else {
+        cache = createDistanceFieldGlyphCache(this, font, renderTypeQuality, false);
     }
+    m_glyphCaches.insert(key, cache);
 
     return cache;
 }
 
+void QSGDefaultRenderContext::releaseGlyphCache(const QString &key, QSGDistanceFieldGlyphCache *cache)
+{
+    // Decided by the cache, sharing may have been turned on or off since
+    if (!static_cast<QSGRhiDistanceFieldGlyphCache *>(cache)->isShared()) {
+        delete cache;
+        return;
+    }
+
+    SharedGlyphCaches *shared = qsg_sharedGlyphCaches();
+    QMutexLocker locker(&shared->mutex);
+    auto it = shared->caches.find({ m_rhi, key });
+    Q_ASSERT(it != shared->caches.end() && it->cache == cache);
+    it->users.removeOne(this);
+    if (it->users.isEmpty()) {
+        delete it->cache;
+        shared->caches.erase(it);
+        return;
+    }
+
+    it->cache->removeUser(this);
+
+    // The uploads not committed yet stay with the cache
+    if (it->cache->renderContext() == this)
+        it->cache->setRenderContext(it->users.first());
+}
+
+/*!
+    Returns the size in bytes of the distance field glyph cache textures
+    used by this render context. Caches shared with other render contexts
+    are counted in equal parts for each of them, so that the values of all
+    windows add up to the memory actually used.
+ */
+qint64 QSGDefaultRenderContext::glyphCacheTextureMemory() const
+{
+    SharedGlyphCaches *shared = qsg_sharedGlyphCaches();
+    QMutexLocker locker(&shared->mutex);
+
+    qint64 bytes = 0;
+    for (auto it = m_glyphCaches.cbegin(); it != m_glyphCaches.cend(); ++it) {
+        const auto *cache = static_cast<QSGRhiDistanceFieldGlyphCache *>(it.value());
+        const qsizetype users = cache->isShared()
+                ? shared->caches.value({ m_rhi, it.key() }).users.size()
+                : 1;
+        bytes += cache->textureMemory() / qMax(qsizetype(1), users);
+    }
+    return bytes;
+}
+
+// For autotests
+QList<QSGDistanceFieldGlyphCache *> QSGDefaultRenderContext::distanceFieldGlyphCaches() const
+{
+    return m_glyphCaches.values();
+}
+
+// For autotests
+bool QSGDefaultRenderContext::isGlyphCacheSharingEnabled()
+{
+    return qsg_shareGlyphCaches();
+}
+
+// For autotests
+void QSGDefaultRenderContext::setGlyphCacheSharingEnabled(bool enabled)
+{
+    qsg_shareGlyphCaches() = enabled;
+}
+
+// For autotests
+int QSGDefaultRenderContext::sharedGlyphCacheCount()
+{
+    SharedGlyphCaches *shared = qsg_sharedGlyphCaches();
+    QMutexLocker locker(&shared->mutex);
+    return int(shared->caches.size());
+}
+
 QRhiResourceUpdateBatch *QSGDefaultRenderContext::maybeGlyphCacheResourceUpdates()
 {
     return m_glyphCacheResourceUpdates;
@@ -106,8 +106,17 @@ public:
     void deferredReleaseGlyphCacheTexture(QRhiTexture *texture);
     void resetGlyphCacheResources();
 
+    qint64 glyphCacheTextureMemory() const;
+
+    // For autotests
+    QList<QSGDistanceFieldGlyphCache *> distanceFieldGlyphCaches() const;
+    static bool isGlyphCacheSharingEnabled();
+    static void setGlyphCacheSharingEnabled(bool enabled);
+    static int sharedGlyphCacheCount();
+
 protected:
     static QString fontKey(const QRawFont &font, int renderTypeQuality);
+    void releaseGlyphCache(const QString &key, QSGDistanceFieldGlyphCache *cache);
 
     InitParams m_initParams;
     QRhi *m_rhi;
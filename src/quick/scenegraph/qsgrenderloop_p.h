@@ -73,6 +73,7 @@ public:
     static void setInstance(QSGRenderLoop *instance);
 
     virtual bool interleaveIncubation() const { return false; }
+    virtual int remainingFrameTime() const { return -1; }
 
     virtual int flags() const { return 0; }
 
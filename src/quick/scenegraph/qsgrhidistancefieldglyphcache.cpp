@@ -21,23 +21,55 @@ DEFINE_BOOL_CONFIG_OPTION(qsgPreferFullSizeGlyphCacheTextures, QSG_PREFER_FULLSI
 
 QSGRhiDistanceFieldGlyphCache::QSGRhiDistanceFieldGlyphCache(QSGDefaultRenderContext *rc,
                                                              const QRawFont &font,
-                                                             int renderTypeQuality)
+                                                             int renderTypeQuality,
+                                                             bool shared)
     : QSGDistanceFieldGlyphCache(font, renderTypeQuality)
     , m_rc(rc)
     , m_rhi(rc->rhi())
+    , m_shared(shared)
 {
+    m_users.append(rc);
+    updateGlyphsReadyCallback();
+
     // Load a pregenerated cache if the font contains one
     loadPregeneratedCache(font);
 }
 
 QSGRhiDistanceFieldGlyphCache::~QSGRhiDistanceFieldGlyphCache()
 {
+    setGlyphsReadyCallback(nullptr);
+
     for (const TextureInfo &t : std::as_const(m_textures))
-        m_rc->deferredReleaseGlyphCacheTexture(t.texture);
+        deferredReleaseTexture(t.texture);
+
+    if (m_shared) {
+        if (m_resourceUpdates)
+            m_resourceUpdates->release();
+        for (QRhiTexture *t : std::as_const(m_texturesToRelease))
+            t->deleteLater();
+    }
 
     delete m_areaAllocator;
 }
 
+QRhiResourceUpdateBatch *QSGRhiDistanceFieldGlyphCache::resourceUpdates()
+{
+    if (!m_shared)
+        return m_rc->glyphCacheResourceUpdates();
+
+    if (!m_resourceUpdates)
+        m_resourceUpdates = m_rhi->nextResourceUpdateBatch();
+    return m_resourceUpdates;
+}
+
+void QSGRhiDistanceFieldGlyphCache::deferredReleaseTexture(QRhiTexture *texture)
+{
+    if (!m_shared)
+        m_rc->deferredReleaseGlyphCacheTexture(texture);
+    else if (texture)
+        m_texturesToRelease.insert(texture);
+}
+
 void QSGRhiDistanceFieldGlyphCache::requestGlyphs(const QSet<glyph_t> &glyphs)
 {
     QList<GlyphPosition> glyphPositions;
@@ -146,7 +178,7 @@ void QSGRhiDistanceFieldGlyphCache::storeGlyphs(const QList<QDistanceField> &gly
         texInfo->uploads.append(QRhiTextureUploadEntry(0, 0, subresDesc));
     }
 
-    QRhiResourceUpdateBatch *resourceUpdates = m_rc->glyphCacheResourceUpdates();
+    QRhiResourceUpdateBatch *resourceUpdates = this->resourceUpdates();
     for (int i = 0; i < glyphs.size(); ++i) {
         TextureInfo *texInfo = m_glyphsTexture.value(glyphs.at(i).glyph());
         if (!texInfo->uploads.isEmpty()) {
@@ -197,7 +229,7 @@ void QSGRhiDistanceFieldGlyphCache::createTexture(TextureInfo *texInfo,
 
     texInfo->texture = m_rhi->newTexture(QRhiTexture::RED_OR_ALPHA8, QSize(width, height), 1, QRhiTexture::UsedAsTransferSource);
     if (texInfo->texture->create()) {
-        QRhiResourceUpdateBatch *resourceUpdates = m_rc->glyphCacheResourceUpdates();
+        QRhiResourceUpdateBatch *resourceUpdates = this->resourceUpdates();
         QRhiTextureSubresourceUploadDescription subresDesc(pixels, width * height);
         subresDesc.setSourceSize(QSize(width, height));
         resourceUpdates->uploadTexture(texInfo->texture, QRhiTextureUploadEntry(0, 0, subresDesc));
@@ -223,7 +255,7 @@ void QSGRhiDistanceFieldGlyphCache::resizeTexture(TextureInfo *texInfo, int widt
 
     updateRhiTexture(oldTexture, texInfo->texture, texInfo->size);
 
-    QRhiResourceUpdateBatch *resourceUpdates = m_rc->glyphCacheResourceUpdates();
+    QRhiResourceUpdateBatch *resourceUpdates = this->resourceUpdates();
     if (useTextureResizeWorkaround()) {
         QRhiTextureSubresourceUploadDescription subresDesc(texInfo->image.constBits(),
                                                            oldWidth * oldHeight);
@@ -234,7 +266,7 @@ void QSGRhiDistanceFieldGlyphCache::resizeTexture(TextureInfo *texInfo, int widt
         resourceUpdates->copyTexture(texInfo->texture, oldTexture);
     }
 
-    m_rc->deferredReleaseGlyphCacheTexture(oldTexture);
+    deferredReleaseTexture(oldTexture);
 }
 
 bool QSGRhiDistanceFieldGlyphCache::useTextureResizeWorkaround() const
@@ -509,8 +541,70 @@ bool QSGRhiDistanceFieldGlyphCache::loadPregeneratedCache(const QRawFont &font)
     return true;
 }
 
+/*!
+    Makes \a rc, which must use the same QRhi, the owner of this cache. Used
+    when a glyph cache shared between render contexts outlives the one that
+    created it. Shared caches keep their resource updates themselves, so
+    there is nothing else to hand over.
+ */
+void QSGRhiDistanceFieldGlyphCache::setRenderContext(QSGDefaultRenderContext *rc)
+{
+    Q_ASSERT(rc->rhi() == m_rhi && m_users.contains(rc));
+    m_rc = rc;
+}
+
+/*!
+    Adds \a rc, which must use the same QRhi, to the render contexts using
+    this shared cache. All of them are notified when glyphs generated on
+    worker threads are ready, since any of their windows may show them.
+ */
+void QSGRhiDistanceFieldGlyphCache::addUser(QSGDefaultRenderContext *rc)
+{
+    Q_ASSERT(rc->rhi() == m_rhi && !m_users.contains(rc));
+    m_users.append(rc);
+    updateGlyphsReadyCallback();
+}
+
+void QSGRhiDistanceFieldGlyphCache::removeUser(QSGDefaultRenderContext *rc)
+{
+    m_users.removeOne(rc);
+    updateGlyphsReadyCallback();
+}
+
+void QSGRhiDistanceFieldGlyphCache::updateGlyphsReadyCallback()
+{
+    // Called on a worker thread, so it gets its own copy of the users
+    setGlyphsReadyCallback([users = m_users] {
+        for (QSGDefaultRenderContext *rc : users)
+            emit rc->glyphsReady();
+    });
+}
+
+qint64 QSGRhiDistanceFieldGlyphCache::textureMemory() const
+{
+    // RED_OR_ALPHA8, one byte per texel
+    qint64 bytes = 0;
+    for (const TextureInfo &t : m_textures) {
+        if (t.texture)
+            bytes += qint64(t.size.width()) * t.size.height();
+    }
+    return bytes;
+}
+
 void QSGRhiDistanceFieldGlyphCache::commitResourceUpdates(QRhiResourceUpdateBatch *mergeInto)
 {
+    if (m_shared) {
+        if (m_resourceUpdates) {
+            mergeInto->merge(m_resourceUpdates);
+            m_resourceUpdates->release();
+            m_resourceUpdates = nullptr;
+        }
+        for (QRhiTexture *t : std::as_const(m_texturesToRelease))
+            t->deleteLater(); // the QRhiTexture object stays valid for the current frame
+        m_texturesToRelease.clear();
+        return;
+    }
+
     if (QRhiResourceUpdateBatch *resourceUpdates = m_rc->maybeGlyphCacheResourceUpdates()) {
         mergeInto->merge(resourceUpdates);
         m_rc->resetGlyphCacheResources();
@@ -561,7 +655,7 @@ void QSGRhiDistanceFieldGlyphCache::saveTexture(QRhiTexture *texture, const QStr
     };
 
     QRhiReadbackDescription rb(texture);
-    QRhiResourceUpdateBatch *resourceUpdates = m_rc->glyphCacheResourceUpdates();
+    QRhiResourceUpdateBatch *resourceUpdates = this->resourceUpdates();
     resourceUpdates->readBackTexture(rb, rbResult);
 }
 #endif
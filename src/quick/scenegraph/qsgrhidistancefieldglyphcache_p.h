@@ -26,7 +26,8 @@ class QSGDefaultRenderContext;
 class Q_QUICK_PRIVATE_EXPORT QSGRhiDistanceFieldGlyphCache : public QSGDistanceFieldGlyphCache
 {
 public:
-    QSGRhiDistanceFieldGlyphCache(QSGDefaultRenderContext *rc, const QRawFont &font, int renderTypeQuality);
+    QSGRhiDistanceFieldGlyphCache(QSGDefaultRenderContext *rc, const QRawFont &font, int renderTypeQuality,
+                                  bool shared = false);
     virtual ~QSGRhiDistanceFieldGlyphCache();
 
     void requestGlyphs(const QSet<glyph_t> &glyphs) override;
@@ -44,6 +45,13 @@ public:
 
     void commitResourceUpdates(QRhiResourceUpdateBatch *mergeInto);
 
+    bool isShared() const { return m_shared; }
+    QSGDefaultRenderContext *renderContext() const { return m_rc; }
+    void setRenderContext(QSGDefaultRenderContext *rc);
+    void addUser(QSGDefaultRenderContext *rc);
+    void removeUser(QSGDefaultRenderContext *rc);
+    qint64 textureMemory() const;
+
     bool eightBitFormatIsAlphaSwizzled() const override;
     bool screenSpaceDerivativesSupported() const override;
 
@@ -54,6 +62,10 @@ public:
 private:
     bool loadPregeneratedCache(const QRawFont &font);
 
+    QRhiResourceUpdateBatch *resourceUpdates();
+    void deferredReleaseTexture(QRhiTexture *texture);
+    void updateGlyphsReadyCallback();
+
     struct TextureInfo {
         QRhiTexture *texture;
         QSize size;
@@ -91,6 +103,13 @@ private:
     QSet<glyph_t> m_unusedGlyphs;
     QSet<glyph_t> m_referencedGlyphs;
     QSet<QRhiTexture *> m_pendingDispose;
+
+    // A cache shared between render contexts keeps its own resource updates
+    // and textures to release, so that they can outlive any of them.
+    bool m_shared;
+    QVarLengthArray<QSGDefaultRenderContext *, 4> m_users;
+    QRhiResourceUpdateBatch *m_resourceUpdates = nullptr;
+    QSet<QRhiTexture *> m_texturesToRelease;
 };
 
 QT_END_NAMESPACE
@@ -1031,6 +1031,21 @@ bool QSGThreadedRenderLoop::interleaveIncubation() const
     return m_animation_driver->isRunning() && anyoneShowing();
 }
 
+/*
+    Returns the time in milliseconds that is left of the frame currently being
+    prepared on the gui thread until the next one is due, based on the vsync
+    interval of the animation driver. Returns -1 if timeToIncubate() is not
+    emitted as part of preparing a frame.
+ */
+int QSGThreadedRenderLoop::remainingFrameTime() const
+{
+    if (!m_frameTimer.isValid())
+        return -1;
+
+    const float interval = sg->vsyncIntervalForAnimationDriver(m_animation_driver);
+    return qMax(0, int(interval) - int(m_frameTimer.elapsed()));
+}
+
 void QSGThreadedRenderLoop::animationStarted()
 {
     qCDebug(QSG_LOG_RENDERLOOP, "- animationStarted()");
@@ -1520,6 +1535,7 @@ void QSGThreadedRenderLoop::polishAndSync(Window *w, bool inExpose)
     qint64 syncTime = 0;
 
     const qint64 elapsedSinceLastMs = w->timeBetweenPolishAndSyncs.restart();
+    m_frameTimer.start();
 
     if (w->actualWindowFormat.swapInterval() != 0 && sg->isVSyncDependent(m_animation_driver)) {
         w->psTimeAccumulator += elapsedSinceLastMs;
@@ -1683,6 +1699,8 @@ bool QSGThreadedRenderLoop::event(QEvent *e)
         if (te->timerId() == m_animation_timer) {
             qCDebug(QSG_LOG_RENDERLOOP, "- ticking non-render thread timer");
             m_animation_driver->advance();
+            // Not in sync with any particular window's frames
+            m_frameTimer.invalidate();
             emit timeToIncubate();
             return true;
         }
@@ -56,6 +56,7 @@ public:
     void postJob(QQuickWindow *window, QRunnable *job) override;
 
     bool interleaveIncubation() const override;
+    int remainingFrameTime() const override;
 
 public Q_SLOTS:
     void animationStarted();
@@ -105,6 +106,9 @@ private:
 
     int m_animation_timer;
 
+    // Started when the gui thread begins preparing a frame in polishAndSync()
+    QElapsedTimer m_frameTimer;
+
     bool m_lockedForSync;
     bool m_inPolish = false;
 };
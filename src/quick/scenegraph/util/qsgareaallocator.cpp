@@ -56,9 +56,38 @@ bool QSGAreaAllocatorNode::isLeaf()
 }
 
 
-QSGAreaAllocator::QSGAreaAllocator(const QSize &size) : m_size(size)
+/*!
+    \class QSGAreaAllocator
+    \internal
+
+    Hands out rectangles of a fixed size area, for example for a texture
+    atlas.
+
+    The BinaryTree strategy splits the area into a tree of free and taken
+    rectangles. Freed space is only merged back with neighbors that came
+    from the same split, so with many differently sized rectangles coming
+    and going, the free space ends up in pieces too small to use.
+
+    The Skyline strategy packs rectangles bottom-left along the upper
+    edge of what is taken so far. Space left below that edge, and space
+    that is freed, is kept in a list of free rectangles which is searched
+    first and merged whenever two of them share an edge. Freed space that
+    touches the edge lowers it instead, and once everything has been
+    freed the area starts over empty.
+ */
+
+static inline quint64 skylineKey(const QPoint &pos)
+{
+    return (quint64(quint32(pos.x())) << 32) | quint32(pos.y());
+}
+
+QSGAreaAllocator::QSGAreaAllocator(const QSize &size, Strategy strategy)
+    : m_size(size)
+    , m_strategy(strategy)
 {
     m_root = new QSGAreaAllocatorNode(nullptr);
+    if (m_strategy == Skyline)
+        resetSkyline();
 }
 
 QSGAreaAllocator::~QSGAreaAllocator()
@@ -68,14 +97,304 @@ QSGAreaAllocator::~QSGAreaAllocator()
 
 QRect QSGAreaAllocator::allocate(const QSize &size)
 {
-    QPoint point;
-    bool result = allocateInNode(size, point, QRect(QPoint(0, 0), m_size), m_root);
-    return result ? QRect(point, size) : QRect();
+    QRect result;
+    if (m_strategy == Skyline) {
+        if (size.isEmpty())
+            return QRect();
+        result = allocateInSkyline(size);
+        if (!result.isNull())
+            m_skylineAllocations.insert(skylineKey(result.topLeft()), size);
+    } else {
+        QPoint point;
+        if (allocateInNode(size, point, QRect(QPoint(0, 0), m_size), m_root))
+            result = QRect(point, size);
+    }
+
+    if (!result.isNull()) {
+        ++m_allocationCount;
+        m_usedArea += qint64(size.width()) * size.height();
+    }
+    return result;
 }
 
 bool QSGAreaAllocator::deallocate(const QRect &rect)
 {
-    return deallocateInNode(rect.topLeft(), m_root);
+    if (m_strategy == Skyline) {
+        auto it = m_skylineAllocations.find(skylineKey(rect.topLeft()));
+        if (it == m_skylineAllocations.end())
+            return false;
+        const QRect allocated(rect.topLeft(), it.value());
+        m_skylineAllocations.erase(it);
+        --m_allocationCount;
+        m_usedArea -= qint64(allocated.width()) * allocated.height();
+        if (m_allocationCount == 0)
+            resetSkyline();
+        else if (!lowerSkyline(allocated))
+            addFreeRect(allocated);
+        return true;
+    }
+
+    if (!deallocateInNode(rect.topLeft(), m_root))
+        return false;
+    --m_allocationCount;
+    m_usedArea -= qint64(rect.width()) * rect.height();
+    return true;
+}
+
+/*!
+    Returns how much of the free area is unusable for the largest
+    rectangle that could still be allocated, from 0 when all of the free
+    area is in one piece to close to 1 when it is scattered.
+ */
+qreal QSGAreaAllocator::fragmentation() const
+{
+    const qint64 freeArea = qint64(m_size.width()) * m_size.height() - m_usedArea;
+    if (freeArea <= 0)
+        return 0;
+    const qint64 largest = m_strategy == Skyline
+            ? largestFreeAreaInSkyline()
+            : largestFreeAreaInNode(QRect(QPoint(0, 0), m_size), m_root);
+    return qBound(qreal(0), 1 - qreal(largest) / qreal(freeArea), qreal(1));
+}
+
+qint64 QSGAreaAllocator::largestFreeAreaInNode(const QRect &currentRect, const QSGAreaAllocatorNode *node) const
+{
+    if (!node->left) {
+        return node->isOccupied ? 0 : qint64(currentRect.width()) * currentRect.height();
+    }
+
+    QRect leftRect = currentRect;
+    QRect rightRect = currentRect;
+    if (node->splitType == HorizontalSplit) {
+        leftRect.setHeight(node->split - leftRect.top());
+        rightRect.setTop(node->split);
+    } else {
+        leftRect.setWidth(node->split - leftRect.left());
+        rightRect.setLeft(node->split);
+    }
+    return qMax(largestFreeAreaInNode(leftRect, node->left),
+                largestFreeAreaInNode(rightRect, node->right));
+}
+
+void QSGAreaAllocator::resetSkyline()
+{
+    m_skyline.clear();
+    m_skyline.append({ 0, 0, m_size.width() });
+    m_freeRects.clear();
+}
+
+QRect QSGAreaAllocator::allocateInSkyline(const QSize &size)
+{
+    const int w = size.width();
+    const int h = size.height();
+
+    // Reuse freed space first, picking the piece that leaves the least over
+    int bestFree = -1;
+    qint64 bestFreeArea = 0;
+    for (int i = 0; i < m_freeRects.size(); ++i) {
+        const QRect &free = m_freeRects.at(i);
+        if (free.width() < w || free.height() < h)
+            continue;
+        const qint64 area = qint64(free.width()) * free.height();
+        if (bestFree < 0 || area < bestFreeArea) {
+            bestFree = i;
+            bestFreeArea = area;
+        }
+    }
+    if (bestFree >= 0) {
+        const QRect free = m_freeRects.takeAt(bestFree);
+        const QRect result(free.topLeft(), size);
+        // Split what is left along the shorter side, keeping the larger piece whole
+        const int rightWidth = free.width() - w;
+        const int bottomHeight = free.height() - h;
+        if (rightWidth * free.height() > bottomHeight * free.width()) {
+            addFreeRect(QRect(free.x() + w, free.y(), rightWidth, free.height()));
+            addFreeRect(QRect(free.x(), free.y() + h, w, bottomHeight));
+        } else {
+            addFreeRect(QRect(free.x(), free.y() + h, free.width(), bottomHeight));
+            addFreeRect(QRect(free.x() + w, free.y(), rightWidth, h));
+        }
+        return result;
+    }
+
+    // Otherwise go where the top of the new rectangle ends up lowest
+    int bestIndex = -1;
+    int bestY = 0;
+    for (int i = 0; i < m_skyline.size(); ++i) {
+        const int x = m_skyline.at(i).x;
+        if (x + w > m_size.width())
+            break;
+        int y = 0;
+        for (int j = i, covered = 0; covered < w; ++j) {
+            y = qMax(y, m_skyline.at(j).y);
+            covered += m_skyline.at(j).width;
+        }
+        if (y + h > m_size.height())
+            continue;
+        if (bestIndex < 0 || y < bestY) {
+            bestIndex = i;
+            bestY = y;
+        }
+    }
+    if (bestIndex < 0)
+        return QRect();
+
+    const int x = m_skyline.at(bestIndex).x;
+    const QRect result(x, bestY, w, h);
+
+    // Remember the space that is left below the new rectangle
+    QVarLengthArray<QRect, 4> below;
+    for (int j = bestIndex, covered = 0; covered < w; ++j) {
+        const SkylineSegment &segment = m_skyline.at(j);
+        const int width = qMin(segment.width, w - covered);
+        if (segment.y < bestY)
+            below.append(QRect(segment.x, segment.y, width, bestY - segment.y));
+        covered += width;
+    }
+
+    // Raise the skyline, cutting away the segments now covered
+    m_skyline.insert(bestIndex, { x, bestY + h, w });
+    for (int i = bestIndex + 1; i < m_skyline.size();) {
+        SkylineSegment &segment = m_skyline[i];
+        const int overlap = x + w - segment.x;
+        if (overlap <= 0)
+            break;
+        if (segment.width <= overlap) {
+            m_skyline.removeAt(i);
+            continue;
+        }
+        segment.x += overlap;
+        segment.width -= overlap;
+        break;
+    }
+    for (int i = 0; i < m_skyline.size() - 1;) {
+        if (m_skyline.at(i).y == m_skyline.at(i + 1).y) {
+            m_skyline[i].width += m_skyline.at(i + 1).width;
+            m_skyline.removeAt(i + 1);
+        } else {
+            ++i;
+        }
+    }
+
+    for (const QRect &rect : below)
+        addFreeRect(rect);
+
+    return result;
+}
+
+/*
+    Lowers the skyline where \a rect is directly below it along its whole
+    width, which makes the area above the rectangle free again.
+ */
+bool QSGAreaAllocator::lowerSkyline(const QRect &rect)
+{
+    const int left = rect.x();
+    const int right = rect.x() + rect.width();
+    const int top = rect.y() + rect.height();
+
+    int first = -1;
+    for (int i = 0; i < m_skyline.size(); ++i) {
+        const SkylineSegment &segment = m_skyline.at(i);
+        if (segment.x + segment.width <= left)
+            continue;
+        if (segment.x >= right)
+            break;
+        if (segment.y != top)
+            return false;
+        if (first < 0)
+            first = i;
+    }
+    if (first < 0)
+        return false;
+
+    // Split the segments at the edges of the rectangle, then lower the middle
+    QList<SkylineSegment> lowered;
+    lowered.reserve(m_skyline.size() + 2);
+    for (const SkylineSegment &segment : std::as_const(m_skyline)) {
+        const int end = segment.x + segment.width;
+        if (end <= left || segment.x >= right) {
+            lowered.append(segment);
+            continue;
+        }
+        if (segment.x < left)
+            lowered.append({ segment.x, segment.y, left - segment.x });
+        const int from = qMax(segment.x, left);
+        const int to = qMin(end, right);
+        if (!lowered.isEmpty() && lowered.last().y == rect.y() && lowered.last().x + lowered.last().width == from)
+            lowered.last().width += to - from;
+        else
+            lowered.append({ from, rect.y(), to - from });
+        if (end > right)
+            lowered.append({ right, segment.y, end - right });
+    }
+    for (int i = 0; i < lowered.size() - 1;) {
+        if (lowered.at(i).y == lowered.at(i + 1).y) {
+            lowered[i].width += lowered.at(i + 1).width;
+            lowered.removeAt(i + 1);
+        } else {
+            ++i;
+        }
+    }
+    m_skyline = std::move(lowered);
+
+    // Free space that is now directly below the skyline goes up in it too
+    for (int i = 0; i < m_freeRects.size(); ++i) {
+        const QRect free = m_freeRects.at(i);
+        if (free.y() + free.height() == rect.y() && free.x() < right && free.x() + free.width() > left) {
+            m_freeRects.removeAt(i);
+            if (lowerSkyline(free))
+                i = -1;
+            else
+                m_freeRects.insert(i, free);
+        }
+    }
+    return true;
+}
+
+void QSGAreaAllocator::addFreeRect(QRect rect)
+{
+    if (rect.isEmpty())
+        return;
+
+    // Merge with free rectangles sharing a whole edge, for as long as possible
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (int i = 0; i < m_freeRects.size(); ++i) {
+            const QRect &other = m_freeRects.at(i);
+            const bool sameColumn = other.x() == rect.x() && other.width() == rect.width();
+            const bool sameRow = other.y() == rect.y() && other.height() == rect.height();
+            if ((sameColumn && (other.bottom() + 1 == rect.top() || rect.bottom() + 1 == other.top()))
+                    || (sameRow && (other.right() + 1 == rect.left() || rect.right() + 1 == other.left()))) {
+                rect = rect.united(other);
+                m_freeRects.removeAt(i);
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    if (!lowerSkyline(rect))
+        m_freeRects.append(rect);
+}
+
+qint64 QSGAreaAllocator::largestFreeAreaInSkyline() const
+{
+    qint64 largest = 0;
+    for (const QRect &free : m_freeRects)
+        largest = qMax(largest, qint64(free.width()) * free.height());
+
+    // The largest rectangle that fits above the skyline
+    for (int i = 0; i < m_skyline.size(); ++i) {
+        int y = 0;
+        int width = 0;
+        for (int j = i; j < m_skyline.size(); ++j) {
+            y = qMax(y, m_skyline.at(j).y);
+            width += m_skyline.at(j).width;
+            largest = qMax(largest, qint64(width) * (m_size.height() - y));
+        }
+    }
+    return largest;
 }
 
 bool QSGAreaAllocator::allocateInNode(const QSize &size, QPoint &result, const QRect &currentRect, QSGAreaAllocatorNode *node)
@@ -339,6 +658,11 @@ const char *QSGAreaAllocator::deserialize(const char *data, int size)
         return nullptr;
     }
 
+    if (m_strategy != BinaryTree) {
+        qWarning("QSGAreaAllocator::deserialize: Only supported with the BinaryTree strategy");
+        return nullptr;
+    }
+
     const char *end = data + size;
 
     quint8 majorVersion = AreaAllocatorTable::fetch<quint8>(data, AreaAllocatorTable::majorVersion);
@@ -388,7 +712,34 @@ const char *QSGAreaAllocator::deserialize(const char *data, int size)
         data += AreaAllocatorTable::NodeSize;
     }
 
+    m_allocationCount = 0;
+    m_usedArea = 0;
+    countOccupiedInNode(QRect(QPoint(0, 0), m_size), m_root);
+
     return data;
 }
 
+void QSGAreaAllocator::countOccupiedInNode(const QRect &currentRect, const QSGAreaAllocatorNode *node)
+{
+    if (!node->left) {
+        if (node->isOccupied) {
+            ++m_allocationCount;
+            m_usedArea += qint64(currentRect.width()) * currentRect.height();
+        }
+        return;
+    }
+
+    QRect leftRect = currentRect;
+    QRect rightRect = currentRect;
+    if (node->splitType == HorizontalSplit) {
+        leftRect.setHeight(node->split - leftRect.top());
+        rightRect.setTop(node->split);
+    } else {
+        leftRect.setWidth(node->split - leftRect.left());
+        rightRect.setLeft(node->split);
+    }
+    countOccupiedInNode(leftRect, node->left);
+    countOccupiedInNode(rightRect, node->right);
+}
+
 QT_END_NAMESPACE
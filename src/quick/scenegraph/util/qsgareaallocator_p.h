@@ -17,23 +17,36 @@
 
 #include <private/qtquickglobal_p.h>
 #include <QtCore/qsize.h>
+#include <QtCore/qrect.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
 
 QT_BEGIN_NAMESPACE
 
-class QRect;
 class QPoint;
 struct QSGAreaAllocatorNode;
 class Q_QUICK_PRIVATE_EXPORT QSGAreaAllocator
 {
 public:
-    QSGAreaAllocator(const QSize &size);
+    enum Strategy {
+        BinaryTree,
+        Skyline
+    };
+
+    QSGAreaAllocator(const QSize &size, Strategy strategy = BinaryTree);
     ~QSGAreaAllocator();
 
     QRect allocate(const QSize &size);
     bool deallocate(const QRect &rect);
     bool isEmpty() const { return m_root == nullptr; }
     QSize size() const { return m_size; }
+    Strategy strategy() const { return m_strategy; }
+
+    int allocationCount() const { return m_allocationCount; }
+    qint64 usedArea() const { return m_usedArea; }
+    qreal fragmentation() const;
 
+    // Only supported with the BinaryTree strategy
     QByteArray serialize();
     const char *deserialize(const char *data, int size);
 
@@ -41,9 +54,30 @@ private:
     bool allocateInNode(const QSize &size, QPoint &result, const QRect &currentRect, QSGAreaAllocatorNode *node);
     bool deallocateInNode(const QPoint &pos, QSGAreaAllocatorNode *node);
     void mergeNodeWithNeighbors(QSGAreaAllocatorNode *node);
+    qint64 largestFreeAreaInNode(const QRect &currentRect, const QSGAreaAllocatorNode *node) const;
+    void countOccupiedInNode(const QRect &currentRect, const QSGAreaAllocatorNode *node);
+
+    struct SkylineSegment {
+        int x;
+        int y; // the first row that is not taken
+        int width;
+    };
+
+    QRect allocateInSkyline(const QSize &size);
+    void addFreeRect(QRect rect);
+    bool lowerSkyline(const QRect &rect);
+    void resetSkyline();
+    qint64 largestFreeAreaInSkyline() const;
 
     QSGAreaAllocatorNode *m_root;
     QSize m_size;
+    Strategy m_strategy;
+    int m_allocationCount = 0;
+    qint64 m_usedArea = 0;
+
+    QList<SkylineSegment> m_skyline;
+    QList<QRect> m_freeRects; // below the skyline
+    QHash<quint64, QSize> m_skylineAllocations;
 };
 
 QT_END_NAMESPACE
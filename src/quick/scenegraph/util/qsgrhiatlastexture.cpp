@@ -51,7 +51,16 @@ Manager::Manager(QSGDefaultRenderContext *rc, const QSize &surfacePixelSize, QSu
     m_atlas_size_limit = qt_sg_envInt("QSG_ATLAS_SIZE_LIMIT", qMax(w, h) / 2);
     m_atlas_size = QSize(w, h);
 
-    qCDebug(QSG_LOG_INFO, "rhi texture atlas dimensions: %dx%d", w, h);
+    if (qgetenv("QSG_ATLAS_ALLOCATOR") == "skyline")
+        m_allocator_strategy = QSGAreaAllocator::Skyline;
+
+    // When an image no longer fits and at least this percentage of the free
+    // space is unusable, start over in a new atlas instead of falling back
+    // to a standalone texture.
+    m_repack_threshold = qBound(0, qt_sg_envInt("QSG_ATLAS_REPACK_THRESHOLD", 0), 100) / 100.0;
+
+    qCDebug(QSG_LOG_INFO, "rhi texture atlas dimensions: %dx%d%s", w, h,
+            m_allocator_strategy == QSGAreaAllocator::Skyline ? ", skyline allocator" : "");
 }
 
 Manager::~Manager()
@@ -68,6 +77,12 @@ void Manager::invalidate()
         m_atlas = nullptr;
     }
 
+    if (m_retired_atlas) {
+        m_retired_atlas->invalidate();
+        m_retired_atlas->deleteLater();
+        m_retired_atlas = nullptr;
+    }
+
     QHash<unsigned int, QSGCompressedAtlasTexture::Atlas*>::iterator i = m_atlases.begin();
     while (i != m_atlases.end()) {
         i.value()->invalidate();
@@ -77,19 +92,57 @@ void Manager::invalidate()
     m_atlases.clear();
 }
 
+void Manager::releaseRetiredAtlas()
+{
+    if (m_retired_atlas && m_retired_atlas->allocator().allocationCount() == 0) {
+        m_retired_atlas->invalidate();
+        m_retired_atlas->deleteLater();
+        m_retired_atlas = nullptr;
+    }
+}
+
 QSGTexture *Manager::create(const QImage &image, bool hasAlphaChannel)
 {
     Texture *t = nullptr;
     if (image.width() < m_atlas_size_limit && image.height() < m_atlas_size_limit) {
+        releaseRetiredAtlas();
         if (!m_atlas)
-            m_atlas = new Atlas(m_rc, m_atlas_size);
+            m_atlas = new Atlas(m_rc, m_atlas_size, m_allocator_strategy);
         t = m_atlas->create(image);
-        if (t && !hasAlphaChannel && t->hasAlphaChannel())
+
+        // Textures cannot move within an atlas since nodes have their
+        // coordinates baked into the geometry. So when the atlas is too
+        // fragmented to take the image, let it drain and allocate into a
+        // fresh one, which the live textures move into as they get recreated.
+        if (!t && m_repack_threshold > 0 && !m_retired_atlas
+                && m_atlas->allocator().fragmentation() >= m_repack_threshold) {
+            qCDebug(QSG_LOG_INFO, "rhi texture atlas: retiring atlas with %d textures, %.0f%% fragmented",
+                    m_atlas->allocator().allocationCount(), m_atlas->allocator().fragmentation() * 100);
+            m_retired_atlas = m_atlas;
+            m_atlas = new Atlas(m_rc, m_atlas_size, m_allocator_strategy);
+            t = m_atlas->create(image);
+        }
+
+        if (!t) {
+            ++m_fallback_count;
+            qCDebug(QSG_LOG_INFO, "rhi texture atlas: no space for %dx%d image, using a standalone texture (%d so far)",
+                    image.width(), image.height(), m_fallback_count);
+        } else if (!hasAlphaChannel && t->hasAlphaChannel()) {
             t->setHasAlphaChannel(false);
+        }
     }
     return t;
 }
 
+/*!
+    Returns the fragmentation of the free space in the current atlas, see
+    QSGAreaAllocator::fragmentation().
+ */
+qreal Manager::fragmentation() const
+{
+    return m_atlas ? m_atlas->allocator().fragmentation() : 0;
+}
+
 QSGTexture *Manager::create(const QSGCompressedTextureFactory *factory)
 {
     QSGTexture *t = nullptr;
@@ -115,10 +168,10 @@ QSGTexture *Manager::create(const QSGCompressedTextureFactory *factory)
     return t;
 }
 
-AtlasBase::AtlasBase(QSGDefaultRenderContext *rc, const QSize &size)
+AtlasBase::AtlasBase(QSGDefaultRenderContext *rc, const QSize &size, QSGAreaAllocator::Strategy strategy)
     : m_rc(rc)
     , m_rhi(rc->rhi())
-    , m_allocator(size)
+    , m_allocator(size, strategy)
     , m_size(size)
 {
 }
@@ -157,8 +210,8 @@ void AtlasBase::remove(TextureBase *t)
     m_pending_uploads.removeOne(t);
 }
 
-Atlas::Atlas(QSGDefaultRenderContext *rc, const QSize &size)
-    : AtlasBase(rc, size)
+Atlas::Atlas(QSGDefaultRenderContext *rc, const QSize &size, QSGAreaAllocator::Strategy strategy)
+    : AtlasBase(rc, size, strategy)
 {
     // use RGBA texture internally as that is the only one guaranteed to be always supported
     m_format = QRhiTexture::RGBA8;
@@ -49,22 +49,35 @@ public:
     QSGTexture *create(const QSGCompressedTextureFactory *factory);
     void invalidate();
 
+    int fallbackCount() const { return m_fallback_count; }
+    qreal fragmentation() const;
+
+    void releaseRetiredAtlas();
+    bool hasRetiredAtlas() const { return m_retired_atlas != nullptr; }
+
 private:
+
     QSGDefaultRenderContext *m_rc;
     QRhi *m_rhi;
     Atlas *m_atlas = nullptr;
+    // full and fragmented, kept until the last texture in it is gone
+    Atlas *m_retired_atlas = nullptr;
     // set of atlases for different compressed formats
     QHash<unsigned int, QSGCompressedAtlasTexture::Atlas*> m_atlases;
 
     QSize m_atlas_size;
     int m_atlas_size_limit;
+    QSGAreaAllocator::Strategy m_allocator_strategy = QSGAreaAllocator::BinaryTree;
+    qreal m_repack_threshold = 0;
+    int m_fallback_count = 0;
 };
 
 class AtlasBase : public QObject
 {
     Q_OBJECT
 public:
-    AtlasBase(QSGDefaultRenderContext *rc, const QSize &size);
+    AtlasBase(QSGDefaultRenderContext *rc, const QSize &size,
+              QSGAreaAllocator::Strategy strategy = QSGAreaAllocator::BinaryTree);
     ~AtlasBase();
 
     void invalidate();
@@ -75,6 +88,7 @@ public:
     QRhi *rhi() const { return m_rhi; }
     QRhiTexture *texture() const { return m_texture; }
     QSize size() const { return m_size; }
+    const QSGAreaAllocator &allocator() const { return m_allocator; }
 
 protected:
     virtual bool generateTexture() = 0;
@@ -97,7 +111,8 @@ private:
 class Atlas : public AtlasBase
 {
 public:
-    Atlas(QSGDefaultRenderContext *rc, const QSize &size);
+    Atlas(QSGDefaultRenderContext *rc, const QSize &size,
+          QSGAreaAllocator::Strategy strategy = QSGAreaAllocator::BinaryTree);
     ~Atlas();
 
     bool generateTexture() override;
@@ -0,0 +1,7 @@
+import QtQml
+
+QtObject {
+    property bool cyclic: false
+    property int a: cyclic ? b + 1 : 0
+    property int b: a + 1
+}
@@ -0,0 +1,17 @@
+import QtQml
+
+QtObject {
+    property int source: 0
+    property int hits: 0
+    property int watched: hits * 10
+
+    property int relay1: 0
+    property int relay2: 0
+    property int step1: source + 1
+    property int step2: relay1 + 1
+    property int step3: relay2 + 1
+
+    onStep1Changed: { relay1 = step1; ++hits }
+    onStep2Changed: { relay2 = step2; ++hits }
+    onStep3Changed: ++hits
+}
@@ -0,0 +1,15 @@
+import QtQml
+
+QtObject {
+    property int source: 0
+    property int left: source + 1
+    property int right: source * 2
+
+    property var counter: ({ count: 0 })
+    property int sum: {
+        ++counter.count;
+        return left + right;
+    }
+
+    function evaluations() { return counter.count }
+}
@@ -0,0 +1,7 @@
+import QtQml
+
+QtObject {
+    property int source: 0
+    property int hot: source * 2
+    property int cold: 1 + 1
+}
@@ -1,9 +1,12 @@
 // Copyright (C) 2016 The Qt Company Ltd.
 // SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
 #include <qtest.h>
+#include <QtCore/qscopeguard.h>
 #include <QtQml/qqmlengine.h>
 #include <QtQml/qqmlcomponent.h>
 #include <QtQml/private/qqmlbind_p.h>
+#include <QtQml/private/qqmlbindingbatch_p.h>
+#include <QtQml/private/qqmlbindingstatistics_p.h>
 #include <QtQml/private/qqmlcomponentattached_p.h>
 #include <QtQuick/private/qquickrectangle_p.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
@@ -40,6 +43,10 @@ private slots:
     void localSignalHandler();
     void whenEvaluatedEarlyEnough();
     void propertiesAttachedToBindingItself();
+    void batchedUpdates();
+    void batchedBindingLoop();
+    void batchedRetriggers();
+    void bindingStatistics();
 
 private:
     QQmlEngine engine;
@@ -625,6 +632,143 @@ void tst_qqmlbinding::propertiesAttachedToBindingItself()
     QTRY_COMPARE(root->property("check").toInt(), 3);
 }
 
+void tst_qqmlbinding::batchedUpdates()
+{
+    QQmlEngine e;
+    QQmlComponent c(&e, testFileUrl("batchedUpdates.qml"));
+    QVERIFY2(c.isReady(), qPrintable(c.errorString()));
+    std::unique_ptr<QObject> root { c.create() };
+    QVERIFY(root);
+
+    const auto evaluations = [&]() {
+        QVariant result;
+        QMetaObject::invokeMethod(root.get(), "evaluations", Q_RETURN_ARG(QVariant, result));
+        return result.toInt();
+    };
+
+    // Without a batch, the bottom of the diamond is evaluated once per path
+    int before = evaluations();
+    root->setProperty("source", 1);
+    QCOMPARE(root->property("sum").toInt(), 4);
+    QCOMPARE(evaluations(), before + 2);
+
+    before = evaluations();
+    {
+        QQmlBindingBatch batch(&e);
+        root->setProperty("source", 2);
+        root->setProperty("source", 3);
+        QCOMPARE(root->property("left").toInt(), 2);
+        QCOMPARE(evaluations(), before);
+
+        {
+            // Nested batches are merged into the outermost one
+            QQmlBindingBatch nested(&e);
+            root->setProperty("source", 4);
+        }
+        QCOMPARE(root->property("left").toInt(), 2);
+    }
+    QCOMPARE(root->property("left").toInt(), 5);
+    QCOMPARE(root->property("right").toInt(), 8);
+    QCOMPARE(root->property("sum").toInt(), 13);
+    QCOMPARE(evaluations(), before + 1);
+
+    before = evaluations();
+    {
+        QQmlBindingBatch batch(&e);
+        root->setProperty("source", 5);
+        batch.flush();
+        QCOMPARE(root->property("sum").toInt(), 16);
+        QCOMPARE(evaluations(), before + 1);
+    }
+    QCOMPARE(evaluations(), before + 1);
+}
+
+void tst_qqmlbinding::batchedBindingLoop()
+{
+    QQmlEngine e;
+    QQmlComponent c(&e, testFileUrl("batchedBindingLoop.qml"));
+    QVERIFY2(c.isReady(), qPrintable(c.errorString()));
+    std::unique_ptr<QObject> root { c.create() };
+    QVERIFY(root);
+    QCOMPARE(root->property("b").toInt(), 1);
+
+    // Evaluating a queues b, whose evaluation queues a again. That is
+    // reported, and a is not evaluated again, as without a batch.
+    QTest::ignoreMessage(QtWarningMsg,
+                         QRegularExpression(".*Binding loop detected for property \"a\""));
+    {
+        QQmlBindingBatch batch(&e);
+        root->setProperty("cyclic", true);
+    }
+    QCOMPARE(root->property("a").toInt(), 2);
+    QCOMPARE(root->property("b").toInt(), 3);
+}
+
+void tst_qqmlbinding::batchedRetriggers()
+{
+    QQmlEngine e;
+    QQmlComponent c(&e, testFileUrl("batchedRetriggers.qml"));
+    QVERIFY2(c.isReady(), qPrintable(c.errorString()));
+    std::unique_ptr<QObject> root { c.create() };
+    QVERIFY(root);
+
+    // The change handlers of step1, step2 and step3 each change hits, in
+    // consecutive rounds of the flush. That re-triggers watched three times
+    // without a cycle, so it must not be taken for a binding loop.
+    QTest::failOnWarning(QRegularExpression(".*Binding loop detected.*"));
+    const int hits = root->property("hits").toInt();
+    {
+        QQmlBindingBatch batch(&e);
+        root->setProperty("source", 1);
+        QCOMPARE(root->property("hits").toInt(), hits);
+    }
+    QCOMPARE(root->property("step3").toInt(), 4);
+    QCOMPARE(root->property("hits").toInt(), hits + 3);
+    QCOMPARE(root->property("watched").toInt(), (hits + 3) * 10);
+}
+
+void tst_qqmlbinding::bindingStatistics()
+{
+    QQmlBindingStatistics::setEnabled(true);
+    QQmlBindingStatistics::reset();
+    const auto cleanup = qScopeGuard([] {
+        // Nothing is left to be written out at exit
+        QQmlBindingStatistics::reset();
+        QQmlBindingStatistics::setEnabled(false);
+    });
+
+    QQmlEngine e;
+    QQmlComponent c(&e, testFileUrl("bindingStatistics.qml"));
+    QVERIFY2(c.isReady(), qPrintable(c.errorString()));
+    std::unique_ptr<QObject> root { c.create() };
+    QVERIFY(root);
+
+    for (int i = 1; i <= 5; ++i)
+        root->setProperty("source", i);
+    QCOMPARE(root->property("hot").toInt(), 10);
+
+    const QList<QQmlBindingStatistics::Entry> entries = QQmlBindingStatistics::entries();
+    const auto entryAt = [&](quint16 line) -> QQmlBindingStatistics::Entry {
+        for (const QQmlBindingStatistics::Entry &entry : entries) {
+            if (entry.sourceFile == c.url().toString() && entry.line == line)
+                return entry;
+        }
+        return {};
+    };
+
+    // Evaluated on creation and once per change of source
+    const QQmlBindingStatistics::Entry hot = entryAt(5);
+    QCOMPARE(hot.evaluations, 6u);
+    QCOMPARE(hot.fanIn, 1);
+    QVERIFY(hot.totalTime >= hot.maximumTime);
+
+    const QQmlBindingStatistics::Entry cold = entryAt(6);
+    QVERIFY(cold.evaluations <= 1u);
+
+    QQmlBindingStatistics::reset();
+    QVERIFY(QQmlBindingStatistics::entries().isEmpty());
+}
+
 QTEST_MAIN(tst_qqmlbinding)
 
 #include "tst_qqmlbinding.moc"
@@ -0,0 +1,17 @@
+import QtQml
+import Qt.test 1.0
+
+QtObject {
+    property list<QtObject> items: [
+        Counting { objectName: "0" },
+        Counting { objectName: "1" },
+        Counting { objectName: "2" },
+        Counting { objectName: "3" }
+    ]
+    property string names: {
+        var result = "";
+        for (var i = 0; i < items.length; ++i)
+            result += items[i].objectName;
+        return result;
+    }
+}
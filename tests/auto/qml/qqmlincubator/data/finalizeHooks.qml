@@ -0,0 +1,7 @@
+import Qt.test 1.0
+
+FinalizerHook {
+    property variant a: FinalizerHook {}
+    property variant b: FinalizerHook {}
+    property variant c: FinalizerHook {}
+}
@@ -109,6 +109,39 @@ void CompletionCallbackType::registerCallback(callback c, void *d)
     m_data = d;
 }
 
+int FinalizerHookType::m_finalizedCount = 0;
+void FinalizerHookType::componentFinalized()
+{
+    ++m_finalizedCount;
+}
+
+int FinalizerHookType::finalizedCount()
+{
+    return m_finalizedCount;
+}
+
+void FinalizerHookType::clearFinalizedCount()
+{
+    m_finalizedCount = 0;
+}
+
+int CountingType::m_count = 0;
+CountingType::CountingType(QObject *parent)
+    : QObject(parent)
+{
+    ++m_count;
+}
+
+int CountingType::count()
+{
+    return m_count;
+}
+
+void CountingType::clearCount()
+{
+    m_count = 0;
+}
+
 void registerTypes()
 {
     qmlRegisterType<SelfRegisteringType>("Qt.test", 1,0, "SelfRegistering");
@@ -116,4 +149,6 @@ void registerTypes()
     qmlRegisterType<CompletionRegisteringType>("Qt.test", 1,0, "CompletionRegistering");
     qmlRegisterType<CallbackRegisteringType>("Qt.test", 1,0, "CallbackRegistering");
     qmlRegisterType<CompletionCallbackType>("Qt.test", 1,0, "CompletionCallback");
+    qmlRegisterType<FinalizerHookType>("Qt.test", 1,0, "FinalizerHook");
+    qmlRegisterType<CountingType>("Qt.test", 1,0, "Counting");
 }
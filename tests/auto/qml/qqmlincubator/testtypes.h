@@ -5,6 +5,7 @@
 
 #include <QtCore/qobject.h>
 #include <QQmlParserStatus>
+#include <QtQml/private/qqmlfinalizer_p.h>
 
 class SelfRegisteringType : public QObject
 {
@@ -103,6 +104,33 @@ private:
     static void *m_data;
 };
 
+class FinalizerHookType : public QObject, public QQmlFinalizerHook
+{
+    Q_OBJECT
+    Q_INTERFACES(QQmlFinalizerHook)
+public:
+    void componentFinalized() override;
+
+    static int finalizedCount();
+    static void clearFinalizedCount();
+
+private:
+    static int m_finalizedCount;
+};
+
+class CountingType : public QObject
+{
+    Q_OBJECT
+public:
+    CountingType(QObject *parent = nullptr);
+
+    static int count();
+    static void clearCount();
+
+private:
+    static int m_count;
+};
+
 void registerTypes();
 
 #endif // TESTTYPES_H
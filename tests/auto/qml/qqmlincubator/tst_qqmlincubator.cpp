@@ -13,6 +13,7 @@
 #include <QQmlProperty>
 #include <QQmlComponent>
 #include <QQmlIncubator>
+#include <QQmlListReference>
 #include <private/qjsvalue_p.h>
 #include <private/qqmlincubator_p.h>
 #include <private/qqmlobjectcreator_p.h>
@@ -34,6 +35,8 @@ private slots:
     void forceCompletion();
     void setInitialState();
     void clearDuringCompletion();
+    void finalizeHooksInterruptible();
+    void createInterruptible();
     void objectDeletionAfterInit();
     void recursiveClear();
     void statusChanged();
@@ -407,6 +410,75 @@ void tst_qqmlincubator::clearDuringCompletion()
     QVERIFY(srt.isNull());
 }
 
+void tst_qqmlincubator::finalizeHooksInterruptible()
+{
+    FinalizerHookType::clearFinalizedCount();
+
+    QQmlComponent component(&engine, testFileUrl("finalizeHooks.qml"));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    QQmlIncubator incubator;
+    component.create(incubator);
+    QCOMPARE(incubator.status(), QQmlIncubator::Loading);
+
+    // Every step may only run a single hook, so finalization has to be spread
+    // over as many steps as there are hooks.
+    QList<int> counts;
+    while (incubator.isLoading()) {
+        std::atomic<bool> b{false};
+        controller.incubateWhile(&b);
+        const int count = FinalizerHookType::finalizedCount();
+        if (counts.isEmpty() || counts.last() != count)
+            counts.append(count);
+    }
+
+    QVERIFY(incubator.isReady());
+    QCOMPARE(FinalizerHookType::finalizedCount(), 4);
+    QVERIFY(counts.contains(1));
+    QVERIFY(counts.contains(2));
+    QVERIFY(counts.contains(3));
+    delete incubator.object();
+}
+
+void tst_qqmlincubator::createInterruptible()
+{
+    CountingType::clearCount();
+
+    QQmlComponent component(&engine, testFileUrl("createInterruptible.qml"));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    QQmlIncubator incubator;
+    component.create(incubator);
+    QCOMPARE(incubator.status(), QQmlIncubator::Loading);
+
+    // The children of the root object are created one per step
+    QList<int> counts;
+    while (incubator.isLoading()) {
+        std::atomic<bool> b{false};
+        controller.incubateWhile(&b);
+        const int count = CountingType::count();
+        if (counts.isEmpty() || counts.last() != count)
+            counts.append(count);
+    }
+
+    QVERIFY(incubator.isReady());
+    QCOMPARE(counts, QList<int>({ 0, 1, 2, 3, 4 }));
+
+    // in the order of the document
+    std::unique_ptr<QObject> object(incubator.object());
+    QQmlListReference items(object.get(), "items");
+    QCOMPARE(items.count(), 4);
+    for (int i = 0; i < 4; ++i)
+        QCOMPARE(items.at(i)->objectName(), QString::number(i));
+    QCOMPARE(object->property("names").toString(), QStringLiteral("0123"));
+
+    // Without an incubator, everything is created at once
+    CountingType::clearCount();
+    std::unique_ptr<QObject> direct(component.create());
+    QVERIFY(direct);
+    QCOMPARE(CountingType::count(), 4);
+}
+
 void tst_qqmlincubator::objectDeletionAfterInit()
 {
     QQmlComponent component(&engine, testFileUrl("clear.qml"));
@@ -13,6 +13,7 @@
 
 #include <QtCore/qtimer.h>
 #include <QtCore/qdebug.h>
+#include <QtCore/qregularexpression.h>
 #include <QtCore/qtranslator.h>
 #include <QSignalSpy>
 
@@ -120,6 +121,8 @@ private slots:
     void objectOwnershipFlip();
     void enumsInListElement();
     void protectQObjectFromGC();
+    void appendArrayOfMixedShapes();
+    void appendColumns();
 };
 
 bool tst_qqmllistmodel::compareVariantList(const QVariantList &testList, QVariant object)
@@ -1906,6 +1909,86 @@ void tst_qqmllistmodel::protectQObjectFromGC()
     }
 }
 
+void tst_qqmllistmodel::appendArrayOfMixedShapes()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData(
+            R"(import QtQml.Models
+                   ListModel {
+                       Component.onCompleted: {
+                           let withGetter = { a: 5 };
+                           Object.defineProperty(withGetter, "b", { get: () => "got", enumerable: true });
+                           append([ { a: 1, b: "x" }, { a: 2, b: "y" }, { b: "z", a: 3 },
+                                    { a: 4 }, withGetter, { a: 6, b: "w", c: true } ]);
+                       }
+                   })",
+            QUrl());
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY2(root, qPrintable(component.errorString()));
+    auto lm = qobject_cast<QQmlListModel *>(root.get());
+    QVERIFY(lm);
+    QSignalSpy spy(lm, &QQmlListModel::rowsInserted);
+
+    QCOMPARE(lm->count(), 6);
+    const QStringList bs = { "x", "y", "z", QString(), "got", "w" };
+    for (int i = 0; i < 6; ++i) {
+        QJSValue row = lm->get(i);
+        QCOMPARE(row.property("a").toInt(), i + 1);
+        if (!bs.at(i).isNull())
+            QCOMPARE(row.property("b").toString(), bs.at(i));
+    }
+    QVERIFY(lm->get(5).property("c").toBool());
+
+    QQmlExpression expr(engine.rootContext(), lm,
+                        "insert(1, [ { a: 10, b: \"p\" }, { a: 11, b: \"q\" } ])");
+    expr.evaluate();
+    QVERIFY2(!expr.hasError(), qPrintable(expr.error().toString()));
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(lm->count(), 8);
+    QCOMPARE(lm->get(2).property("a").toInt(), 11);
+    QCOMPARE(lm->get(2).property("b").toString(), u"q"_s);
+}
+
+void tst_qqmllistmodel::appendColumns()
+{
+    QQmlEngine engine;
+    QQmlComponent component(&engine);
+    component.setData(
+            R"(import QtQml.Models
+                   ListModel {
+                       Component.onCompleted: append({ x: -1, y: -2, name: "first" })
+                   })",
+            QUrl());
+    QScopedPointer<QObject> root(component.create());
+    QVERIFY2(root, qPrintable(component.errorString()));
+    auto lm = qobject_cast<QQmlListModel *>(root.get());
+    QVERIFY(lm);
+    QSignalSpy spy(lm, &QQmlListModel::rowsInserted);
+
+    QQmlExpression expr(engine.rootContext(), lm,
+                        "appendColumns({ x: new Float64Array([0, 1, 2]), y: [4, 2, 0],"
+                        "                name: [\"a\", \"b\", \"c\"] })");
+    expr.evaluate();
+    QVERIFY2(!expr.hasError(), qPrintable(expr.error().toString()));
+    QCOMPARE(spy.size(), 1);
+    QCOMPARE(spy.at(0).at(1).toInt(), 1);
+    QCOMPARE(spy.at(0).at(2).toInt(), 3);
+    QCOMPARE(lm->count(), 4);
+    for (int i = 0; i < 3; ++i) {
+        QJSValue row = lm->get(i + 1);
+        QCOMPARE(row.property("x").toNumber(), double(i));
+        QCOMPARE(row.property("y").toNumber(), double(4 - 2 * i));
+        QCOMPARE(row.property("name").toString(), QString(QChar(u'a' + i)));
+    }
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression(".*appendColumns: columns differ in length"));
+    QQmlExpression mismatch(engine.rootContext(), lm, "appendColumns({ x: [1, 2], y: [1] })");
+    mismatch.evaluate();
+    QCOMPARE(lm->count(), 4);
+    QCOMPARE(spy.size(), 1);
+}
+
 QTEST_MAIN(tst_qqmllistmodel)
 
 #include "tst_qqmllistmodel.moc"
@@ -21,6 +21,7 @@ public:
 private slots:
     void properties();
     void propertiesDerived();
+    void propertiesDeeplyDerived();
     void revisionedProperties();
     void methods();
     void methodsDerived();
@@ -231,6 +232,41 @@ void tst_qqmlpropertycache::propertiesDerived()
     QCOMPARE(data->coreIndex(), metaObject->indexOfProperty("propertyD"));
 }
 
+void tst_qqmlpropertycache::propertiesDeeplyDerived()
+{
+    // Derive through enough levels of differently sized caches so that the
+    // string caches get linked, layered and flattened.
+    QQmlPropertyCache::ConstPtr cache
+            = QQmlPropertyCache::createStandalone(&BaseObject::staticMetaObject);
+    const int propertyA = BaseObject::staticMetaObject.indexOfProperty("propertyA");
+    int coreIndex = BaseObject::staticMetaObject.propertyCount();
+
+    for (int level = 0; level < 16; ++level) {
+        const int count = (level % 3) * 20 + 1;
+        QQmlPropertyCache::Ptr derived = cache->copyAndReserve(count + 1, 0, 0, 0);
+        for (int i = 0; i < count; ++i) {
+            derived->appendProperty(QStringLiteral("p%1_%2").arg(level).arg(i),
+                                    QQmlPropertyData::Flags(), coreIndex++,
+                                    QMetaType::fromType<int>(), QTypeRevision::zero(), -1);
+        }
+        derived->appendProperty(QStringLiteral("shadowed"), QQmlPropertyData::Flags(),
+                                coreIndex, QMetaType::fromType<int>(), QTypeRevision::zero(),
+                                -1);
+        cache = derived;
+
+        const QQmlPropertyData *data;
+        QVERIFY((data = cacheProperty(cache, "propertyA")));
+        QCOMPARE(data->coreIndex(), propertyA);
+        QVERIFY((data = cacheProperty(cache, "shadowed")));
+        QCOMPARE(data->coreIndex(), coreIndex++);
+
+        for (int l = 0; l <= level; ++l) {
+            const QString name = QStringLiteral("p%1_0").arg(l);
+            QVERIFY2(cache->property(name, nullptr, nullptr), qPrintable(name));
+        }
+    }
+}
+
 void tst_qqmlpropertycache::revisionedProperties()
 {
     // Check that if you create a QQmlPropertyCache from a QMetaObject together
@@ -0,0 +1,63 @@
+.import QtQuick.LocalStorage 2.0 as Sql
+
+function test() {
+    var db = Sql.LocalStorage.openDatabaseSync("QmlTestDB-batch", "", "Test database from Qt autotests", 1000000);
+    var r = "transaction_not_finished";
+
+    db.transaction(
+        function(tx) {
+            tx.executeSql('CREATE TABLE IF NOT EXISTS Log(n INTEGER, txt TEXT)');
+            var values = [];
+            for (var i = 0; i < 100; ++i)
+                values.push([ i, "#" + i ]);
+            var rs = tx.executeBatch('INSERT INTO Log VALUES(?, ?)', values);
+            if (rs.rowsAffected != 100)
+                r = "BATCH AFFECTED " + rs.rowsAffected + " ROWS";
+        }
+    );
+    if (r != "transaction_not_finished")
+        return r;
+
+    db.transaction(
+        function(tx) {
+            // The same statement again, with and without values, uses the cached statement
+            for (var i = 100; i < 110; ++i)
+                tx.executeSql('INSERT INTO Log VALUES(?, ?)', [ i, "#" + i ]);
+            tx.executeSql('UPDATE Log SET txt = ? WHERE n = ?', [ "first", 0 ]);
+            tx.executeSql('UPDATE Log SET txt = ? WHERE n = ?', [ "second", 1 ]);
+            var rs = tx.executeSql('SELECT * FROM Log ORDER BY n');
+            if (rs.rows.length != 110)
+                r = "SELECT RETURNED " + rs.rows.length + " ROWS";
+            else if (rs.rows.item(0).txt != "first" || rs.rows.item(1).txt != "second")
+                r = "UPDATE FAILED " + rs.rows.item(0).txt + " " + rs.rows.item(1).txt;
+            else if (rs.rows.item(109).txt != "#109")
+                r = "INSERT FAILED " + rs.rows.item(109).txt;
+            else
+                r = "passed";
+        }
+    );
+    if (r != "passed")
+        return r;
+
+    try {
+        db.transaction(
+            function(tx) {
+                tx.executeBatch('INSERT INTO Log VALUES(?, ?)', [ [ 200, "a" ], [ 201 ] ]);
+            }
+        );
+        return "BATCH WITH MISSING VALUE DID NOT FAIL";
+    } catch (err) {
+        if (err.code != SQLException.DATABASE_ERR)
+            return "WRONG ERROR CODE " + err.code;
+    }
+
+    db.readTransaction(
+        function(tx) {
+            var rs = tx.executeSql('SELECT * FROM Log WHERE n >= 200');
+            if (rs.rows.length != 0)
+                r = "FAILED BATCH WAS NOT ROLLED BACK";
+        }
+    );
+
+    return r;
+}
@@ -0,0 +1,48 @@
+.import QtQuick.LocalStorage 2.0 as Sql
+
+function test() {
+    var db = Sql.LocalStorage.openDatabaseSync("QmlTestDB-querymodel", "", "Test database from Qt autotests", 1000000);
+
+    db.transaction(
+        function(tx) {
+            tx.executeSql('CREATE TABLE IF NOT EXISTS Numbers(n INTEGER, txt TEXT)');
+            for (var i = 0; i < 1000; ++i)
+                tx.executeSql('INSERT INTO Numbers VALUES(?, ?)', [ i, "#" + i ]);
+        }
+    );
+
+    var model = db.queryModel("SELECT n, txt FROM Numbers WHERE n >= ? ORDER BY n", [ 100 ]);
+    if (model.count != 256)
+        return "FIRST PAGE HAS " + model.count + " ROWS";
+    if (model.get(0).n != 100 || model.get(0).txt != "#100")
+        return "WRONG FIRST ROW " + model.get(0).n + " " + model.get(0).txt;
+
+    var root = model.index(-1, 0);
+    while (model.canFetchMore(root))
+        model.fetchMore(root);
+    if (model.count != 900)
+        return "MODEL HAS " + model.count + " ROWS";
+    if (model.get(899).n != 999)
+        return "WRONG LAST ROW " + model.get(899).n;
+
+    try {
+        db.queryModel("DELETE FROM Numbers");
+        return "DELETE NOT REJECTED";
+    } catch (err) {
+        if (err.code != SQLException.SYNTAX_ERR)
+            return "WRONG ERROR CODE " + err.code;
+    }
+
+    var db2 = db.changeVersion("", "2");
+    try {
+        db.queryModel("SELECT n FROM Numbers");
+        return "STALE VERSION NOT REJECTED";
+    } catch (err) {
+        if (err.code != SQLException.VERSION_ERR)
+            return "WRONG VERSION ERROR CODE " + err.code;
+    }
+    if (db2.queryModel("SELECT n FROM Numbers").count != 256)
+        return "NEW VERSION NOT USABLE";
+
+    return "passed";
+}
@@ -94,7 +94,7 @@ void tst_qqmlsqldatabase::checkDatabasePath()
     QVERIFY(engine->offlineStoragePath().contains("OfflineStorage"));
 }
 
-static const int total_databases_created_by_tests = 13;
+static const int total_databases_created_by_tests = 15;
 void tst_qqmlsqldatabase::testQml_data()
 {
     QTest::addColumn<QString>("jsfile"); // The input file
@@ -117,6 +117,8 @@ void tst_qqmlsqldatabase::testQml_data()
     QTest::newRow("reopen1") << "reopen1.js";
     QTest::newRow("reopen2") << "reopen2.js"; // re-uses above DB
     QTest::newRow("null-values") << "nullvalues.js";
+    QTest::newRow("querymodel") << "querymodel.js";
+    QTest::newRow("batch") << "batch.js";
 
     // If you add a test, you should usually use a new database in the
     // test - in which case increment total_databases_created_by_tests above.
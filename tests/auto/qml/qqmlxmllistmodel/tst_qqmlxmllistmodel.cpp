@@ -49,6 +49,7 @@ private slots:
     void reload();
     void threading();
     void threading_data();
+    void progressiveDelivery();
     void propertyChanges();
     void nestedElements();
     void malformedData();
@@ -539,6 +540,48 @@ void tst_QQmlXmlListModel::threading_data()
     QTest::newRow("10") << 10;
 }
 
+void tst_QQmlXmlListModel::progressiveDelivery()
+{
+    // Large documents are delivered in several batches, which are appended
+    // to the model in document order while it is still loading.
+    const int dataCount = 1000;
+
+    QQmlComponent component(&engine, testFileUrl("threading.qml"));
+    QScopedPointer<QAbstractItemModel> model(
+            qobject_cast<QAbstractItemModel *>(component.create()));
+    QVERIFY(model != nullptr);
+
+    QString data;
+    for (int i = 0; i < dataCount; ++i)
+        data += "name=A" + QString::number(i) + ",age=" + QString::number(i) + ",sport=Football;";
+
+    QTemporaryDir tempDir;
+    ScopedFile file(tempDir.filePath("progressive.xml"), makeItemXmlAndData(data).toLatin1());
+    QVERIFY(file.isCreated());
+
+    QSignalSpy spyInsert(model.get(), SIGNAL(rowsInserted(QModelIndex,int,int)));
+    model->setProperty("source", QUrl::fromLocalFile(file.fileName()));
+
+    QTRY_COMPARE(qvariant_cast<QQmlXmlListModel::Status>(model->property("status")),
+                 QQmlXmlListModel::Ready);
+    QCOMPARE(model->rowCount(), dataCount);
+
+    QVERIFY(spyInsert.size() > 1);
+    int expectedFirst = 0;
+    for (const auto &args : spyInsert) {
+        QCOMPARE(args.at(1).toInt(), expectedFirst);
+        expectedFirst = args.at(2).toInt() + 1;
+    }
+    QCOMPARE(expectedFirst, dataCount);
+
+    QList<int> roles = model->roleNames().keys();
+    std::sort(roles.begin(), roles.end());
+    for (int i = 0; i < dataCount; ++i) {
+        QCOMPARE(model->data(model->index(i, 0), roles.at(0)).toString(),
+                 QLatin1Char('A') + QString::number(i));
+    }
+}
+
 void tst_QQmlXmlListModel::propertyChanges()
 {
     QQmlComponent component(&engine, testFileUrl("propertychanges.qml"));
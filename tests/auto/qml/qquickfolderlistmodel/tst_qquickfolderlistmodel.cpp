@@ -6,6 +6,7 @@
 #include <QtQml/qqmlcomponent.h>
 #include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
+#include <QtCore/qtemporarydir.h>
 #include <QtCore/qabstractitemmodel.h>
 #include <QDebug>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
@@ -51,6 +52,9 @@ private slots:
     void sortCaseSensitive();
     void updateProperties();
     void importBothVersions();
+    void incrementalUpdate();
+    void largeFolder();
+    void changeFolderWhileListing();
 private:
     QQmlEngine engine;
 
@@ -186,11 +190,17 @@ void tst_qquickfolderlistmodel::nameFilters()
     QTRY_COMPARE(flm->property("count").toInt(),3); // all files visible
 
     int count = flm->rowCount();
+    QCOMPARE(flm->data(flm->index(0),FileNameRole), QVariant("test.txt"));
+    QSignalSpy removeSpy(flm, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    QSignalSpy insertSpy(flm, SIGNAL(rowsInserted(QModelIndex,int,int)));
     flm->setProperty("nameFilters", QStringList() << "*.txt");
     // _q_directoryUpdated triggered with range 0:1
     QTRY_COMPARE(flm->property("count").toInt(),1);
     QCOMPARE(flm->data(flm->index(0),FileNameRole), QVariant("test.txt"));
-    QCOMPARE(removeStart, 0);
+    // only the two html files after test.txt are removed, as one range
+    QCOMPARE(removeSpy.size(), 1);
+    QCOMPARE(insertSpy.size(), 0);
+    QCOMPARE(removeStart, 1);
     QCOMPARE(removeEnd, count-1);
 
     flm->setProperty("nameFilters", QStringList() << "*.html");
@@ -450,6 +460,123 @@ void tst_qquickfolderlistmodel::importBothVersions()
     }
 }
 
+static bool createFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write("test") == 4;
+}
+
+void tst_qquickfolderlistmodel::incrementalUpdate()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(createFile(tempDir.filePath("a.txt")));
+    QVERIFY(createFile(tempDir.filePath("c.txt")));
+
+    QQmlComponent component(&engine, testFileUrl("resetFiltering.qml"));
+    QTRY_VERIFY2(component.isReady(), qPrintable(component.errorString()));
+    QScopedPointer<QAbstractListModel> flm(qobject_cast<QAbstractListModel*>(component.create()));
+    QVERIFY(flm);
+
+    flm->setProperty("folder", QUrl::fromLocalFile(tempDir.path()));
+    QTRY_COMPARE(flm->property("count").toInt(), 2);
+    QTRY_COMPARE(flm->property("status").toInt(), int(Ready));
+
+    QSignalSpy insertSpy(flm.get(), SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy removeSpy(flm.get(), SIGNAL(rowsRemoved(QModelIndex,int,int)));
+
+    // A new file only inserts its own row
+    QVERIFY(createFile(tempDir.filePath("b.txt")));
+    QTRY_COMPARE(flm->property("count").toInt(), 3);
+    QCOMPARE(removeSpy.size(), 0);
+    QCOMPARE(insertSpy.size(), 1);
+    QCOMPARE(insertSpy.at(0).at(1).toInt(), 1);
+    QCOMPARE(insertSpy.at(0).at(2).toInt(), 1);
+    QCOMPARE(flm->data(flm->index(1), FileNameRole), QVariant("b.txt"));
+
+    // A removed file only removes its own row
+    insertSpy.clear();
+    QVERIFY(QFile::remove(tempDir.filePath("a.txt")));
+    QTRY_COMPARE(flm->property("count").toInt(), 2);
+    QCOMPARE(insertSpy.size(), 0);
+    QCOMPARE(removeSpy.size(), 1);
+    QCOMPARE(removeSpy.at(0).at(1).toInt(), 0);
+    QCOMPARE(removeSpy.at(0).at(2).toInt(), 0);
+    QCOMPARE(flm->data(flm->index(0), FileNameRole), QVariant("b.txt"));
+}
+
+void tst_qquickfolderlistmodel::largeFolder()
+{
+    // Big folders are delivered in more than one batch
+    const int fileCount = 1000;
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    for (int i = 0; i < fileCount; ++i)
+        QVERIFY(createFile(tempDir.filePath(QString::asprintf("file%04d.txt", i))));
+
+    QQmlComponent component(&engine, testFileUrl("resetFiltering.qml"));
+    QTRY_VERIFY2(component.isReady(), qPrintable(component.errorString()));
+    QScopedPointer<QAbstractListModel> flm(qobject_cast<QAbstractListModel*>(component.create()));
+    QVERIFY(flm);
+
+    QSignalSpy insertSpy(flm.get(), SIGNAL(rowsInserted(QModelIndex,int,int)));
+    flm->setProperty("folder", QUrl::fromLocalFile(tempDir.path()));
+    QTRY_COMPARE(flm->property("count").toInt(), fileCount);
+    // The first rows come with the model reset, the rest in growing batches
+    QVERIFY2(insertSpy.size() > 1, "the folder was not delivered in batches");
+    int inserted = insertSpy.first().at(1).toInt();
+    QVERIFY(inserted > 0);
+    for (const QList<QVariant> &args : std::as_const(insertSpy)) {
+        QCOMPARE(args.at(1).toInt(), inserted);
+        inserted = args.at(2).toInt() + 1;
+    }
+    QCOMPARE(inserted, fileCount);
+    for (int i = 0; i < fileCount; ++i) {
+        QCOMPARE(flm->data(flm->index(i), FileNameRole),
+                 QVariant(QString::asprintf("file%04d.txt", i)));
+    }
+}
+
+void tst_qquickfolderlistmodel::changeFolderWhileListing()
+{
+    // Batches still on their way from the previous folder are dropped
+    const int fileCount = 5000;
+    QTemporaryDir largeDir;
+    QVERIFY(largeDir.isValid());
+    for (int i = 0; i < fileCount; ++i)
+        QVERIFY(createFile(largeDir.filePath(QString::asprintf("file%04d.txt", i))));
+    QTemporaryDir smallDir;
+    QVERIFY(smallDir.isValid());
+    QVERIFY(createFile(smallDir.filePath("a.txt")));
+    QVERIFY(createFile(smallDir.filePath("b.txt")));
+
+    QQmlComponent component(&engine, testFileUrl("resetFiltering.qml"));
+    QTRY_VERIFY2(component.isReady(), qPrintable(component.errorString()));
+    QScopedPointer<QAbstractListModel> flm(qobject_cast<QAbstractListModel*>(component.create()));
+    QVERIFY(flm);
+
+    bool resetting = false;
+    int insertedWhileResetting = 0;
+    connect(flm.get(), &QAbstractItemModel::modelAboutToBeReset, this, [&]() { resetting = true; });
+    connect(flm.get(), &QAbstractItemModel::modelReset, this, [&]() { resetting = false; });
+    connect(flm.get(), &QAbstractItemModel::rowsInserted, this, [&]() {
+        if (resetting)
+            ++insertedWhileResetting;
+    });
+
+    for (int i = 0; i < 3; ++i) {
+        flm->setProperty("folder", QUrl::fromLocalFile(largeDir.path()));
+        QTRY_VERIFY(flm->property("count").toInt() > 0);
+        flm->setProperty("folder", QUrl::fromLocalFile(smallDir.path()));
+        QTRY_COMPARE(flm->property("count").toInt(), 2);
+    }
+    QTest::qWait(100);
+    QCOMPARE(flm->property("count").toInt(), 2);
+    QCOMPARE(flm->data(flm->index(0), FileNameRole), QVariant("a.txt"));
+    QCOMPARE(flm->data(flm->index(1), FileNameRole), QVariant("b.txt"));
+    QCOMPARE(insertedWhileResetting, 0);
+}
+
 QTEST_MAIN(tst_qquickfolderlistmodel)
 
 #include "tst_qquickfolderlistmodel.moc"
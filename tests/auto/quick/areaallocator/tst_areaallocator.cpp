@@ -0,0 +1,219 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtTest/QtTest>
+#include <QtCore/QRandomGenerator>
+
+#include <QtQuick/private/qsgareaallocator_p.h>
+
+class AreaAllocatorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void fill_data();
+    void fill();
+    void freeAll_data();
+    void freeAll();
+    void noOverlap_data();
+    void noOverlap();
+    void skylineMergesFreeSpace();
+    void skylineLowers();
+
+private:
+    void strategyData();
+};
+
+void AreaAllocatorTest::strategyData()
+{
+    QTest::addColumn<QSGAreaAllocator::Strategy>("strategy");
+
+    QTest::newRow("binary tree") << QSGAreaAllocator::BinaryTree;
+    QTest::newRow("skyline") << QSGAreaAllocator::Skyline;
+}
+
+static bool overlaps(const QList<QRect> &rects)
+{
+    for (int i = 0; i < rects.size(); ++i) {
+        for (int j = i + 1; j < rects.size(); ++j) {
+            if (rects.at(i).intersects(rects.at(j)))
+                return true;
+        }
+    }
+    return false;
+}
+
+void AreaAllocatorTest::fill_data()
+{
+    strategyData();
+}
+
+void AreaAllocatorTest::fill()
+{
+    QFETCH(QSGAreaAllocator::Strategy, strategy);
+
+    QSGAreaAllocator allocator(QSize(256, 256), strategy);
+    QCOMPARE(allocator.strategy(), strategy);
+    QCOMPARE(allocator.allocationCount(), 0);
+    QCOMPARE(allocator.usedArea(), qint64(0));
+    QCOMPARE(allocator.fragmentation(), qreal(0));
+
+    QList<QRect> rects;
+    for (int i = 0; i < 16; ++i) {
+        const QRect rect = allocator.allocate(QSize(64, 64));
+        QCOMPARE(rect.size(), QSize(64, 64));
+        QVERIFY(QRect(0, 0, 256, 256).contains(rect));
+        rects << rect;
+    }
+    QVERIFY(!overlaps(rects));
+    QCOMPARE(allocator.allocationCount(), 16);
+    QCOMPARE(allocator.usedArea(), qint64(256 * 256));
+
+    // Full
+    QVERIFY(allocator.allocate(QSize(1, 1)).isNull());
+    QCOMPARE(allocator.allocationCount(), 16);
+    QCOMPARE(allocator.fragmentation(), qreal(0));
+
+    // Too large to ever fit
+    QSGAreaAllocator empty(QSize(256, 256), strategy);
+    QVERIFY(empty.allocate(QSize(257, 1)).isNull());
+    QVERIFY(empty.allocate(QSize(1, 257)).isNull());
+    QCOMPARE(empty.allocationCount(), 0);
+}
+
+void AreaAllocatorTest::freeAll_data()
+{
+    strategyData();
+}
+
+void AreaAllocatorTest::freeAll()
+{
+    QFETCH(QSGAreaAllocator::Strategy, strategy);
+
+    QSGAreaAllocator allocator(QSize(256, 256), strategy);
+    QList<QRect> rects;
+    for (int i = 0; i < 16; ++i)
+        rects << allocator.allocate(QSize(64, 64));
+
+    // Every other one leaves the free space scattered
+    for (int i = 0; i < rects.size(); i += 2)
+        QVERIFY(allocator.deallocate(rects.at(i)));
+    QCOMPARE(allocator.allocationCount(), 8);
+    QCOMPARE(allocator.usedArea(), qint64(8 * 64 * 64));
+    QVERIFY(allocator.fragmentation() > 0);
+
+    // Freeing twice is refused
+    QVERIFY(!allocator.deallocate(rects.at(0)));
+    QCOMPARE(allocator.allocationCount(), 8);
+
+    for (int i = 1; i < rects.size(); i += 2)
+        QVERIFY(allocator.deallocate(rects.at(i)));
+    QCOMPARE(allocator.allocationCount(), 0);
+    QCOMPARE(allocator.usedArea(), qint64(0));
+    QCOMPARE(allocator.fragmentation(), qreal(0));
+
+    // All the space is in one piece again
+    QCOMPARE(allocator.allocate(QSize(256, 256)), QRect(0, 0, 256, 256));
+}
+
+void AreaAllocatorTest::noOverlap_data()
+{
+    strategyData();
+}
+
+void AreaAllocatorTest::noOverlap()
+{
+    QFETCH(QSGAreaAllocator::Strategy, strategy);
+
+    const QRect bounds(0, 0, 512, 512);
+    QSGAreaAllocator allocator(bounds.size(), strategy);
+    QRandomGenerator random(42);
+    QList<QRect> rects;
+    qint64 usedArea = 0;
+
+    auto allocateUntilFull = [&] {
+        for (int misses = 0; misses < 20;) {
+            const QSize size(random.bounded(1, 80), random.bounded(1, 80));
+            const QRect rect = allocator.allocate(size);
+            if (rect.isNull()) {
+                ++misses;
+                continue;
+            }
+            QCOMPARE(rect.size(), size);
+            QVERIFY2(bounds.contains(rect), qPrintable(QDebug::toString(rect)));
+            rects << rect;
+            usedArea += qint64(size.width()) * size.height();
+        }
+    };
+
+    for (int round = 0; round < 4; ++round) {
+        allocateUntilFull();
+        if (QTest::currentTestFailed())
+            return;
+        QVERIFY(!overlaps(rects));
+        QCOMPARE(allocator.allocationCount(), int(rects.size()));
+        QCOMPARE(allocator.usedArea(), usedArea);
+        QVERIFY(allocator.fragmentation() >= 0 && allocator.fragmentation() <= 1);
+
+        // Free a random half, then fill the gaps again
+        for (int i = rects.size() / 2; i > 0; --i) {
+            const QRect rect = rects.takeAt(random.bounded(int(rects.size())));
+            QVERIFY(allocator.deallocate(rect));
+            usedArea -= qint64(rect.width()) * rect.height();
+        }
+        QCOMPARE(allocator.allocationCount(), int(rects.size()));
+        QCOMPARE(allocator.usedArea(), usedArea);
+    }
+}
+
+void AreaAllocatorTest::skylineMergesFreeSpace()
+{
+    QSGAreaAllocator allocator(QSize(256, 256), QSGAreaAllocator::Skyline);
+    const QRect a = allocator.allocate(QSize(128, 128));
+    const QRect b = allocator.allocate(QSize(128, 128));
+    QCOMPARE(a, QRect(0, 0, 128, 128));
+    QCOMPARE(b, QRect(128, 0, 128, 128));
+    QCOMPARE(allocator.allocate(QSize(256, 128)), QRect(0, 128, 256, 128));
+
+    // The two freed halves below the skyline make up one piece
+    QVERIFY(allocator.deallocate(a));
+    QVERIFY(allocator.deallocate(b));
+    QCOMPARE(allocator.fragmentation(), qreal(0));
+    QCOMPARE(allocator.allocate(QSize(256, 128)), QRect(0, 0, 256, 128));
+    QCOMPARE(allocator.allocationCount(), 2);
+}
+
+void AreaAllocatorTest::skylineLowers()
+{
+    QSGAreaAllocator allocator(QSize(256, 256), QSGAreaAllocator::Skyline);
+    const QRect a = allocator.allocate(QSize(128, 64));
+    const QRect b = allocator.allocate(QSize(128, 256));
+    const QRect c = allocator.allocate(QSize(128, 64));
+    QCOMPARE(a, QRect(0, 0, 128, 64));
+    QCOMPARE(b, QRect(128, 0, 128, 256));
+    QCOMPARE(c, QRect(0, 64, 128, 64));
+
+    // Below c, a leaves a hole that the area above c cannot join yet
+    QVERIFY(allocator.deallocate(a));
+    QVERIFY(allocator.fragmentation() > 0);
+    QVERIFY(allocator.allocate(QSize(128, 192)).isNull());
+
+    // With c gone, the skyline drops down through both
+    QVERIFY(allocator.deallocate(c));
+    QCOMPARE(allocator.allocationCount(), 1);
+    QCOMPARE(allocator.fragmentation(), qreal(0));
+    QCOMPARE(allocator.allocate(QSize(128, 256)), QRect(0, 0, 128, 256));
+
+    // Freeing the topmost allocation lowers the skyline right away
+    QSGAreaAllocator other(QSize(256, 256), QSGAreaAllocator::Skyline);
+    QCOMPARE(other.allocate(QSize(256, 100)), QRect(0, 0, 256, 100));
+    const QRect top = other.allocate(QSize(100, 100));
+    QCOMPARE(top, QRect(0, 100, 100, 100));
+    QCOMPARE(other.allocate(QSize(10, 10)), QRect(100, 100, 10, 10));
+    QVERIFY(other.deallocate(top));
+    QCOMPARE(other.allocate(QSize(100, 156)), QRect(0, 100, 100, 156));
+}
+
+QTEST_MAIN(AreaAllocatorTest)
+
+#include "tst_areaallocator.moc"
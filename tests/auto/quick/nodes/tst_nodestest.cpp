@@ -12,7 +12,10 @@
 
 #include <QtQuick/qsgsimplerectnode.h>
 #include <QtQuick/qsgsimpletexturenode.h>
+#include <QtQuick/qsgflatcolormaterial.h>
+#include <QtQuick/qsgvertexcolormaterial.h>
 #include <QtQuick/private/qsgplaintexture_p.h>
+#include <QtQuick/private/qsgrhiatlastexture_p.h>
 
 #include <QtGui/private/qguiapplication_p.h>
 #include <QtGui/qpa/qplatformintegration.h>
@@ -76,6 +79,18 @@ private Q_SLOTS:
     void textureNodeRect_data();
     void textureNodeRect();
 
+    void partialUpdate_data();
+    void partialUpdate();
+    void parallelUpload_data();
+    void parallelUpload();
+    void partialBatchUpload_data();
+    void partialBatchUpload();
+    void instancedBatch_data();
+    void instancedBatch();
+
+    void atlasRetirement_data();
+    void atlasRetirement();
+
 private:
     void rhiTestData();
 
@@ -484,6 +499,565 @@ void NodesTest::textureNodeRect()
     renderContext->invalidate();
 }
 
+static QImage readBackTexture(QRhi *rhi, QRhiTexture *texture)
+{
+    QImage image;
+    QRhiCommandBuffer *cb = nullptr;
+    if (rhi->beginOffscreenFrame(&cb) != QRhi::FrameOpSuccess)
+        return image;
+    QRhiReadbackResult result;
+    QRhiResourceUpdateBatch *resourceUpdates = rhi->nextResourceUpdateBatch();
+    resourceUpdates->readBackTexture({ texture }, &result);
+    cb->resourceUpdate(resourceUpdates);
+    rhi->endOffscreenFrame();
+    image = QImage(reinterpret_cast<const uchar *>(result.data.constData()),
+                   result.pixelSize.width(), result.pixelSize.height(),
+                   QImage::Format_RGBA8888_Premultiplied).copy();
+    if (rhi->isYUpInFramebuffer())
+        image = image.mirrored();
+    return image;
+}
+
+void NodesTest::partialUpdate_data()
+{
+    rhiTestData();
+}
+
+void NodesTest::partialUpdate()
+{
+    INIT_RHI();
+
+    const QSize size(200, 200);
+    QScopedPointer<QRhiTexture> texture(rhi->newTexture(QRhiTexture::RGBA8, size, 1,
+                                                        QRhiTexture::RenderTarget | QRhiTexture::UsedAsTransferSource));
+    QVERIFY(texture->create());
+    QScopedPointer<QRhiTextureRenderTarget> rt(rhi->newTextureRenderTarget({ texture.data() },
+                                                                           QRhiTextureRenderTarget::PreserveColorContents));
+    QScopedPointer<QRhiRenderPassDescriptor> rpDesc(rt->newCompatibleRenderPassDescriptor());
+    rt->setRenderPassDescriptor(rpDesc.data());
+    QVERIFY(rt->create());
+
+    QSGRootNode root;
+    QSGSimpleRectNode *a = new QSGSimpleRectNode(QRectF(10, 10, 20, 20), Qt::red);
+    QSGOpacityNode *bOpacity = new QSGOpacityNode;
+    QSGSimpleRectNode *b = new QSGSimpleRectNode(QRectF(100, 100, 50, 50), Qt::blue);
+    bOpacity->appendChildNode(b);
+    root.appendChildNode(a);
+    root.appendChildNode(bOpacity);
+
+    QSGBatchRenderer::Renderer renderer(renderContext);
+    renderer.setRootNode(&root);
+    renderer.setPartialUpdateEnabled(true);
+    renderer.setClearColor(Qt::white);
+    renderer.setDeviceRect(QRect(QPoint(0, 0), size));
+    renderer.setViewportRect(QRect(QPoint(0, 0), size));
+    QSGAbstractRenderer::MatrixTransformFlags matrixFlags;
+    if (!rhi->isYUpInNDC())
+        matrixFlags |= QSGAbstractRenderer::MatrixTransformFlipY;
+    renderer.setProjectionMatrixToRect(QRectF(QPointF(0, 0), size), matrixFlags, !rhi->isYUpInNDC());
+
+    auto renderFrame = [&] {
+        QRhiCommandBuffer *cb = nullptr;
+        if (rhi->beginOffscreenFrame(&cb) != QRhi::FrameOpSuccess)
+            return false;
+        renderer.setRenderTarget(QSGRenderTarget(rt.data(), rpDesc.data(), cb));
+        renderer.renderScene();
+        rhi->endOffscreenFrame();
+        return true;
+    };
+
+    // The Null backend does not render anything, only the damage can be checked there
+    const bool canReadBack = rhi->backend() != QRhi::Null;
+    auto readBack = [&] {
+        return readBackTexture(rhi.data(), texture.data());
+    };
+    auto pixelColor = [](const QImage &image, int x, int y) {
+        return QColor(image.pixel(x, y));
+    };
+
+    // The first frame has nothing to build on
+    QVERIFY(renderFrame());
+    QCOMPARE(renderer.damageRect(), QRect(QPoint(0, 0), size));
+    if (canReadBack) {
+        const QImage image = readBack();
+        QCOMPARE(image.size(), size);
+        QCOMPARE(pixelColor(image, 20, 20), QColor(Qt::red));
+        QCOMPARE(pixelColor(image, 125, 125), QColor(Qt::blue));
+        QCOMPARE(pixelColor(image, 75, 75), QColor(Qt::white));
+    }
+
+    QVERIFY(renderFrame());
+    QVERIFY(renderer.damageRect().isEmpty());
+
+    b->setColor(Qt::green);
+    QVERIFY(renderFrame());
+    QVERIFY(renderer.damageRect().contains(QRect(100, 100, 50, 50)));
+    QVERIFY(!renderer.damageRect().intersects(QRect(10, 10, 20, 20)));
+    if (canReadBack) {
+        const QImage image = readBack();
+        QCOMPARE(pixelColor(image, 20, 20), QColor(Qt::red));
+        QCOMPARE(pixelColor(image, 125, 125), QColor(Qt::green));
+    }
+
+    // Both where the node was and where it is now
+    a->setRect(40, 10, 20, 20);
+    QVERIFY(renderFrame());
+    QVERIFY(renderer.damageRect().contains(QRect(10, 10, 50, 20)));
+    QVERIFY(!renderer.damageRect().intersects(QRect(100, 100, 50, 50)));
+    if (canReadBack) {
+        const QImage image = readBack();
+        QCOMPARE(pixelColor(image, 20, 20), QColor(Qt::white));
+        QCOMPARE(pixelColor(image, 50, 20), QColor(Qt::red));
+        QCOMPARE(pixelColor(image, 125, 125), QColor(Qt::green));
+    }
+
+    // A subtree that becomes blocked is no longer drawn, so where it was
+    // must be cleared.
+    bOpacity->setOpacity(0);
+    QVERIFY(renderFrame());
+    QVERIFY(renderer.damageRect().contains(QRect(100, 100, 50, 50)));
+    if (canReadBack) {
+        const QImage image = readBack();
+        QCOMPARE(pixelColor(image, 50, 20), QColor(Qt::red));
+        QCOMPARE(pixelColor(image, 125, 125), QColor(Qt::white));
+    }
+
+    bOpacity->setOpacity(1);
+    QVERIFY(renderFrame());
+    QVERIFY(renderer.damageRect().contains(QRect(100, 100, 50, 50)));
+    if (canReadBack)
+        QCOMPARE(pixelColor(readBack(), 125, 125), QColor(Qt::green));
+
+    root.removeChildNode(bOpacity);
+    delete bOpacity;
+    QVERIFY(renderFrame());
+    QVERIFY(renderer.damageRect().contains(QRect(100, 100, 50, 50)));
+    QVERIFY(!renderer.damageRect().intersects(QRect(40, 10, 20, 20)));
+    if (canReadBack) {
+        const QImage image = readBack();
+        QCOMPARE(pixelColor(image, 50, 20), QColor(Qt::red));
+        QCOMPARE(pixelColor(image, 125, 125), QColor(Qt::white));
+    }
+
+    // Without partial updates everything is redrawn every time
+    renderer.setPartialUpdateEnabled(false);
+    a->setColor(Qt::yellow);
+    QVERIFY(renderFrame());
+    QCOMPARE(renderer.damageRect(), QRect(QPoint(0, 0), size));
+    if (canReadBack)
+        QCOMPARE(pixelColor(readBack(), 50, 20), QColor(Qt::yellow));
+
+    renderContext->invalidate();
+}
+
+void NodesTest::parallelUpload_data()
+{
+    rhiTestData();
+}
+
+void NodesTest::parallelUpload()
+{
+    INIT_RHI();
+
+    const QSize size(256, 256);
+    QScopedPointer<QRhiTexture> texture(rhi->newTexture(QRhiTexture::RGBA8, size, 1,
+                                                        QRhiTexture::RenderTarget | QRhiTexture::UsedAsTransferSource));
+    QVERIFY(texture->create());
+    QScopedPointer<QRhiTextureRenderTarget> rt(rhi->newTextureRenderTarget({ texture.data() }));
+    QScopedPointer<QRhiRenderPassDescriptor> rpDesc(rt->newCompatibleRenderPassDescriptor());
+    rt->setRenderPassDescriptor(rpDesc.data());
+    QVERIFY(rt->create());
+
+    // The Null backend does not render anything, only that frames succeed
+    // can be checked there
+    const bool canReadBack = rhi->backend() != QRhi::Null;
+
+    // Renders the same animated scene with the given number of upload
+    // threads, and returns the image of every frame
+    auto renderScene = [&](int uploadThreadCount, QList<QImage> *images) {
+        QSGRootNode root;
+        QSGBatchRenderer::Renderer renderer(renderContext);
+        renderer.setRootNode(&root);
+        renderer.setUploadThreadCount(uploadThreadCount);
+        QCOMPARE(renderer.uploadThreadCount(), uploadThreadCount);
+        renderer.setClearColor(Qt::white);
+        renderer.setDeviceRect(QRect(QPoint(0, 0), size));
+        renderer.setViewportRect(QRect(QPoint(0, 0), size));
+        QSGAbstractRenderer::MatrixTransformFlags matrixFlags;
+        if (!rhi->isYUpInNDC())
+            matrixFlags |= QSGAbstractRenderer::MatrixTransformFlipY;
+        renderer.setProjectionMatrixToRect(QRectF(QPointF(0, 0), size), matrixFlags, !rhi->isYUpInNDC());
+
+        // Transform nodes with many children become batch roots when they move,
+        // giving several opaque and alpha batches that are uploaded together
+        QList<QSGTransformNode *> transforms;
+        QList<QSGSimpleRectNode *> rects;
+        for (int t = 0; t < 8; ++t) {
+            QSGTransformNode *transform = new QSGTransformNode;
+            root.appendChildNode(transform);
+            transforms << transform;
+            for (int i = 0; i < 300; ++i) {
+                const QColor color = i % 2 ? QColor(255, 0, 0) : QColor(0, 0, 255, 128);
+                QSGSimpleRectNode *rect = new QSGSimpleRectNode(QRectF(i % 20 * 10, i / 20 * 10, 8, 8), color);
+                transform->appendChildNode(rect);
+                rects << rect;
+            }
+        }
+
+        auto renderFrame = [&] {
+            QRhiCommandBuffer *cb = nullptr;
+            if (rhi->beginOffscreenFrame(&cb) != QRhi::FrameOpSuccess)
+                return false;
+            renderer.setRenderTarget(QSGRenderTarget(rt.data(), rpDesc.data(), cb));
+            renderer.renderScene();
+            rhi->endOffscreenFrame();
+            if (canReadBack)
+                images->append(readBackTexture(rhi.data(), texture.data()));
+            return true;
+        };
+
+        QVERIFY(renderFrame());
+        for (int frame = 1; frame < 4; ++frame) {
+            for (int t = 0; t < transforms.size(); ++t) {
+                QMatrix4x4 m;
+                m.translate(frame * 2, t * 4);
+                transforms.at(t)->setMatrix(m);
+            }
+            for (int i = frame; i < rects.size(); i += 7)
+                rects.at(i)->setRect(rects.at(i)->rect().translated(1, 0));
+            QVERIFY(renderFrame());
+        }
+    };
+
+    QList<QImage> serial;
+    renderScene(1, &serial);
+    if (QTest::currentTestFailed())
+        return;
+    QList<QImage> parallel;
+    renderScene(4, &parallel);
+    if (QTest::currentTestFailed())
+        return;
+
+    // Uploading on several threads renders exactly what one thread does
+    QCOMPARE(parallel.size(), serial.size());
+    for (qsizetype frame = 0; frame < serial.size(); ++frame) {
+        QCOMPARE(serial.at(frame).size(), size);
+        QImage blank(size, serial.at(frame).format());
+        blank.fill(Qt::white);
+        QVERIFY(serial.at(frame) != blank);
+        QCOMPARE(parallel.at(frame), serial.at(frame));
+    }
+
+    renderContext->invalidate();
+}
+
+void NodesTest::partialBatchUpload_data()
+{
+    rhiTestData();
+}
+
+static void setQuad(QSGGeometryNode *node, const QRectF &rect)
+{
+    QSGGeometry *g = node->geometry();
+    if (g->vertexCount() != 4 || g->indexCount() != 6)
+        g->allocate(4, 6);
+    QSGGeometry::updateRectGeometry(g, rect);
+    quint16 *indices = g->indexDataAsUShort();
+    const quint16 quad[] = { 0, 1, 2, 2, 1, 3 };
+    std::copy(quad, quad + 6, indices);
+    node->markDirty(QSGNode::DirtyGeometry);
+}
+
+void NodesTest::partialBatchUpload()
+{
+    INIT_RHI();
+
+    const QSize size(200, 200);
+    QScopedPointer<QRhiTexture> texture(rhi->newTexture(QRhiTexture::RGBA8, size, 1, QRhiTexture::RenderTarget));
+    QVERIFY(texture->create());
+    QScopedPointer<QRhiTextureRenderTarget> rt(rhi->newTextureRenderTarget({ texture.data() }));
+    QScopedPointer<QRhiRenderPassDescriptor> rpDesc(rt->newCompatibleRenderPassDescriptor());
+    rt->setRenderPassDescriptor(rpDesc.data());
+    QVERIFY(rt->create());
+
+    // Opaque, indexed quads sharing a material end up in one merged batch
+    QSGRootNode root;
+    QSGFlatColorMaterial material;
+    material.setColor(Qt::red);
+    QList<QSGGeometryNode *> nodes;
+    for (int i = 0; i < 16; ++i) {
+        QSGGeometryNode *node = new QSGGeometryNode;
+        QSGGeometry *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 4, 6);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(&material);
+        setQuad(node, QRectF(i * 10, i * 10, 8, 8));
+        root.appendChildNode(node);
+        nodes << node;
+    }
+
+    QSGBatchRenderer::Renderer renderer(renderContext);
+    renderer.setRootNode(&root);
+    renderer.setDeviceRect(QRect(QPoint(0, 0), size));
+    renderer.setViewportRect(QRect(QPoint(0, 0), size));
+    QSGAbstractRenderer::MatrixTransformFlags matrixFlags;
+    if (!rhi->isYUpInNDC())
+        matrixFlags |= QSGAbstractRenderer::MatrixTransformFlipY;
+    renderer.setProjectionMatrixToRect(QRectF(QPointF(0, 0), size), matrixFlags, !rhi->isYUpInNDC());
+
+    auto renderFrame = [&] {
+        QRhiCommandBuffer *cb = nullptr;
+        if (rhi->beginOffscreenFrame(&cb) != QRhi::FrameOpSuccess)
+            return false;
+        renderer.setRenderTarget(QSGRenderTarget(rt.data(), rpDesc.data(), cb));
+        renderer.renderScene();
+        rhi->endOffscreenFrame();
+        return true;
+    };
+
+    QVERIFY(renderFrame());
+    const quint64 fullUpload = renderer.uploadedBytes();
+    QVERIFY(fullUpload > 0);
+    QCOMPARE(renderer.partiallyUploadedBytes(), quint64(0));
+
+    QVERIFY(renderFrame());
+    QCOMPARE(renderer.uploadedBytes(), quint64(0));
+
+    // Same sized change, only that element is uploaded
+    setQuad(nodes.at(3), QRectF(35, 30, 8, 8));
+    QVERIFY(renderFrame());
+    QVERIFY(renderer.partiallyUploadedBytes() > 0);
+    QCOMPARE(renderer.uploadedBytes(), renderer.partiallyUploadedBytes());
+    QVERIFY(renderer.uploadedBytes() < fullUpload);
+
+    // Shrinking keeps the element where it is
+    QSGGeometry *g = nodes.at(5)->geometry();
+    g->allocate(3, 3);
+    g->vertexDataAsPoint2D()[0].set(50, 50);
+    g->vertexDataAsPoint2D()[1].set(58, 50);
+    g->vertexDataAsPoint2D()[2].set(50, 58);
+    quint16 *indices = g->indexDataAsUShort();
+    indices[0] = 0;
+    indices[1] = 1;
+    indices[2] = 2;
+    nodes.at(5)->markDirty(QSGNode::DirtyGeometry);
+    QVERIFY(renderFrame());
+    QVERIFY(renderer.partiallyUploadedBytes() > 0);
+    QCOMPARE(renderer.uploadedBytes(), renderer.partiallyUploadedBytes());
+
+    // Growing beyond the reserved range needs the whole batch again
+    g->allocate(8, 12);
+    QSGGeometry::Point2D *vertices = g->vertexDataAsPoint2D();
+    indices = g->indexDataAsUShort();
+    for (int quad = 0; quad < 2; ++quad) {
+        const float x = 50 + quad * 10;
+        vertices[quad * 4 + 0].set(x, 50);
+        vertices[quad * 4 + 1].set(x + 8, 50);
+        vertices[quad * 4 + 2].set(x, 58);
+        vertices[quad * 4 + 3].set(x + 8, 58);
+        const quint16 quadIndices[] = { 0, 1, 2, 2, 1, 3 };
+        for (int i = 0; i < 6; ++i)
+            indices[quad * 6 + i] = quad * 4 + quadIndices[i];
+    }
+    nodes.at(5)->markDirty(QSGNode::DirtyGeometry);
+    QVERIFY(renderFrame());
+    QCOMPARE(renderer.partiallyUploadedBytes(), quint64(0));
+    QVERIFY(renderer.uploadedBytes() > 0);
+
+    renderContext->invalidate();
+}
+
+void NodesTest::instancedBatch_data()
+{
+    rhiTestData();
+}
+
+static void setColoredQuad(QSGGeometryNode *node, const QRectF &rect, const QColor &color)
+{
+    QSGGeometry *g = node->geometry();
+    QSGGeometry::ColoredPoint2D *v = g->vertexDataAsColoredPoint2D();
+    const uchar r = color.red(), gr = color.green(), b = color.blue(), a = color.alpha();
+    v[0].set(rect.left(), rect.top(), r, gr, b, a);
+    v[1].set(rect.left(), rect.bottom(), r, gr, b, a);
+    v[2].set(rect.right(), rect.top(), r, gr, b, a);
+    v[3].set(rect.right(), rect.bottom(), r, gr, b, a);
+    quint16 *indices = g->indexDataAsUShort();
+    for (int i = 0; i < 4; ++i)
+        indices[i] = i;
+    node->markDirty(QSGNode::DirtyGeometry);
+}
+
+void NodesTest::instancedBatch()
+{
+    INIT_RHI();
+
+    if (!rhi->isFeatureSupported(QRhi::Instancing))
+        QSKIP("Instancing is not supported");
+
+    const QSize size(200, 200);
+    QScopedPointer<QRhiTexture> texture(rhi->newTexture(QRhiTexture::RGBA8, size, 1,
+                                                        QRhiTexture::RenderTarget | QRhiTexture::UsedAsTransferSource));
+    QVERIFY(texture->create());
+    QScopedPointer<QRhiTextureRenderTarget> rt(rhi->newTextureRenderTarget({ texture.data() }));
+    QScopedPointer<QRhiRenderPassDescriptor> rpDesc(rt->newCompatibleRenderPassDescriptor());
+    rt->setRenderPassDescriptor(rpDesc.data());
+    QVERIFY(rt->create());
+
+    // Grid cells: the same quad in different places and colors
+    QSGRootNode root;
+    QSGVertexColorMaterial material;
+    material.setFlag(QSGMaterial::Blending, false);
+    QList<QSGGeometryNode *> nodes;
+    for (int i = 0; i < 32; ++i) {
+        QSGGeometryNode *node = new QSGGeometryNode;
+        node->setGeometry(new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 4, 4));
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(&material);
+        setColoredQuad(node, QRectF(i % 8 * 20, i / 8 * 20, 16, 16), QColor::fromHsv(i * 10, 255, 255));
+        root.appendChildNode(node);
+        nodes << node;
+    }
+
+    QSGBatchRenderer::Renderer renderer(renderContext);
+    renderer.setRootNode(&root);
+    renderer.setInstancingEnabled(false);
+    renderer.setDeviceRect(QRect(QPoint(0, 0), size));
+    renderer.setViewportRect(QRect(QPoint(0, 0), size));
+    QSGAbstractRenderer::MatrixTransformFlags matrixFlags;
+    if (!rhi->isYUpInNDC())
+        matrixFlags |= QSGAbstractRenderer::MatrixTransformFlipY;
+    renderer.setProjectionMatrixToRect(QRectF(QPointF(0, 0), size), matrixFlags, !rhi->isYUpInNDC());
+
+    auto renderFrame = [&] {
+        QRhiCommandBuffer *cb = nullptr;
+        if (rhi->beginOffscreenFrame(&cb) != QRhi::FrameOpSuccess)
+            return false;
+        renderer.setRenderTarget(QSGRenderTarget(rt.data(), rpDesc.data(), cb));
+        renderer.renderScene();
+        rhi->endOffscreenFrame();
+        return true;
+    };
+
+    QVERIFY(renderFrame());
+    const quint64 mergedUpload = renderer.uploadedBytes();
+    QVERIFY(mergedUpload > 0);
+
+    // The shape is uploaded once, plus a small entry per node
+    renderer.setInstancingEnabled(true);
+    for (int i = 0; i < nodes.size(); ++i)
+        setColoredQuad(nodes.at(i), QRectF(i % 8 * 20 + 2, i / 8 * 20, 16, 16), QColor::fromHsv(i * 10, 255, 255));
+    QVERIFY(renderFrame());
+    QVERIFY(renderer.uploadedBytes() > 0);
+    QVERIFY(renderer.uploadedBytes() < mergedUpload / 2);
+
+    // The instanced batch renders exactly what the merged one does
+    if (rhi->backend() != QRhi::Null) {
+        const QImage instanced = readBackTexture(rhi.data(), texture.data());
+        QCOMPARE(instanced.size(), size);
+        QCOMPARE(instanced.pixelColor(3, 1), QColor(Qt::red));
+
+        renderer.setInstancingEnabled(false);
+        for (int i = 0; i < nodes.size(); ++i)
+            setColoredQuad(nodes.at(i), QRectF(i % 8 * 20 + 2, i / 8 * 20, 16, 16), QColor::fromHsv(i * 10, 255, 255));
+        QVERIFY(renderFrame());
+        QCOMPARE(renderer.uploadedBytes(), mergedUpload);
+        const QImage merged = readBackTexture(rhi.data(), texture.data());
+        QCOMPARE(instanced, merged);
+
+        renderer.setInstancingEnabled(true);
+        for (int i = 0; i < nodes.size(); ++i)
+            setColoredQuad(nodes.at(i), QRectF(i % 8 * 20 + 2, i / 8 * 20, 16, 16), QColor::fromHsv(i * 10, 255, 255));
+        QVERIFY(renderFrame());
+        QVERIFY(renderer.uploadedBytes() < mergedUpload / 2);
+    }
+
+    // A node that is not a single colored quad makes the batch merged again
+    QSGGeometry::ColoredPoint2D *v = nodes.at(7)->geometry()->vertexDataAsColoredPoint2D();
+    v[3].set(v[3].x, v[3].y, 0, 0, 0, 255);
+    nodes.at(7)->markDirty(QSGNode::DirtyGeometry);
+    QVERIFY(renderFrame());
+    QCOMPARE(renderer.uploadedBytes(), mergedUpload);
+
+    renderContext->invalidate();
+}
+
+void NodesTest::atlasRetirement_data()
+{
+    rhiTestData();
+}
+
+void NodesTest::atlasRetirement()
+{
+    INIT_RHI();
+
+    const QByteArrayList variables = { "QSG_ATLAS_WIDTH", "QSG_ATLAS_HEIGHT",
+                                       "QSG_ATLAS_ALLOCATOR", "QSG_ATLAS_REPACK_THRESHOLD" };
+    auto restoreEnvironment = qScopeGuard([&variables] {
+        for (const QByteArray &variable : variables)
+            qunsetenv(variable.constData());
+    });
+    qputenv("QSG_ATLAS_WIDTH", "256");
+    qputenv("QSG_ATLAS_HEIGHT", "256");
+    qputenv("QSG_ATLAS_ALLOCATOR", "skyline");
+    qputenv("QSG_ATLAS_REPACK_THRESHOLD", "25");
+    QSGRhiAtlasTexture::Manager manager(renderContext, QSize(256, 256), nullptr);
+
+    // 16 images fill the atlas, with one pixel of padding around each
+    QImage small(62, 62, QImage::Format_RGBA8888_Premultiplied);
+    small.fill(Qt::red);
+    QList<QSGTexture *> textures;
+    for (int i = 0; i < 16; ++i) {
+        QSGTexture *t = manager.create(small, true);
+        QVERIFY(t);
+        textures << t;
+    }
+    const qint64 firstAtlas = textures.first()->comparisonKey();
+    for (QSGTexture *t : std::as_const(textures))
+        QCOMPARE(t->comparisonKey(), firstAtlas);
+
+    // A full atlas is not fragmented, so the image gets a texture of its own
+    QVERIFY(!manager.create(small, true));
+    QCOMPARE(manager.fallbackCount(), 1);
+    QVERIFY(!manager.hasRetiredAtlas());
+
+    for (int i = 0; i < textures.size(); ++i)
+        delete textures.takeAt(i);
+    QCOMPARE(textures.size(), 8);
+    QVERIFY(manager.fragmentation() >= 0.25);
+
+    // The scattered free space has no room for a larger image, so the
+    // atlas is retired and the image goes into a new one
+    QImage large(100, 100, QImage::Format_RGBA8888_Premultiplied);
+    large.fill(Qt::blue);
+    QScopedPointer<QSGTexture> inNewAtlas(manager.create(large, true));
+    QVERIFY(inNewAtlas);
+    QVERIFY(inNewAtlas->comparisonKey() != firstAtlas);
+    QVERIFY(manager.hasRetiredAtlas());
+    QCOMPARE(manager.fallbackCount(), 1);
+
+    // The retired atlas stays until its last texture is gone
+    while (textures.size() > 1) {
+        delete textures.takeLast();
+        manager.releaseRetiredAtlas();
+        QVERIFY(manager.hasRetiredAtlas());
+    }
+    delete textures.takeLast();
+    manager.releaseRetiredAtlas();
+    QVERIFY(!manager.hasRetiredAtlas());
+
+    // The new atlas is used from now on
+    QScopedPointer<QSGTexture> another(manager.create(small, true));
+    QVERIFY(another);
+    QCOMPARE(another->comparisonKey(), inNewAtlas->comparisonKey());
+
+    another.reset();
+    inNewAtlas.reset();
+    manager.invalidate();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    renderContext->invalidate();
+}
+
 QTEST_MAIN(NodesTest);
 
 #include "tst_nodestest.moc"
@@ -0,0 +1,15 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+import QtQuick
+
+ListView {
+    width: 200
+    height: 200
+    cacheBuffer: 100
+    model: 1000
+    delegate: Rectangle {
+        objectName: "delegate"
+        width: 200
+        height: 20
+    }
+}
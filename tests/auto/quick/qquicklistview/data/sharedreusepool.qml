@@ -0,0 +1,60 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+import QtQuick
+
+Item {
+    id: root
+    width: 640
+    height: 480
+
+    property bool shareDelegate: true
+    property int delegatesCreatedCount: 0
+
+    Component {
+        id: rowDelegate
+        Rectangle {
+            objectName: "delegate"
+            width: 200
+            height: 20
+            property int modelIndex: index
+            property string text: modelData
+            property Item view: ListView.view
+            Component.onCompleted: root.delegatesCreatedCount++
+        }
+    }
+
+    Component {
+        id: otherRowDelegate
+        Rectangle {
+            objectName: "delegate"
+            width: 200
+            height: 20
+            property int modelIndex: index
+            property string text: modelData
+            property Item view: ListView.view
+            Component.onCompleted: root.delegatesCreatedCount++
+        }
+    }
+
+    ListView {
+        objectName: "listA"
+        x: 0
+        width: 200
+        height: 200
+        cacheBuffer: 0
+        reuseItems: true
+        model: Array.from({ length: 100 }, (_, i) => "a" + i)
+        delegate: rowDelegate
+    }
+
+    ListView {
+        objectName: "listB"
+        x: 300
+        width: 200
+        height: 200
+        cacheBuffer: 0
+        reuseItems: true
+        model: Array.from({ length: 100 }, (_, i) => "b" + i)
+        delegate: root.shareDelegate ? rowDelegate : otherRowDelegate
+    }
+}
@@ -22,6 +22,7 @@
 #include <QtQmlModels/private/qqmlobjectmodel_p.h>
 #include <QtQmlModels/private/qqmllistmodel_p.h>
 #include <QtQmlModels/private/qqmldelegatemodel_p.h>
+#include <QtQmlModels/private/qqmldelegatemodel_p_p.h>
 #include <qpa/qwindowsysteminterface.h>
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 #include <QtQuickTestUtils/private/viewtestutils_p.h>
@@ -274,6 +275,9 @@ private slots:
 
     void reuse_reuseIsOffByDefault();
     void reuse_checkThatItemsAreReused();
+    void reuse_handOverPooledItems();
+    void reuse_sharedPoolBudget();
+    void prefetchAheadOfFlick();
     void moveObjectModelItemToAnotherObjectModel();
     void changeModelAndDestroyTheOldOne();
     void objectModelCulling();
@@ -9928,6 +9932,14 @@ void tst_QQuickListView::reuse_checkThatItemsAreReused()
     QCOMPARE(countAfterUpFlick, countAfterDownFlick);
     QCOMPARE(poolSizeAfterUpFlick, initialItemCount);
 
+    // Check that the reuse statistics agree with the flicking above. All the
+    // items that were pooled after the down flick should have been reused.
+    const auto poolStatistics = itemView_d->model->poolStatistics();
+    QCOMPARE(poolStatistics.hits, quint64(poolSizeAfterDownFlick));
+    QCOMPARE(poolStatistics.pooled, poolStatistics.hits + poolStatistics.drained
+             + poolStatistics.evicted + quint64(poolSizeAfterUpFlick));
+    QVERIFY(poolStatistics.hitRate() > 0);
+
     // Go through all items and check that they have been reused exactly once
     // (except for ListView.currentItem, which was never released).
     const auto listViewCurrentItem = listView->currentItem();
@@ -9951,6 +9963,171 @@ void tst_QQuickListView::reuse_checkThatItemsAreReused()
     }
 }
 
+void tst_QQuickListView::reuse_handOverPooledItems()
+{
+    // Check that a view that misses in its own pool gets the items pooled
+    // by another view with the same delegate, instead of creating new ones.
+    QScopedPointer<QQuickView> window(createView());
+    window->setSource(testFileUrl("sharedreusepool.qml"));
+    window->resize(640, 480);
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QQuickItem *root = window->rootObject();
+    QVERIFY(root);
+    auto *listA = findItem<QQuickListView>(root, "listA");
+    auto *listB = findItem<QQuickListView>(root, "listB");
+    QVERIFY(listA);
+    QVERIFY(listB);
+    QQmlInstanceModel *modelA = QQuickItemViewPrivate::get(listA)->model;
+    QQmlInstanceModel *modelB = QQuickItemViewPrivate::get(listB)->model;
+
+    const int initialItemCount = findItems<QQuickItem>(listA, "delegate").size();
+    QVERIFY(initialItemCount > 1);
+    const qreal flickDistance = initialItemCount * 20 + 1;
+
+    listA->setContentY(flickDistance);
+    QVERIFY(QQuickTest::qWaitForPolish(listA));
+    const int poolSizeA = modelA->poolSize();
+    QCOMPARE(poolSizeA, initialItemCount - 1);
+    const int createdAfterFlickA = root->property("delegatesCreatedCount").toInt();
+
+    listB->setContentY(flickDistance);
+    QVERIFY(QQuickTest::qWaitForPolish(listB));
+    const auto itemsB = findItems<QQuickItem>(listB, "delegate");
+    QVERIFY(itemsB.size() >= poolSizeA);
+
+    // All items pooled by list A were handed over, and only the rest was created
+    const int createdAfterFlickB = root->property("delegatesCreatedCount").toInt();
+    QCOMPARE(createdAfterFlickB - createdAfterFlickA, itemsB.size() - poolSizeA);
+    QCOMPARE(modelA->poolSize(), 0);
+    QCOMPARE(modelA->poolStatistics().handedOver, quint64(poolSizeA));
+    QCOMPARE(modelB->poolStatistics().hits, quint64(poolSizeA));
+
+    // The handed over items belong to list B, and show the data of its model
+    for (QQuickItem *item : itemsB) {
+        QCOMPARE(item->parentItem(), listB->contentItem());
+        QCOMPARE(item->property("view").value<QQuickItem *>(), listB);
+        const int modelIndex = item->property("modelIndex").toInt();
+        QVERIFY(modelIndex >= initialItemCount);
+        QCOMPARE(item->property("text").toString(), QStringLiteral("b%1").arg(modelIndex));
+    }
+
+    // List A still works after giving its items away
+    listA->setContentY(0);
+    QVERIFY(QQuickTest::qWaitForPolish(listA));
+    const auto itemsA = findItems<QQuickItem>(listA, "delegate");
+    QCOMPARE(itemsA.size(), initialItemCount);
+    for (QQuickItem *item : itemsA) {
+        QCOMPARE(item->property("view").value<QQuickItem *>(), listA);
+        const int modelIndex = item->property("modelIndex").toInt();
+        QCOMPARE(item->property("text").toString(), QStringLiteral("a%1").arg(modelIndex));
+    }
+}
+
+void tst_QQuickListView::reuse_sharedPoolBudget()
+{
+    // Check that the pools of all views of an engine share a budget, and that
+    // the items that have been pooled for the longest time are evicted first.
+    QScopedPointer<QQuickView> window(createView());
+    window->setInitialProperties({{QLatin1String("shareDelegate"), false}});
+    window->setSource(testFileUrl("sharedreusepool.qml"));
+    window->resize(640, 480);
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    QQuickItem *root = window->rootObject();
+    QVERIFY(root);
+    auto *listA = findItem<QQuickListView>(root, "listA");
+    auto *listB = findItem<QQuickListView>(root, "listB");
+    QVERIFY(listA);
+    QVERIFY(listB);
+    QQmlInstanceModel *modelA = QQuickItemViewPrivate::get(listA)->model;
+    QQmlInstanceModel *modelB = QQuickItemViewPrivate::get(listB)->model;
+
+    auto *sharedPool = QQmlSharedDelegateModelItemsPool::get(window->engine()->handle());
+    QCOMPARE(sharedPool->budget(), 0);
+
+    const int initialItemCount = findItems<QQuickItem>(listA, "delegate").size();
+    const int budget = 4;
+    QVERIFY(initialItemCount > budget + 1);
+    const qreal flickDistance = initialItemCount * 20 + 1;
+
+    listA->setContentY(flickDistance);
+    QVERIFY(QQuickTest::qWaitForPolish(listA));
+    const int poolSizeA = modelA->poolSize();
+    QCOMPARE(poolSizeA, initialItemCount - 1);
+    QCOMPARE(sharedPool->size(), poolSizeA);
+
+    // Lowering the budget evicts the surplus right away
+    sharedPool->setBudget(budget);
+    QCOMPARE(modelA->poolSize(), budget);
+    QCOMPARE(sharedPool->size(), budget);
+    QCOMPARE(modelA->poolStatistics().evicted, quint64(poolSizeA - budget));
+
+    // The items pooled by list B are newer, so the items still pooled by
+    // list A have to go first
+    listB->setContentY(flickDistance);
+    QVERIFY(QQuickTest::qWaitForPolish(listB));
+    QCOMPARE(modelA->poolSize(), 0);
+    QCOMPARE(modelA->poolStatistics().evicted, quint64(poolSizeA));
+    QCOMPARE(modelB->poolSize(), budget);
+    QCOMPARE(sharedPool->size(), budget);
+    QCOMPARE(modelB->poolStatistics().handedOver, quint64(0));
+    QCOMPARE(sharedPool->statistics().evicted,
+             modelA->poolStatistics().evicted + modelB->poolStatistics().evicted);
+
+    // Lifting the budget keeps what is pooled
+    sharedPool->setBudget(0);
+    QCOMPARE(sharedPool->size(), budget);
+}
+
+void tst_QQuickListView::prefetchAheadOfFlick()
+{
+    // Check that ListView only counts the delegates it creates ahead of a
+    // flick as prefetched, and stops creating them once the budget is used up.
+    const int budget = QQuickFlickablePrivate::prefetchBudget();
+    QQuickFlickablePrivate::setPrefetchLookahead(1000);
+    QQuickFlickablePrivate::setPrefetchBudget(3);
+    const auto cleanup = qScopeGuard([budget] {
+        QQuickFlickablePrivate::setPrefetchLookahead(0);
+        QQuickFlickablePrivate::setPrefetchBudget(budget);
+    });
+
+    QScopedPointer<QQuickView> window(createView());
+    window->setSource(testFileUrl("prefetch.qml"));
+    window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(window.data()));
+
+    auto *listView = qobject_cast<QQuickListView *>(window->rootObject());
+    QVERIFY(listView);
+    auto *listView_d = QQuickItemViewPrivate::get(listView);
+    QQuickItem *contentItem = listView->contentItem();
+
+    // Filling the cache buffer without flicking is not prefetching
+    listView->setContentY(20);
+    QTRY_VERIFY(findItem<QQuickItem>(contentItem, "delegate", 15));
+    QTRY_COMPARE(listView_d->requestedIndex, -1);
+    QCOMPARE(listView_d->pendingPrefetchedItemCount(), 0);
+
+    // While flicking, delegates are created ahead of the view up to the budget
+    listView_d->vData.smoothVelocity.setValue(2000);
+    listView->setContentY(40);
+    QTRY_COMPARE(listView_d->pendingPrefetchedItemCount(), 3);
+    QTRY_COMPARE(listView_d->requestedIndex, -1);
+    QCOMPARE(listView_d->pendingPrefetchedItemCount(), 3);
+    QCOMPARE(listView_d->prefetchStatistics().misses, quint64(0));
+
+    // The prefetched delegates are hits once they are flicked into view
+    listView_d->vData.smoothVelocity.setValue(0);
+    listView->setContentY(240);
+    QVERIFY(QQuickTest::qWaitForPolish(listView));
+    const auto &statistics = listView_d->prefetchStatistics();
+    QVERIFY(statistics.hits > 0);
+    QCOMPARE(statistics.hits + statistics.wasted
+             + quint64(listView_d->pendingPrefetchedItemCount()), quint64(3));
+}
+
 void tst_QQuickListView::dragOverFloatingHeaderOrFooter() // QTBUG-74046
 {
     QQuickView *window = getView();
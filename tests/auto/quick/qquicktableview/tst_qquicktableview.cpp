@@ -147,6 +147,8 @@ private slots:
     void checkContextPropertiesQQmlListProperyModel_data();
     void checkContextPropertiesQQmlListProperyModel();
     void checkRowAndColumnChangedButNotIndex();
+    void prefetchEdgesAheadOfFlick();
+    void prefetchDoesNotBlockViewportEdges();
     void checkThatWeAlwaysEmitChangedUponItemReused();
     void checkChangingModelFromDelegate();
     void checkRebuildViewportOnly();
@@ -2383,6 +2385,103 @@ void tst_QQuickTableView::checkContextPropertiesQQmlListProperyModel()
     }
 }
 
+void tst_QQuickTableView::prefetchEdgesAheadOfFlick()
+{
+    // Check that TableView loads the edges that are about to be flicked
+    // into view asynchronously, and counts them as hits once shown.
+    LOAD_TABLEVIEW("plaintableview.qml");
+
+    auto model = TestModelAsVariant(100, 100);
+    tableView->setModel(model);
+    tableView->setReuseItems(false);
+    WAIT_UNTIL_POLISHED;
+
+    // Let the test, rather than the window, decide when to incubate
+    QQmlIncubationController incubationController;
+    QQmlIncubationController *windowController = view->engine()->incubationController();
+    view->engine()->setIncubationController(&incubationController);
+    QQuickFlickablePrivate::setPrefetchLookahead(500);
+    const auto cleanup = qScopeGuard([&] {
+        QQuickFlickablePrivate::setPrefetchLookahead(0);
+        view->engine()->setIncubationController(windowController);
+    });
+
+    const int bottomRow = tableView->bottomRow();
+    tableViewPrivate->vData.smoothVelocity.setValue(400);
+    tableView->polish();
+    WAIT_UNTIL_POLISHED;
+    QVERIFY(tableViewPrivate->loadRequest.isActive());
+    QVERIFY(tableViewPrivate->prefetchingEdge);
+    QCOMPARE(tableViewPrivate->loadRequest.edge(), Qt::BottomEdge);
+    QCOMPARE(tableView->bottomRow(), bottomRow);
+
+    for (int i = 0; i < 100 && tableViewPrivate->loadRequest.isActive(); ++i)
+        incubationController.incubateFor(100);
+    QVERIFY(!tableViewPrivate->loadRequest.isActive());
+    QVERIFY(tableView->bottomRow() > bottomRow);
+    QVERIFY(tableViewPrivate->loadedTableOuterRect.bottom() > tableViewPrivate->viewportRect.bottom());
+    const int prefetched = tableViewPrivate->pendingPrefetchedItemCount();
+    QVERIFY(prefetched > 0);
+    QCOMPARE(tableViewPrivate->prefetchStatistics().misses, quint64(0));
+
+    // Flick some of the prefetched rows into view, and stop. The rest is
+    // unloaded again.
+    tableViewPrivate->vData.smoothVelocity.setValue(0);
+    tableView->setContentY(tableView->contentY() + 100);
+    QVERIFY(QQuickTest::qWaitForPolish(tableView));
+    const auto &statistics = tableViewPrivate->prefetchStatistics();
+    QVERIFY(statistics.hits > 0);
+    QCOMPARE(statistics.hits + statistics.wasted
+             + quint64(tableViewPrivate->pendingPrefetchedItemCount()), quint64(prefetched));
+}
+
+void tst_QQuickTableView::prefetchDoesNotBlockViewportEdges()
+{
+    // Check that an edge that is still incubating ahead of a flick doesn't
+    // hold back the edges that the viewport needs.
+    LOAD_TABLEVIEW("plaintableview.qml");
+
+    auto model = TestModelAsVariant(100, 100);
+    tableView->setModel(model);
+    tableView->setReuseItems(false);
+    WAIT_UNTIL_POLISHED;
+
+    QQmlIncubationController incubationController;
+    QQmlIncubationController *windowController = view->engine()->incubationController();
+    view->engine()->setIncubationController(&incubationController);
+    QQuickFlickablePrivate::setPrefetchLookahead(500);
+    const auto cleanup = qScopeGuard([&] {
+        QQuickFlickablePrivate::setPrefetchLookahead(0);
+        view->engine()->setIncubationController(windowController);
+    });
+
+    tableViewPrivate->vData.smoothVelocity.setValue(400);
+    tableView->polish();
+    WAIT_UNTIL_POLISHED;
+    QVERIFY(tableViewPrivate->loadRequest.isActive());
+    QVERIFY(tableViewPrivate->prefetchingEdge);
+    QCOMPARE(tableViewPrivate->loadRequest.edge(), Qt::BottomEdge);
+
+    // When the viewport needs the row that is being prefetched,
+    // it is completed right away
+    const int bottomRow = tableView->bottomRow();
+    tableView->setContentY(tableView->contentY() + 60);
+    QVERIFY(QQuickTest::qWaitForPolish(tableView));
+    QVERIFY(tableView->bottomRow() > bottomRow);
+    QVERIFY(tableViewPrivate->loadedTableOuterRect.bottom() >= tableViewPrivate->viewportRect.bottom());
+
+    // When the viewport needs a column while the next row is being
+    // prefetched, the row is given up on
+    QVERIFY(tableViewPrivate->loadRequest.isActive());
+    QVERIFY(tableViewPrivate->prefetchingEdge);
+    QCOMPARE(tableViewPrivate->loadRequest.edge(), Qt::BottomEdge);
+    const int rightColumn = tableView->rightColumn();
+    tableView->setContentX(tableView->contentX() + 110);
+    QVERIFY(QQuickTest::qWaitForPolish(tableView));
+    QVERIFY(tableView->rightColumn() > rightColumn);
+    QVERIFY(tableViewPrivate->loadedTableOuterRect.right() >= tableViewPrivate->viewportRect.right());
+}
+
 void tst_QQuickTableView::checkRowAndColumnChangedButNotIndex()
 {
     // Check that context row and column changes even if the index stays the
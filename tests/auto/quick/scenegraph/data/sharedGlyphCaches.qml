@@ -0,0 +1,18 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick
+
+Rectangle {
+    width: 200
+    height: 200
+    color: "white"
+    Text {
+        objectName: "text"
+        anchors.centerIn: parent
+        renderType: Text.QtRendering
+        font.pixelSize: 64
+        color: "black"
+        text: "HI"
+    }
+}
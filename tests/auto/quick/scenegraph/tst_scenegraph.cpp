@@ -20,6 +20,9 @@
 #include <private/qsgrenderloop_p.h>
 #include <private/qsgrhisupport_p.h>
 #include <private/qsgplaintexture_p.h>
+#include <private/qsgdefaultrendercontext_p.h>
+#include <private/qsgrhidistancefieldglyphcache_p.h>
+#include <private/qquickwindow_p.h>
 
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 #include <QtQuickTestUtils/private/visualtestutils_p.h>
@@ -95,6 +98,10 @@ private slots:
     void createTextureFromImage_data();
     void createTextureFromImage();
     void withAdoptedRhi();
+    void sharedGlyphCaches();
+    void asyncGlyphGeneration();
+    void asyncGlyphEviction();
+    void prefetchGlyphs();
     void resizeTextureFromImage();
 
 private:
@@ -733,6 +740,373 @@ void tst_SceneGraph::withAdoptedRhi()
     TestOffscreenScene::cleanup();
 }
 
+static QRhiTextureRenderTarget *createRenderTarget(QRhi *rhi, QRhiTexture *texture, QRhiRenderBuffer *ds,
+                                                   QScopedPointer<QRhiRenderPassDescriptor> &rp)
+{
+    QRhiTextureRenderTargetDescription rtDesc(QRhiColorAttachment { texture });
+    rtDesc.setDepthStencilBuffer(ds);
+    QRhiTextureRenderTarget *rt = rhi->newTextureRenderTarget(rtDesc);
+    rp.reset(rt->newCompatibleRenderPassDescriptor());
+    rt->setRenderPassDescriptor(rp.data());
+    rt->create();
+    return rt;
+}
+
+static void renderFrame(TestOffscreenScene *scene)
+{
+    scene->renderControl->polishItems();
+    scene->renderControl->beginFrame();
+    scene->renderControl->sync();
+    scene->renderControl->render();
+    scene->renderControl->endFrame();
+}
+
+static QImage readBackTexture(QRhi *rhi, QRhiTexture *texture)
+{
+    QRhiCommandBuffer *cb = nullptr;
+    rhi->beginOffscreenFrame(&cb);
+    QRhiReadbackResult readResult;
+    QImage result;
+    readResult.completed = [&readResult, &result, rhi] {
+        QImage wrapperImage(reinterpret_cast<const uchar *>(readResult.data.constData()),
+                            readResult.pixelSize.width(), readResult.pixelSize.height(),
+                            QImage::Format_RGBA8888_Premultiplied);
+        if (rhi->isYUpInFramebuffer())
+            result = wrapperImage.mirrored();
+        else
+            result = wrapperImage.copy();
+    };
+    QRhiResourceUpdateBatch *readbackBatch = rhi->nextResourceUpdateBatch();
+    readbackBatch->readBackTexture(texture, &readResult);
+    cb->resourceUpdate(readbackBatch);
+    rhi->endOffscreenFrame();
+    return result;
+}
+
+static int darkPixelCount(const QImage &image)
+{
+    int count = 0;
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            if (qGray(image.pixel(x, y)) < 128)
+                ++count;
+        }
+    }
+    return count;
+}
+
+void tst_SceneGraph::sharedGlyphCaches()
+{
+    if (!isRunningOnRhi())
+        QSKIP("Skipping test due to not running with QRhi");
+
+    const bool wasSharing = QSGDefaultRenderContext::isGlyphCacheSharingEnabled();
+    QSGDefaultRenderContext::setGlyphCacheSharingEnabled(true);
+    auto restoreSharing = qScopeGuard([wasSharing] {
+        QSGDefaultRenderContext::setGlyphCacheSharingEnabled(wasSharing);
+    });
+
+    // scene0 owns the QRhi, so that it survives the text scenes using it
+    TestOffscreenScene *scene0 = createOffscreenScene(testFileUrl(QLatin1String("renderControl_rect.qml")));
+    QVERIFY(scene0 && scene0->window);
+    QScopedPointer<TestOffscreenScene> scene1(createOffscreenScene(testFileUrl(QLatin1String("sharedGlyphCaches.qml")), scene0->window));
+    QVERIFY(scene1 && scene1->rootItem);
+    QScopedPointer<TestOffscreenScene> scene2(createOffscreenScene(testFileUrl(QLatin1String("sharedGlyphCaches.qml")), scene0->window));
+    QVERIFY(scene2 && scene2->rootItem);
+
+    QRhi *rhi = static_cast<QRhi *>(scene0->window->rendererInterface()->getResource(scene0->window, QSGRendererInterface::RhiResource));
+    QVERIFY(rhi);
+
+    QQuickWindowPrivate *wd1 = QQuickWindowPrivate::get(scene1->window);
+    QQuickWindowPrivate *wd2 = QQuickWindowPrivate::get(scene2->window);
+    auto *rc1 = static_cast<QSGDefaultRenderContext *>(wd1->context);
+    auto *rc2 = static_cast<QSGDefaultRenderContext *>(wd2->context);
+
+    { // scope to get resources destroyed before the QRhi
+        const QSize size = scene1->rootItem->size().toSize();
+        QScopedPointer<QRhiRenderBuffer> ds(rhi->newRenderBuffer(QRhiRenderBuffer::DepthStencil, size, 1));
+        QVERIFY(ds->create());
+
+        QScopedPointer<QRhiTexture> tex1(rhi->newTexture(QRhiTexture::RGBA8, size, 1,
+                                                         QRhiTexture::RenderTarget | QRhiTexture::UsedAsTransferSource));
+        QVERIFY(tex1->create());
+        QScopedPointer<QRhiRenderPassDescriptor> rp1;
+        QScopedPointer<QRhiTextureRenderTarget> texRt1(createRenderTarget(rhi, tex1.data(), ds.data(), rp1));
+        scene1->window->setRenderTarget(QQuickRenderTarget::fromRhiRenderTarget(texRt1.data()));
+
+        QScopedPointer<QRhiTexture> tex2(rhi->newTexture(QRhiTexture::RGBA8, size, 1,
+                                                         QRhiTexture::RenderTarget | QRhiTexture::UsedAsTransferSource));
+        QVERIFY(tex2->create());
+        QScopedPointer<QRhiRenderPassDescriptor> rp2;
+        QScopedPointer<QRhiTextureRenderTarget> texRt2(createRenderTarget(rhi, tex2.data(), ds.data(), rp2));
+        scene2->window->setRenderTarget(QQuickRenderTarget::fromRhiRenderTarget(texRt2.data()));
+
+        renderFrame(scene1.data());
+        renderFrame(scene2.data());
+
+        // Both windows use the same cache, and each is accounted for half of it
+        const QList<QSGDistanceFieldGlyphCache *> caches = rc1->distanceFieldGlyphCaches();
+        QCOMPARE(caches.size(), 1);
+        QCOMPARE(rc2->distanceFieldGlyphCaches(), caches);
+        QCOMPARE(QSGDefaultRenderContext::sharedGlyphCacheCount(), 1);
+        auto *cache = static_cast<QSGRhiDistanceFieldGlyphCache *>(caches.first());
+        QVERIFY(cache->isShared());
+        QCOMPARE(cache->renderContext(), rc1);
+        QVERIFY(cache->textureMemory() > 0);
+        QCOMPARE(wd1->glyphCacheTextureMemory(), cache->textureMemory() / 2);
+        QCOMPARE(wd2->glyphCacheTextureMemory(), wd1->glyphCacheTextureMemory());
+
+        const int darkPixels = darkPixelCount(readBackTexture(rhi, tex2.data()));
+        QVERIFY(darkPixels > 0);
+        QCOMPARE(darkPixelCount(readBackTexture(rhi, tex1.data())), darkPixels);
+
+        // Have the glyphs for new text generated and uploaded through scene1
+        // without rendering it, so that the uploads are still pending when
+        // scene1 goes away. They must stay with the cache.
+        const QString newText = QStringLiteral("WM");
+        QQuickItem *text1 = scene1->rootItem->findChild<QQuickItem *>(QStringLiteral("text"));
+        QVERIFY(text1);
+        text1->setProperty("text", newText);
+        scene1->renderControl->polishItems();
+        scene1->renderControl->sync();
+        rc1->preprocess();
+
+        scene1.reset();
+        QCOMPARE(rc2->distanceFieldGlyphCaches(), caches);
+        QCOMPARE(QSGDefaultRenderContext::sharedGlyphCacheCount(), 1);
+        QCOMPARE(cache->renderContext(), rc2);
+        QCOMPARE(wd2->glyphCacheTextureMemory(), cache->textureMemory());
+
+        QQuickItem *text2 = scene2->rootItem->findChild<QQuickItem *>(QStringLiteral("text"));
+        QVERIFY(text2);
+        text2->setProperty("text", newText);
+        renderFrame(scene2.data());
+        QVERIFY(darkPixelCount(readBackTexture(rhi, tex2.data())) > 0);
+
+        // The last user deletes the cache
+        scene2.reset();
+        QCOMPARE(QSGDefaultRenderContext::sharedGlyphCacheCount(), 0);
+    }
+
+    delete scene0;
+
+    TestOffscreenScene::cleanup();
+}
+
+// Glyph cache that only keeps track of what gets stored, for testing the
+// generation of distance fields without a graphics API
+class TestGlyphCache : public QSGDistanceFieldGlyphCache
+{
+public:
+    TestGlyphCache(const QRawFont &font)
+        : QSGDistanceFieldGlyphCache(font, 0)
+    {
+        setGlyphsReadyCallback([this] { glyphsReadyCount.fetchAndAddRelaxed(1); });
+    }
+
+    ~TestGlyphCache() override
+    {
+        setGlyphsReadyCallback(nullptr);
+    }
+
+    bool eightBitFormatIsAlphaSwizzled() const override { return false; }
+    bool screenSpaceDerivativesSupported() const override { return true; }
+
+    QVector<glyph_t> glyphs(const QString &text) const
+    {
+        return referenceFont().glyphIndexesForString(text);
+    }
+
+    void evict(glyph_t glyph) { removeGlyph(glyph); }
+
+    QSet<glyph_t> stored;
+    // How often each glyph was stored, and its last distance field
+    QHash<glyph_t, int> storeCount;
+    QHash<glyph_t, QDistanceField> lastStored;
+    QAtomicInt glyphsReadyCount;
+
+protected:
+    void requestGlyphs(const QSet<glyph_t> &glyphs) override
+    {
+        QList<GlyphPosition> positions;
+        for (glyph_t glyph : glyphs)
+            positions.append({ glyph, QPointF(0, 0) });
+        setGlyphsPosition(positions);
+        markGlyphsToRender(QVector<glyph_t>(glyphs.cbegin(), glyphs.cend()));
+    }
+
+    void storeGlyphs(const QList<QDistanceField> &glyphs) override
+    {
+        QVector<glyph_t> glyphIndexes;
+        for (const QDistanceField &distanceField : glyphs) {
+            QVERIFY(!distanceField.isNull());
+            stored.insert(distanceField.glyph());
+            ++storeCount[distanceField.glyph()];
+            lastStored.insert(distanceField.glyph(), distanceField);
+            glyphIndexes.append(distanceField.glyph());
+        }
+        setGlyphsTexture(glyphIndexes, m_texture);
+    }
+
+    void referenceGlyphs(const QSet<glyph_t> &) override { }
+    void releaseGlyphs(const QSet<glyph_t> &) override { }
+
+private:
+    Texture m_texture;
+};
+
+// Runs every glyph generation job to the end with the given settings
+struct AsyncGlyphGeneration
+{
+    AsyncGlyphGeneration(bool enabled, qint64 frameBudget)
+        : wasEnabled(QSGDistanceFieldGlyphCache::isAsyncGenerationEnabled())
+        , oldFrameBudget(QSGDistanceFieldGlyphCache::asyncGenerationFrameBudget())
+    {
+        QSGDistanceFieldGlyphCache::setAsyncGenerationEnabled(enabled);
+        QSGDistanceFieldGlyphCache::setAsyncGenerationFrameBudget(frameBudget);
+    }
+
+    ~AsyncGlyphGeneration()
+    {
+        QThreadPool::globalInstance()->waitForDone();
+        QSGDistanceFieldGlyphCache::setAsyncGenerationEnabled(wasEnabled);
+        QSGDistanceFieldGlyphCache::setAsyncGenerationFrameBudget(oldFrameBudget);
+    }
+
+    bool wasEnabled;
+    qint64 oldFrameBudget;
+};
+
+void tst_SceneGraph::asyncGlyphGeneration()
+{
+    // A budget of -1 defers every glyph to the worker threads
+    AsyncGlyphGeneration async(true, -1);
+    TestGlyphCache cache(QRawFont::fromFont(QFont()));
+    const QVector<glyph_t> glyphs = cache.glyphs(QStringLiteral("AB"));
+    QCOMPARE(glyphs.size(), 2);
+
+    // Placeholders are stored right away, so that the text is not missing
+    cache.populate(glyphs);
+    cache.update();
+    QCOMPARE(cache.stored, QSet<glyph_t>(glyphs.cbegin(), glyphs.cend()));
+    QHash<glyph_t, QDistanceField> placeholders = cache.lastStored;
+    for (glyph_t glyph : glyphs) {
+        QCOMPARE(cache.storeCount.value(glyph), 1);
+        const QDistanceField &placeholder = placeholders.value(glyph);
+        bool inside = false;
+        for (int y = 0; y < placeholder.height() && !inside; ++y) {
+            for (int x = 0; x < placeholder.width() && !inside; ++x)
+                inside = placeholder.constScanLine(y)[x] > 127;
+        }
+        QVERIFY2(inside, "the placeholder does not cover the glyph");
+    }
+
+    QThreadPool::globalInstance()->waitForDone();
+    QCOMPARE(cache.glyphsReadyCount.loadRelaxed(), 1);
+
+    // The distance fields replace the placeholders with the next update,
+    // in the same place
+    cache.update();
+    for (glyph_t glyph : glyphs) {
+        QCOMPARE(cache.storeCount.value(glyph), 2);
+        const QDistanceField &distanceField = cache.lastStored.value(glyph);
+        QCOMPARE(distanceField.width(), placeholders.value(glyph).width());
+        QCOMPARE(distanceField.height(), placeholders.value(glyph).height());
+    }
+}
+
+void tst_SceneGraph::asyncGlyphEviction()
+{
+    AsyncGlyphGeneration async(true, -1);
+    TestGlyphCache cache(QRawFont::fromFont(QFont()));
+    const QVector<glyph_t> glyphs = cache.glyphs(QStringLiteral("CD"));
+    QCOMPARE(glyphs.size(), 2);
+
+    cache.populate(glyphs);
+    cache.update();
+
+    // A glyph evicted while its distance field is generated has lost its
+    // place in the cache, the result is dropped
+    cache.evict(glyphs.at(0));
+    QThreadPool::globalInstance()->waitForDone();
+    cache.update();
+    QCOMPARE(cache.storeCount.value(glyphs.at(0)), 1);
+    QCOMPARE(cache.storeCount.value(glyphs.at(1)), 2);
+
+    // and it is generated again when requested again
+    cache.populate({ glyphs.at(0) });
+    cache.update();
+    QThreadPool::globalInstance()->waitForDone();
+    cache.update();
+    QCOMPARE(cache.storeCount.value(glyphs.at(0)), 3);
+    QCOMPARE(cache.storeCount.value(glyphs.at(1)), 2);
+}
+
+void tst_SceneGraph::prefetchGlyphs()
+{
+    AsyncGlyphGeneration async(false, 0);
+    TestGlyphCache cache(QRawFont::fromFont(QFont()));
+    const QVector<glyph_t> glyphs = cache.glyphs(QStringLiteral("EFG"));
+    QCOMPARE(glyphs.size(), 3);
+
+    // The painter paths are extracted in update(), not when prefetching
+    cache.prefetchGlyphs(glyphs);
+    QThreadPool::globalInstance()->waitForDone();
+    QCOMPARE(cache.prefetchedGlyphCount(), 0);
+    cache.update();
+    QThreadPool::globalInstance()->waitForDone();
+    QCOMPARE(cache.prefetchedGlyphCount(), 3);
+    QVERIFY(cache.stored.isEmpty());
+
+    // Requested glyphs take their prefetched distance fields
+    cache.populate({ glyphs.at(0), glyphs.at(1) });
+    cache.update();
+    QCOMPARE(cache.stored, QSet<glyph_t>({ glyphs.at(0), glyphs.at(1) }));
+    QCOMPARE(cache.prefetchedGlyphCount(), 1);
+
+    // The result for a glyph generated on the render thread while it was
+    // still being prefetched is dropped. Keep the only worker busy so that
+    // the prefetch job cannot run before.
+    QThreadPool *pool = QThreadPool::globalInstance();
+    {
+        const glyph_t late = cache.glyphs(QStringLiteral("H")).first();
+        const int maxThreadCount = pool->maxThreadCount();
+        pool->setMaxThreadCount(1);
+        QSemaphore blocker;
+        auto unblock = qScopeGuard([&] {
+            blocker.release();
+            pool->waitForDone();
+            pool->setMaxThreadCount(maxThreadCount);
+        });
+        pool->start([&blocker] { blocker.acquire(); });
+        cache.prefetchGlyphs({ late });
+        cache.update();
+        cache.populate({ late });
+        cache.update();
+        QVERIFY(cache.stored.contains(late));
+        blocker.release();
+        pool->waitForDone();
+        QCOMPARE(cache.prefetchedGlyphCount(), 1);
+    }
+
+    // Only a chunk of paths is extracted per update(), and the glyphs ready
+    // callback asks for a frame to extract the next one in
+    QVector<glyph_t> many;
+    for (glyph_t glyph = 1; glyph < glyph_t(qMin(cache.glyphCount(), 1000)); ++glyph)
+        many.append(glyph);
+    cache.glyphsReadyCount.storeRelaxed(0);
+    cache.prefetchGlyphs(many);
+    cache.update();
+    pool->waitForDone();
+    const int prefetched = cache.prefetchedGlyphCount();
+    QVERIFY(prefetched > 1);
+    QVERIFY(prefetched < many.size());
+    QVERIFY(cache.glyphsReadyCount.loadRelaxed() > 0);
+    cache.update();
+    pool->waitForDone();
+    QVERIFY(cache.prefetchedGlyphCount() > prefetched);
+}
+
 static inline void commitTexture(QRhi *rhi, QSGTexture *texture)
 {
     QRhiResourceUpdateBatch *rub = rhi->nextResourceUpdateBatch();
@@ -0,0 +1,25 @@
+import QtQuick
+
+Item {
+    width: 100
+    height: 100
+
+    Flickable {
+        objectName: "flickable"
+        anchors.fill: parent
+        contentHeight: 300
+
+        Rectangle {
+            width: 100
+            height: 50
+            color: "red"
+        }
+    }
+
+    // An opaque header in front of the upper half of the view
+    Rectangle {
+        width: 100
+        height: 50
+        color: "blue"
+    }
+}
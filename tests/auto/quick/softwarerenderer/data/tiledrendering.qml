@@ -0,0 +1,55 @@
+import QtQuick
+
+Item {
+    width: 600
+    height: 400
+
+    Rectangle {
+        anchors.fill: parent
+        gradient: Gradient {
+            GradientStop { position: 0; color: "steelblue" }
+            GradientStop { position: 1; color: "lightyellow" }
+        }
+    }
+
+    Repeater {
+        model: 24
+        Rectangle {
+            x: 17 + (index % 6) * 97
+            y: 13 + Math.floor(index / 6) * 93
+            width: 83
+            height: 71
+            radius: index % 3 * 9
+            rotation: index * 7
+            opacity: 0.4 + (index % 4) * 0.2
+            color: Qt.hsla(index / 24, 0.7, 0.5, 1)
+            border.width: index % 2 ? 3 : 0
+            border.color: "black"
+            antialiasing: true
+
+            Text {
+                anchors.centerIn: parent
+                text: "Tile " + index
+                font.pixelSize: 15
+            }
+        }
+    }
+
+    Rectangle {
+        x: 230
+        y: 120
+        width: 300
+        height: 200
+        radius: 40
+        color: "#80ff0000"
+        clip: true
+
+        Rectangle {
+            x: -30
+            y: 50
+            width: 400
+            height: 60
+            color: "darkgreen"
+        }
+    }
+}
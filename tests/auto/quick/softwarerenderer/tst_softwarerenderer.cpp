@@ -5,7 +5,12 @@
 #include <QtQml>
 #include <QGuiApplication>
 
+#include <private/qquickflickable_p.h>
+#include <private/qquickwindow_p.h>
 #include <private/qsgrenderloop_p.h>
+#include <private/qsgabstractsoftwarerenderer_p.h>
+#include <private/qsgsoftwareglyphnode_p.h>
+#include <private/qsgsoftwarepixmaprenderer_p.h>
 
 #include <QtQuickTestUtils/private/qmlutils_p.h>
 #include <QtQuickTestUtils/private/viewtestutils_p.h>
@@ -22,6 +27,10 @@ private slots:
     void initTestCase() override;
 
     void renderTarget();
+    void tiledRendering_data();
+    void tiledRendering();
+    void culledRendering();
+    void glyphImageCache();
 };
 
 tst_SoftwareRenderer::tst_SoftwareRenderer()
@@ -93,6 +102,246 @@ void tst_SoftwareRenderer::renderTarget()
              qPrintable(errorMessage));
 }
 
+void tst_SoftwareRenderer::tiledRendering_data()
+{
+    QTest::addColumn<int>("threadCount");
+
+    QTest::newRow("2 threads") << 2;
+    QTest::newRow("8 threads") << 8;
+}
+
+void tst_SoftwareRenderer::tiledRendering()
+{
+    if (QQuickWindow::sceneGraphBackend() != "software")
+        QSKIP("Skipping complex rendering tests due to not running with software");
+
+    QFETCH(int, threadCount);
+
+    QQuickRenderControl rc;
+    QScopedPointer<QQuickWindow> window(new QQuickWindow(&rc));
+    window->resize(600, 400);
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("tiledrendering.qml"));
+    QScopedPointer<QQuickItem> rootItem(qobject_cast<QQuickItem *>(component.create()));
+    QVERIFY2(rootItem, qPrintable(component.errorString()));
+    rootItem->setParentItem(window->contentItem());
+
+    QImage windowTarget(window->size(), QImage::Format_ARGB32_Premultiplied);
+    window->setRenderTarget(QQuickRenderTarget::fromPaintDevice(&windowTarget));
+
+    rc.polishItems();
+    rc.beginFrame();
+    rc.sync();
+    rc.render();
+    rc.endFrame();
+
+    QQuickWindowPrivate *wd = QQuickWindowPrivate::get(window.data());
+    QSGRootNode *rootNode = wd->renderer->rootNode();
+    QVERIFY(rootNode);
+
+    // Render the synced scene once serially and once in parallel tiles,
+    // the results must be identical.
+    auto render = [&](int renderThreadCount) {
+        QSGSoftwarePixmapRenderer renderer(wd->context);
+        renderer.setRenderThreadCount(renderThreadCount);
+        renderer.setDevicePixelRatio(1);
+        renderer.setRootNode(rootNode);
+        rootNode->markDirty(QSGNode::DirtyForceUpdate);
+        renderer.nodeChanged(rootNode, QSGNode::DirtyForceUpdate);
+        renderer.setDeviceRect(window->size());
+        renderer.setViewportRect(window->size());
+        renderer.setProjectionRect(QRect(QPoint(0, 0), window->size()));
+        renderer.setClearColor(Qt::white);
+
+        QImage image(window->size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+        renderer.renderScene();
+        renderer.render(&image);
+        return image;
+    };
+
+    const QImage serial = render(1);
+    const QImage tiled = render(threadCount);
+    QCOMPARE(tiled.size(), serial.size());
+    QCOMPARE(tiled, serial);
+}
+
+void tst_SoftwareRenderer::culledRendering()
+{
+    if (QQuickWindow::sceneGraphBackend() != "software")
+        QSKIP("Skipping complex rendering tests due to not running with software");
+
+    QQuickRenderControl rc;
+    QScopedPointer<QQuickWindow> window(new QQuickWindow(&rc));
+    window->resize(100, 100);
+    window->setColor(Qt::white);
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("culledrendering.qml"));
+    QScopedPointer<QQuickItem> rootItem(qobject_cast<QQuickItem *>(component.create()));
+    QVERIFY2(rootItem, qPrintable(component.errorString()));
+    rootItem->setParentItem(window->contentItem());
+    auto *flickable = rootItem->findChild<QQuickFlickable *>("flickable");
+    QVERIFY(flickable);
+
+    // The same image is used for every frame, so that only the dirty
+    // areas get repainted, like with a real window.
+    QImage windowTarget(window->size(), QImage::Format_ARGB32_Premultiplied);
+    windowTarget.fill(Qt::black);
+    window->setRenderTarget(QQuickRenderTarget::fromPaintDevice(&windowTarget));
+
+    auto renderFrame = [&] {
+        rc.polishItems();
+        rc.beginFrame();
+        rc.sync();
+        rc.render();
+        rc.endFrame();
+    };
+
+    renderFrame();
+    auto *renderer = static_cast<QSGAbstractSoftwareRenderer *>(
+            QQuickWindowPrivate::get(window.data())->renderer);
+    QVERIFY(renderer);
+
+    // The red rectangle is completely behind the header, so it's not drawn.
+    QCOMPARE(renderer->culledNodeCount(), 1);
+    QCOMPARE(windowTarget.pixelColor(50, 25), QColor(Qt::blue));
+    QCOMPARE(windowTarget.pixelColor(50, 75), QColor(Qt::white));
+
+    // Scrolled into view below the header, it's drawn again.
+    flickable->setContentY(-50);
+    renderFrame();
+    QCOMPARE(renderer->culledNodeCount(), 0);
+    QCOMPARE(windowTarget.pixelColor(50, 25), QColor(Qt::blue));
+    QCOMPARE(windowTarget.pixelColor(50, 75), QColor(Qt::red));
+
+    // Scrolled back behind the header, the area it left must be repainted.
+    flickable->setContentY(0);
+    renderFrame();
+    QCOMPARE(renderer->culledNodeCount(), 1);
+    QCOMPARE(windowTarget.pixelColor(50, 25), QColor(Qt::blue));
+    QCOMPARE(windowTarget.pixelColor(50, 75), QColor(Qt::white));
+
+    // Halfway, it's partly visible and must not be culled.
+    flickable->setContentY(-25);
+    renderFrame();
+    QCOMPARE(renderer->culledNodeCount(), 0);
+    QCOMPARE(windowTarget.pixelColor(50, 25), QColor(Qt::blue));
+    QCOMPARE(windowTarget.pixelColor(50, 60), QColor(Qt::red));
+    QCOMPARE(windowTarget.pixelColor(50, 90), QColor(Qt::white));
+}
+
+static int inkPixelCount(const QImage &image, QRgb color)
+{
+    // Antialiased text has differently blended edges when it's painted
+    // through the cache, so only count the pixels that are clearly inked.
+    int count = 0;
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            const QRgb pixel = image.pixel(x, y);
+            if (qAbs(qRed(pixel) - qRed(color)) < 64 && qAbs(qGreen(pixel) - qGreen(color)) < 64
+                    && qAbs(qBlue(pixel) - qBlue(color)) < 64) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+void tst_SoftwareRenderer::glyphImageCache()
+{
+    const qsizetype oldBudget = QSGSoftwareGlyphNode::imageCacheBudget();
+    auto restoreBudget = qScopeGuard([oldBudget] {
+        QSGSoftwareGlyphNode::setImageCacheBudget(oldBudget);
+    });
+    QSGSoftwareGlyphNode::setImageCacheBudget(0);
+    QCOMPARE(QSGSoftwareGlyphNode::imageCacheSize(), 0);
+
+    QTextLayout layout(QStringLiteral("Cached glyph run"));
+    layout.beginLayout();
+    layout.createLine();
+    layout.endLayout();
+    const QList<QGlyphRun> glyphRuns = layout.glyphRuns();
+    QVERIFY(!glyphRuns.isEmpty());
+
+    auto paint = [](QSGSoftwareGlyphNode *node, qreal dx) {
+        QImage image(300, 40, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        QPainter painter(&image);
+        painter.translate(dx, 0);
+        node->paint(&painter);
+        return image;
+    };
+
+    QSGSoftwareGlyphNode first;
+    first.setColor(Qt::black);
+    first.setGlyphs(QPointF(0, 30), glyphRuns.first());
+    QSGSoftwareGlyphNode second;
+    second.setColor(Qt::black);
+    second.setGlyphs(QPointF(0, 30), glyphRuns.first());
+
+    // Without a budget nothing is cached
+    const int expectedInk = inkPixelCount(paint(&first, 0), qRgb(0, 0, 0));
+    QVERIFY(expectedInk > 0);
+    QVERIFY(!first.hasCachedImage());
+    QCOMPARE(QSGSoftwareGlyphNode::imageCacheSize(), 0);
+
+    QSGSoftwareGlyphNode::setImageCacheBudget(1024 * 1024);
+    QVERIFY(inkPixelCount(paint(&first, 0), qRgb(0, 0, 0)) > expectedInk / 2);
+    QVERIFY(first.hasCachedImage());
+    const qsizetype imageSize = QSGSoftwareGlyphNode::imageCacheSize();
+    QVERIFY(imageSize > 0);
+
+    // Moving by whole pixels reuses the image
+    QVERIFY(inkPixelCount(paint(&first, 10), qRgb(0, 0, 0)) > expectedInk / 2);
+    QCOMPARE(QSGSoftwareGlyphNode::imageCacheSize(), imageSize);
+
+    // Changing the node invalidates the image, and the new color is painted
+    first.setColor(Qt::red);
+    QVERIFY(!first.hasCachedImage());
+    QCOMPARE(QSGSoftwareGlyphNode::imageCacheSize(), 0);
+    const QImage red = paint(&first, 0);
+    QVERIFY(inkPixelCount(red, qRgb(255, 0, 0)) > expectedInk / 2);
+    QVERIFY(first.hasCachedImage());
+
+    paint(&second, 0);
+    QVERIFY(second.hasCachedImage());
+    QCOMPARE(QSGSoftwareGlyphNode::imageCacheSize(), 2 * imageSize);
+
+    // Over budget, the least recently painted image is evicted first
+    QSGSoftwareGlyphNode::setImageCacheBudget(imageSize);
+    QVERIFY(!first.hasCachedImage());
+    QVERIFY(second.hasCachedImage());
+    QCOMPARE(QSGSoftwareGlyphNode::imageCacheSize(), imageSize);
+
+    paint(&first, 0);
+    QVERIFY(first.hasCachedImage());
+    QVERIFY(!second.hasCachedImage());
+    QCOMPARE(QSGSoftwareGlyphNode::imageCacheSize(), imageSize);
+
+    // The most recently painted image is kept even if it alone is too large
+    QSGSoftwareGlyphNode::setImageCacheBudget(1);
+    QVERIFY(first.hasCachedImage());
+
+    // Destroying a node releases its image
+    {
+        QSGSoftwareGlyphNode third;
+        third.setColor(Qt::black);
+        third.setGlyphs(QPointF(0, 30), glyphRuns.first());
+        QSGSoftwareGlyphNode::setImageCacheBudget(1024 * 1024);
+        paint(&third, 0);
+        QVERIFY(third.hasCachedImage());
+        QCOMPARE(QSGSoftwareGlyphNode::imageCacheSize(), 2 * imageSize);
+    }
+    QCOMPARE(QSGSoftwareGlyphNode::imageCacheSize(), imageSize);
+
+    // Without a budget, everything is released
+    QSGSoftwareGlyphNode::setImageCacheBudget(0);
+    QVERIFY(!first.hasCachedImage());
+    QCOMPARE(QSGSoftwareGlyphNode::imageCacheSize(), 0);
+}
+
 #include "tst_softwarerenderer.moc"
 
 QTEST_MAIN(tst_SoftwareRenderer)
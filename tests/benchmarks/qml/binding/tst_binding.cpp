@@ -5,8 +5,10 @@
 #include <QQmlEngine>
 #include <QQmlContext>
 #include <QQmlComponent>
+#include <private/qqmlbindingbatch_p.h>
 #include <QFile>
 #include <QDebug>
+#include <memory>
 #include "testtypes.h"
 
 class tst_binding : public QObject
@@ -28,6 +30,8 @@ private slots:
     void basicproperty();
     void creation_data();
     void creation();
+    void diamond_data();
+    void diamond();
 
 private:
     QQmlEngine engine;
@@ -150,5 +154,39 @@ void tst_binding::creation()
     }
 }
 
+void tst_binding::diamond_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<QString>("binding");
+    QTest::addColumn<bool>("batched");
+
+    QTest::newRow("diamond") << SRCDIR "/data/diamond.txt" << "d + e" << false;
+    QTest::newRow("diamond (batched)") << SRCDIR "/data/diamond.txt" << "d + e" << true;
+}
+
+void tst_binding::diamond()
+{
+    QFETCH(QString, file);
+    QFETCH(QString, binding);
+    QFETCH(bool, batched);
+
+    COMPONENT(file, binding);
+
+    std::unique_ptr<QObject> root(c.create());
+    MyQmlObject *object = qobject_cast<MyQmlObject *>(root.get());
+    QVERIFY(object != 0);
+    object->setValue(10);
+
+    int value = 0;
+    QBENCHMARK {
+        if (batched) {
+            QQmlBindingBatch batch(&engine);
+            object->setValue(++value);
+        } else {
+            object->setValue(++value);
+        }
+    }
+}
+
 QTEST_MAIN(tst_binding)
 #include "tst_binding.moc"
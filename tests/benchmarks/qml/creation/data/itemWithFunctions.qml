@@ -0,0 +1,18 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick 2.0
+
+Item {
+    function f1() { return 1 }
+    function f2() { return 2 }
+    function f3() { return 3 }
+    function f4() { return 4 }
+
+    Text {
+        font.pixelSize: 12
+        font.bold: true
+        function g1() { return 1 }
+        function g2() { return 2 }
+    }
+}
@@ -0,0 +1,147 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick 2.0
+
+Item {
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+    Item {
+        function f1() { return 1 }
+        function f2() { return 2 }
+        function f3() { return 3 }
+        function f4() { return 4 }
+        function f5() { return 5 }
+    }
+}
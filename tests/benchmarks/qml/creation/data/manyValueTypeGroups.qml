@@ -0,0 +1,27 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick 2.0
+
+Item {
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+    LookupText { font.bold: true; font.italic: true }
+}
@@ -5,7 +5,9 @@
 #include <QQmlEngine>
 #include <QQmlComponent>
 #include <private/qqmlmetatype_p.h>
+#include <private/qqmlobjectcreator_p.h>
 #include <QDebug>
+#include <QScopeGuard>
 #include <QQuickItem>
 #include <QQmlContext>
 #include <private/qobject_p.h>
@@ -37,6 +39,9 @@ private slots:
     void itemtests_qml_data();
     void itemtests_qml();
 
+    void lookupCache_data();
+    void lookupCache();
+
     void bindings_cpp();
     void bindings_cpp2();
     void bindings_qml();
@@ -286,6 +291,7 @@ void tst_creation::itemtests_qml_data()
     QTest::newRow("itemWithPropertyBindingsTest3") << "itemWithPropertyBindingsTest3.qml";
     QTest::newRow("itemWithPropertyBindingsTest4") << "itemWithPropertyBindingsTest4.qml";
     QTest::newRow("itemWithPropertyBindingsTest5") << "itemWithPropertyBindingsTest5.qml";
+    QTest::newRow("itemWithFunctions") << "itemWithFunctions.qml";
 }
 
 void tst_creation::itemtests_qml()
@@ -304,6 +310,32 @@ void tst_creation::itemtests_qml()
     QBENCHMARK { delete component.create(); }
 }
 
+void tst_creation::lookupCache_data()
+{
+    QTest::addColumn<QString>("filepath");
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("functions, cached") << "manyFunctions.qml" << true;
+    QTest::newRow("functions, uncached") << "manyFunctions.qml" << false;
+    QTest::newRow("value type groups, cached") << "manyValueTypeGroups.qml" << true;
+    QTest::newRow("value type groups, uncached") << "manyValueTypeGroups.qml" << false;
+}
+
+void tst_creation::lookupCache()
+{
+    QFETCH(QString, filepath);
+    QFETCH(bool, cached);
+
+    QQmlComponent component(&engine, TEST_FILE(filepath));
+    QVERIFY2(component.isReady(), qPrintable(component.errorString()));
+
+    QQmlObjectCreator::setLookupCacheEnabled(cached);
+    auto cleanup = qScopeGuard([]() { QQmlObjectCreator::setLookupCacheEnabled(true); });
+
+    delete component.create();
+    QBENCHMARK { delete component.create(); }
+}
+
 void tst_creation::bindings_cpp()
 {
     QQuickItem item;
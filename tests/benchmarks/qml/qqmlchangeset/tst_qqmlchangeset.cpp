@@ -4,6 +4,7 @@
 #include <qtest.h>
 
 #include <QDebug>
+#include <QRandomGenerator>
 
 #include <private/qqmlchangeset_p.h>
 
@@ -13,6 +14,10 @@ class tst_qqmlchangeset : public QObject
 
 private slots:
     void move();
+    void scatteredChanges_data();
+    void scatteredChanges();
+    void applyScatteredChanges();
+    void scatteredInsertsAndRemoves();
 };
 
 void tst_qqmlchangeset::move()
@@ -26,5 +31,72 @@ void tst_qqmlchangeset::move()
     }
 }
 
+// A live data feed updating random rows of a big model within one frame.
+static const int EditsPerFrame = 10000;
+static const int ModelRows = 100000;
+
+void tst_qqmlchangeset::scatteredChanges_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << ModelRows;
+}
+
+void tst_qqmlchangeset::scatteredChanges()
+{
+    QFETCH(int, rows);
+
+    QRandomGenerator generator(42);
+    QList<int> indexes;
+    indexes.reserve(EditsPerFrame);
+    for (int i = 0; i < EditsPerFrame; ++i)
+        indexes.append(generator.bounded(rows));
+
+    QBENCHMARK {
+        QQmlChangeSet set;
+        for (int index : std::as_const(indexes))
+            set.change(index, 1);
+    }
+}
+
+void tst_qqmlchangeset::applyScatteredChanges()
+{
+    QRandomGenerator generator(42);
+    QQmlChangeSet frame;
+    for (int i = 0; i < EditsPerFrame; ++i)
+        frame.change(generator.bounded(ModelRows), 1);
+    QQmlChangeSet pending;
+    for (int i = 0; i < EditsPerFrame; ++i)
+        pending.change(generator.bounded(ModelRows), 1);
+
+    QBENCHMARK {
+        QQmlChangeSet set = pending;
+        set.apply(frame);
+    }
+}
+
+void tst_qqmlchangeset::scatteredInsertsAndRemoves()
+{
+    QRandomGenerator generator(42);
+    QList<std::pair<int, bool>> edits;
+    edits.reserve(EditsPerFrame);
+    int rows = ModelRows;
+    for (int i = 0; i < EditsPerFrame; ++i) {
+        const bool insert = generator.bounded(2);
+        edits.append({ generator.bounded(rows), insert });
+        rows += insert ? 1 : -1;
+    }
+
+    QBENCHMARK {
+        QQmlChangeSet set;
+        for (const auto &edit : std::as_const(edits)) {
+            if (edit.second)
+                set.insert(edit.first, 1);
+            else
+                set.remove(edit.first, 1);
+        }
+    }
+}
+
 QTEST_MAIN(tst_qqmlchangeset)
 #include "tst_qqmlchangeset.moc"
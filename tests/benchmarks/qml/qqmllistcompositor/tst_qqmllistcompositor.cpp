@@ -0,0 +1,114 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+
+#include <QRandomGenerator>
+
+#include <private/qqmllistcompositor_p.h>
+
+typedef QQmlListCompositor C;
+
+// Two additional groups, as a DelegateModel with "selected" and "visible" groups would have.
+static const C::Group Selected = C::Group(3);
+static const C::Group Visible = C::Group(4);
+static const uint SelectedFlag = 1 << Selected;
+static const uint VisibleFlag = 1 << Visible;
+
+static const int TogglesPerIteration = 1000;
+
+class tst_qqmllistcompositor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void toggleGroups_data();
+    void toggleGroups();
+    void randomFind_data();
+    void randomFind();
+
+private:
+    void populate(C *compositor, int items, int *list);
+};
+
+void tst_qqmllistcompositor::populate(C *compositor, int items, int *list)
+{
+    compositor->setGroupCount(5);
+    compositor->append(list, 0, items, C::AppendFlag | C::PrependFlag | C::DefaultFlag | VisibleFlag);
+
+    // Fragment the groups so the compositor holds a range for roughly every other item.
+    QRandomGenerator random(42);
+    for (int i = 0; i < items / 2; ++i) {
+        const int index = random.bounded(items);
+        if (random.bounded(2))
+            compositor->setFlags(C::Default, index, 1, SelectedFlag);
+        else
+            compositor->clearFlags(C::Default, index, 1, VisibleFlag);
+    }
+}
+
+void tst_qqmllistcompositor::toggleGroups_data()
+{
+    QTest::addColumn<int>("items");
+
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+// Selecting and filtering scattered items of a large model.
+void tst_qqmllistcompositor::toggleGroups()
+{
+    QFETCH(int, items);
+
+    int list = 0;
+    C compositor;
+    populate(&compositor, items, &list);
+
+    QRandomGenerator random(7);
+    QVector<C::Insert> inserts;
+    QVector<C::Remove> removes;
+    QBENCHMARK {
+        for (int i = 0; i < TogglesPerIteration; ++i) {
+            const int index = random.bounded(items);
+            const uint flags = random.bounded(2) ? SelectedFlag : VisibleFlag;
+            if (compositor.find(C::Default, index)->flags & flags)
+                compositor.clearFlags(C::Default, index, 1, flags, &removes);
+            else
+                compositor.setFlags(C::Default, index, 1, flags, &inserts);
+            inserts.clear();
+            removes.clear();
+        }
+    }
+}
+
+void tst_qqmllistcompositor::randomFind_data()
+{
+    toggleGroups_data();
+}
+
+// Translating random indexes of a sparse group into indexes in other groups.
+void tst_qqmllistcompositor::randomFind()
+{
+    QFETCH(int, items);
+
+    int list = 0;
+    C compositor;
+    populate(&compositor, items, &list);
+
+    const int selectedCount = compositor.count(Selected);
+    QVERIFY(selectedCount > 0);
+
+    QRandomGenerator random(7);
+    qint64 checksum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < TogglesPerIteration; ++i) {
+            const C::iterator it = compositor.find(Selected, random.bounded(selectedCount));
+            checksum += it.index[C::Default] + it.modelIndex();
+        }
+    }
+    QVERIFY(checksum >= 0);
+}
+
+QTEST_MAIN(tst_qqmllistcompositor)
+
+#include "tst_qqmllistcompositor.moc"
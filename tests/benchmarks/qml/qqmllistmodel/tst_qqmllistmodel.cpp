@@ -0,0 +1,126 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+
+#include <memory>
+#include <vector>
+
+#include <QtCore/qabstractitemmodel.h>
+#include <QtQml/qqmlcomponent.h>
+#include <QtQml/qqmlengine.h>
+#include <QtQmlModels/private/qqmllistmodel_p_p.h>
+
+class tst_qqmllistmodel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void append_data();
+    void append();
+    void data_data();
+    void data();
+    void memory_data();
+    void memory();
+
+private:
+    QAbstractItemModel *createModel(QQmlEngine *engine, int rows);
+};
+
+static const char modelSource[] =
+        "import QtQml.Models\n"
+        "ListModel {\n"
+        "    function fill(count) {\n"
+        "        for (let i = 0; i < count; ++i)\n"
+        "            append({ a: i, b: i + 1, c: i + 2, d: i + 3,\n"
+        "                     e: i * 2, f: i * 3, g: i % 2 == 0, h: i * 0.5 })\n"
+        "    }\n"
+        "}\n";
+
+QAbstractItemModel *tst_qqmllistmodel::createModel(QQmlEngine *engine, int rows)
+{
+    QQmlComponent component(engine);
+    component.setData(modelSource, QUrl());
+    QAbstractItemModel *model = qobject_cast<QAbstractItemModel *>(component.create());
+    if (model && rows > 0)
+        QMetaObject::invokeMethod(model, "fill", Q_ARG(QVariant, rows));
+    return model;
+}
+
+void tst_qqmllistmodel::append_data()
+{
+    QTest::addColumn<int>("rows");
+
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("100000") << 100000;
+}
+
+void tst_qqmllistmodel::append()
+{
+    QFETCH(int, rows);
+
+    QQmlEngine engine;
+    QBENCHMARK {
+        QScopedPointer<QAbstractItemModel> model(createModel(&engine, rows));
+        QVERIFY(model);
+        QCOMPARE(model->rowCount(), rows);
+    }
+}
+
+void tst_qqmllistmodel::data_data()
+{
+    append_data();
+}
+
+void tst_qqmllistmodel::data()
+{
+    QFETCH(int, rows);
+
+    QQmlEngine engine;
+    QScopedPointer<QAbstractItemModel> model(createModel(&engine, rows));
+    QVERIFY(model);
+    QCOMPARE(model->rowCount(), rows);
+
+    const QList<int> roles = model->roleNames().keys();
+    double sum = 0;
+    QBENCHMARK {
+        for (int row = 0; row < rows; ++row) {
+            const QModelIndex index = model->index(row, 0);
+            for (int role : roles)
+                sum += model->data(index, role).toDouble();
+        }
+    }
+    QVERIFY(sum > 0);
+}
+
+void tst_qqmllistmodel::memory_data()
+{
+    QTest::addColumn<int>("models");
+    QTest::addColumn<int>("rows");
+
+    QTest::newRow("1000 models, 1 row") << 1000 << 1;
+    QTest::newRow("1000 models, 10 rows") << 1000 << 10;
+    QTest::newRow("100 models, 100 rows") << 100 << 100;
+    QTest::newRow("1 model, 100000 rows") << 1 << 100000;
+}
+
+void tst_qqmllistmodel::memory()
+{
+    QFETCH(int, models);
+    QFETCH(int, rows);
+
+    // Reports the size of the element slabs per model, in bytes
+    QQmlEngine engine;
+    std::vector<std::unique_ptr<QAbstractItemModel>> created;
+    const qsizetype before = ListElementPool::allocatedBytes();
+    for (int i = 0; i < models; ++i) {
+        created.emplace_back(createModel(&engine, rows));
+        QVERIFY(created.back());
+    }
+    const qsizetype allocated = ListElementPool::allocatedBytes() - before;
+    QVERIFY(allocated > 0);
+    QTest::setBenchmarkResult(qreal(allocated) / models, QTest::BytesAllocated);
+}
+
+QTEST_MAIN(tst_qqmllistmodel)
+#include "tst_qqmllistmodel.moc"
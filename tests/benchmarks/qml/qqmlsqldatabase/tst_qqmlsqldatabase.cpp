@@ -0,0 +1,78 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <qtest.h>
+
+#include <QtCore/qtemporarydir.h>
+#include <QtQml/qqmlcomponent.h>
+#include <QtQml/qqmlengine.h>
+
+class tst_qqmlsqldatabase : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void insert_data();
+    void insert();
+
+private:
+    QTemporaryDir m_storage;
+};
+
+static const char source[] =
+        "import QtQml\n"
+        "import QtQuick.LocalStorage\n"
+        "QtObject {\n"
+        "    property var db: LocalStorage.openDatabaseSync('bench', '', 'benchmark', 1000000)\n"
+        "    Component.onCompleted: db.transaction(tx =>\n"
+        "        tx.executeSql('CREATE TABLE IF NOT EXISTS Log(n INTEGER, txt TEXT)'))\n"
+        "    function run(rows, batch) {\n"
+        "        db.transaction(tx => {\n"
+        "            tx.executeSql('DELETE FROM Log')\n"
+        "            if (batch) {\n"
+        "                let values = []\n"
+        "                for (let i = 0; i < rows; ++i)\n"
+        "                    values.push([i, 'message ' + i])\n"
+        "                tx.executeBatch('INSERT INTO Log VALUES(?, ?)', values)\n"
+        "            } else {\n"
+        "                for (let i = 0; i < rows; ++i)\n"
+        "                    tx.executeSql('INSERT INTO Log VALUES(?, ?)', [i, 'message ' + i])\n"
+        "            }\n"
+        "        })\n"
+        "    }\n"
+        "}\n";
+
+void tst_qqmlsqldatabase::initTestCase()
+{
+    QVERIFY(m_storage.isValid());
+}
+
+void tst_qqmlsqldatabase::insert_data()
+{
+    QTest::addColumn<int>("rows");
+    QTest::addColumn<bool>("batch");
+
+    QTest::newRow("executeSql, 10000 rows") << 10000 << false;
+    QTest::newRow("executeBatch, 10000 rows") << 10000 << true;
+}
+
+void tst_qqmlsqldatabase::insert()
+{
+    QFETCH(int, rows);
+    QFETCH(bool, batch);
+
+    QQmlEngine engine;
+    engine.setOfflineStoragePath(m_storage.path());
+    QQmlComponent component(&engine);
+    component.setData(source, QUrl());
+    QScopedPointer<QObject> object(component.create());
+    QVERIFY2(object, qPrintable(component.errorString()));
+
+    QBENCHMARK {
+        QMetaObject::invokeMethod(object.data(), "run", Q_ARG(QVariant, rows), Q_ARG(QVariant, batch));
+    }
+}
+
+QTEST_MAIN(tst_qqmlsqldatabase)
+#include "tst_qqmlsqldatabase.moc"
@@ -0,0 +1,36 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+import QtQuick
+
+// Many static text items on top of a background that changes every frame,
+// so that all of the text has to be repainted.
+Item {
+    width: 800
+    height: 600
+
+    property int frame: 0
+
+    Rectangle {
+        anchors.fill: parent
+        color: frame % 2 ? "white" : "ivory"
+    }
+
+    Grid {
+        anchors.fill: parent
+        anchors.margins: 4
+        columns: 4
+        spacing: 4
+
+        Repeater {
+            model: 120
+            Text {
+                width: 192
+                text: "Item " + index + ": the quick brown fox"
+                font.pixelSize: 13
+                style: index % 3 === 0 ? Text.Outline : Text.Normal
+                styleColor: "lightsteelblue"
+            }
+        }
+    }
+}
@@ -0,0 +1,95 @@
+// Copyright (C) 2023 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QtTest/QtTest>
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickRenderControl>
+#include <QtQuick/QQuickRenderTarget>
+#include <QtQuick/QQuickWindow>
+#include <QtQml/QQmlComponent>
+#include <QtQml/QQmlEngine>
+
+#include <private/qsgsoftwareglyphnode_p.h>
+
+#include <QtQuickTestUtils/private/qmlutils_p.h>
+
+class tst_SoftwareText : public QQmlDataTest
+{
+    Q_OBJECT
+
+public:
+    tst_SoftwareText();
+
+private slots:
+    void initTestCase() override;
+
+    void textFrame_data();
+    void textFrame();
+};
+
+tst_SoftwareText::tst_SoftwareText()
+    : QQmlDataTest(QT_QMLTEST_DATADIR)
+{
+}
+
+void tst_SoftwareText::initTestCase()
+{
+    QQmlDataTest::initTestCase();
+    QQuickWindow::setGraphicsApi(QSGRendererInterface::Software);
+}
+
+void tst_SoftwareText::textFrame_data()
+{
+    QTest::addColumn<qsizetype>("cacheBudget");
+
+    QTest::newRow("uncached") << qsizetype(0);
+    QTest::newRow("cached") << qsizetype(16 * 1024 * 1024);
+}
+
+void tst_SoftwareText::textFrame()
+{
+    if (QQuickWindow::sceneGraphBackend() != "software")
+        QSKIP("Benchmarks the glyph nodes of the software backend");
+
+    QFETCH(qsizetype, cacheBudget);
+
+    const qsizetype oldBudget = QSGSoftwareGlyphNode::imageCacheBudget();
+    QSGSoftwareGlyphNode::setImageCacheBudget(cacheBudget);
+    auto restoreBudget = qScopeGuard([oldBudget] {
+        QSGSoftwareGlyphNode::setImageCacheBudget(oldBudget);
+    });
+
+    QQuickRenderControl rc;
+    QScopedPointer<QQuickWindow> window(new QQuickWindow(&rc));
+    window->resize(800, 600);
+
+    QQmlEngine engine;
+    QQmlComponent component(&engine, testFileUrl("textgrid.qml"));
+    QScopedPointer<QQuickItem> rootItem(qobject_cast<QQuickItem *>(component.create()));
+    QVERIFY2(rootItem, qPrintable(component.errorString()));
+    rootItem->setParentItem(window->contentItem());
+
+    QImage target(window->size(), QImage::Format_ARGB32_Premultiplied);
+    window->setRenderTarget(QQuickRenderTarget::fromPaintDevice(&target));
+
+    int frame = 0;
+    auto renderFrame = [&] {
+        rootItem->setProperty("frame", ++frame);
+        rc.polishItems();
+        rc.beginFrame();
+        rc.sync();
+        rc.render();
+        rc.endFrame();
+    };
+
+    // Let the first frame populate the cache
+    renderFrame();
+
+    QBENCHMARK {
+        renderFrame();
+    }
+}
+
+QTEST_MAIN(tst_SoftwareText)
+
+#include "tst_softwaretext.moc"
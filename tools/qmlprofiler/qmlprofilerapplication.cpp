@@ -59,6 +59,7 @@ QmlProfilerApplication::QmlProfilerApplication(int &argc, char **argv) :
     m_verbose(false),
     m_recording(true),
     m_interactive(false),
+    m_hotBindings(0),
     m_connectionAttempts(0)
 {
     m_connection.reset(new QQmlDebugConnection);
@@ -167,6 +168,13 @@ void QmlProfilerApplication::parseArguments()
                                       "does so in this case.") + QChar::Space + tr(commandTextC));
     parser.addOption(interactive);
 
+    QCommandLineOption hotBindings(QLatin1String("hot-bindings"),
+                                   tr("Print the <count> bindings with the highest cumulative "
+                                      "evaluation time to the standard error output whenever "
+                                      "data is written."),
+                                   QLatin1String("count"));
+    parser.addOption(hotBindings);
+
     QCommandLineOption verbose(QStringList() << QLatin1String("verbose"),
                                tr("Print debugging output."));
     parser.addOption(verbose);
@@ -227,6 +235,16 @@ void QmlProfilerApplication::parseArguments()
     if (parser.isSet(verbose))
         m_verbose = true;
 
+    if (parser.isSet(hotBindings)) {
+        bool isNumber;
+        m_hotBindings = parser.value(hotBindings).toInt(&isNumber);
+        if (!isNumber || m_hotBindings < 0) {
+            logError(tr("'%1' is not a valid number of bindings.")
+                     .arg(parser.value(hotBindings)));
+            parser.showHelp(1);
+        }
+    }
+
     m_arguments = parser.positionalArguments();
     if (!m_arguments.isEmpty())
         m_executablePath = m_arguments.takeFirst();
@@ -280,6 +298,7 @@ void QmlProfilerApplication::flush()
         m_pendingRequest = REQUEST_FLUSH;
         m_qmlProfilerClient->setRecording(false);
     } else {
+        printHotBindings();
         if (m_profilerData->save(m_interactiveOutputFile)) {
             m_profilerData->clear();
             if (!m_interactiveOutputFile.isEmpty())
@@ -296,6 +315,7 @@ void QmlProfilerApplication::flush()
 
 void QmlProfilerApplication::output()
 {
+    printHotBindings();
     if (m_profilerData->save(m_interactiveOutputFile)) {
         if (!m_interactiveOutputFile.isEmpty())
             prompt(tr("Data written to %1.").arg(m_interactiveOutputFile));
@@ -427,6 +447,7 @@ void QmlProfilerApplication::notifyTraceStarted()
 void QmlProfilerApplication::outputData()
 {
     if (!m_profilerData->isEmpty()) {
+        printHotBindings();
         m_profilerData->save(m_outputFile);
         m_profilerData->clear();
     }
@@ -584,6 +605,21 @@ void QmlProfilerApplication::logWarning(const QString &warning)
     std::cerr << "Warning: " << qPrintable(warning) << std::endl;
 }
 
+void QmlProfilerApplication::printHotBindings()
+{
+    if (m_hotBindings <= 0)
+        return;
+
+    const QStringList lines = m_profilerData->hotBindings(m_hotBindings);
+    if (lines.isEmpty())
+        return;
+
+    std::cerr << qPrintable(tr("Bindings with the highest cumulative evaluation time:"))
+              << std::endl;
+    for (const QString &line : lines)
+        std::cerr << qPrintable(line) << std::endl;
+}
+
 void QmlProfilerApplication::logStatus(const QString &status)
 {
     if (!m_verbose)
@@ -60,6 +60,7 @@ private:
     bool checkOutputFile(PendingRequest pending);
     void flush();
     void output();
+    void printHotBindings();
 
     enum ApplicationMode {
         LaunchMode,
@@ -81,6 +82,7 @@ private:
     bool m_verbose;
     bool m_recording;
     bool m_interactive;
+    int m_hotBindings;
 
     QScopedPointer<QQmlDebugConnection> m_connection;
     QScopedPointer<QmlProfilerClient> m_qmlProfilerClient;
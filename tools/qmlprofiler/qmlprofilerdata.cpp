@@ -296,6 +296,57 @@ bool QmlProfilerData::isEmpty() const
     return d->events.isEmpty();
 }
 
+QStringList QmlProfilerData::hotBindings(int count) const
+{
+    struct BindingTime {
+        int typeIndex = -1;
+        qint64 evaluations = 0;
+        qint64 totalTime = 0;
+        qint64 maximumTime = 0;
+    };
+
+    QHash<int, BindingTime> bindings;
+    QStack<const QQmlProfilerEvent *> ranges;
+
+    for (const QQmlProfilerEvent &event : std::as_const(d->events)) {
+        const QQmlProfilerEventType &type = d->eventTypes.at(event.typeIndex());
+        if (type.message() != MaximumMessage || type.rangeType() == MaximumRangeType)
+            continue;
+
+        if (event.rangeStage() == RangeStart) {
+            ranges.push(&event);
+        } else if (event.rangeStage() == RangeEnd && !ranges.isEmpty()) {
+            const QQmlProfilerEvent *start = ranges.pop();
+            if (type.rangeType() != Binding)
+                continue;
+
+            const qint64 duration = event.timestamp() - start->timestamp();
+            BindingTime &binding = bindings[start->typeIndex()];
+            binding.typeIndex = start->typeIndex();
+            ++binding.evaluations;
+            binding.totalTime += duration;
+            binding.maximumTime = std::max(binding.maximumTime, duration);
+        }
+    }
+
+    QList<BindingTime> sorted = bindings.values();
+    std::sort(sorted.begin(), sorted.end(), [](const BindingTime &a, const BindingTime &b) {
+        return a.totalTime > b.totalTime;
+    });
+
+    QStringList lines;
+    for (int i = 0, end = std::min(count, int(sorted.size())); i < end; ++i) {
+        const BindingTime &binding = sorted.at(i);
+        const QQmlProfilerEventType &type = d->eventTypes.at(binding.typeIndex);
+        lines.append(QString::fromLatin1("%1 evaluations, %2 us total, %3 us max: %4 %5")
+                     .arg(binding.evaluations)
+                     .arg(binding.totalTime / 1000)
+                     .arg(binding.maximumTime / 1000)
+                     .arg(type.displayName(), type.data()));
+    }
+    return lines;
+}
+
 struct StreamWriter {
     QString error;
 
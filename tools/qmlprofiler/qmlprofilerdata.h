@@ -9,6 +9,7 @@
 #include <private/qqmlprofilereventreceiver_p.h>
 
 #include <QObject>
+#include <QStringList>
 
 class QmlProfilerDataPrivate;
 class QmlProfilerData : public QQmlProfilerEventReceiver
@@ -44,6 +45,7 @@ public:
 
     void complete();
     bool save(const QString &filename);
+    QStringList hotBindings(int count) const;
 
 Q_SIGNALS:
     void error(QString);